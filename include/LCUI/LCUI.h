@@ -199,6 +199,18 @@ struct LCUI_Graph_ {
 	uchar_t *palette;		/**< 调色板 */
 };
 
+/**
+ * 图形内存池，用于分配一帧内的临时图形的像素数据
+ * 分配时只移动偏移量，在每一帧开始时整体复位，不逐个释放
+ */
+typedef struct LCUI_GraphArenaRec_ {
+	uchar_t *bytes;			/**< 内存块 */
+	size_t size;			/**< 内存块大小 */
+	size_t used;			/**< 已使用的大小 */
+	size_t peak;			/**< 本帧的最大用量，用于复位时调整内存块大小 */
+	struct LCUI_GraphArenaBlockRec_ *blocks;	/**< 内存块不足时额外申请的内存 */
+} LCUI_GraphArenaRec, *LCUI_GraphArena;
+
 /** 样式值枚举，用于代替使用字符串 */
 typedef enum LCUI_StyleValue {
 	SV_NONE,
@@ -235,7 +247,8 @@ typedef enum LCUI_StyleValue {
 	SV_FLOAT_RIGHT,
 	SV_BLOCK,
 	SV_INLINE_BLOCK,
-	SV_NOWRAP
+	SV_NOWRAP,
+	SV_OPACITY
 } LCUI_StyleValue;
 
 typedef struct LCUI_StyleRec_ {
@@ -310,6 +323,8 @@ typedef struct LCUI_PaintContextRec_ {
 	LCUI_Rect rect;			/**< 需要绘制的区域 */
 	LCUI_Graph canvas;		/**< 绘制后的位图缓存（可称为：画布） */
 	LCUI_BOOL with_alpha;		/**< 绘制时是否需要处理 alpha 通道 */
+	LCUI_GraphArena arena;		/**< 临时图形的内存池，为 NULL 时使用堆内存 */
+	struct LCUI_RegionRec_ *region;	/**< 实际绘制的区域，为 NULL 时为整个 rect */
 } LCUI_PaintContextRec, *LCUI_PaintContext;
 
 typedef void (*FuncPtr)(void *);
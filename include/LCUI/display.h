@@ -80,6 +80,7 @@ typedef struct LCUI_DisplayEventRec_ {
 /** surface 的操作方法集 */
 typedef struct LCUI_DisplayDriverRec_ {
 	char			name[256];
+	LCUI_BOOL		can_present_async;	/**< 能否在其它线程中直接呈现 */
 	int			(*getWidth)(void);
 	int			(*getHeight)(void);
 	LCUI_Surface		(*create)(void);
@@ -110,12 +111,40 @@ LCUI_API int LCUIDisplay_GetMode( void );
 /** 更新各种图形元素 */
 LCUI_API void LCUIDisplay_Update( void );
 
+/** 检查是否有需要更新的部件或需要重绘的区域 */
+LCUI_API LCUI_BOOL LCUIDisplay_NeedUpdate( void );
+
 /** 渲染内容 */
 LCUI_API void LCUIDisplay_Render( void );
 
 /** 呈现渲染后的内容 */
 LCUI_API void LCUIDisplay_Present( void );
 
+/**
+ * 设置参与渲染的线程数量
+ * 数量大于 1 时，需要重绘的区域会被分成多个图块，交给多个线程并行渲染，
+ * 部件原型的 paint 函数需要满足 LCUI_WidgetPainter 的线程安全要求
+ * @param[in] n 线程数量，包括主线程，默认为 1
+ */
+LCUI_API void LCUIDisplay_SetRenderThreads( int n );
+
+/** 获取参与渲染的线程数量 */
+LCUI_API int LCUIDisplay_GetRenderThreads( void );
+
+/**
+ * 设置是否启用流水线模式
+ * 启用后，主线程将画面渲染到双缓冲中的后台缓冲，提交后由显示线程复制到
+ * surface 并呈现，主线程不必等待呈现完成就能开始处理下一帧。
+ * 只有能在显示线程中直接完成呈现的驱动（fbdev、headless）才能从中获益，
+ * 其它驱动（x11、windows）的呈现仍需交给主线程完成，因此不会启用流水线模式，
+ * 以免每帧多出两次缓冲复制。
+ * @param[in] enabled 是否启用，默认不启用
+ */
+LCUI_API void LCUIDisplay_SetPipelined( LCUI_BOOL enabled );
+
+/** 判断流水线模式是否已生效 */
+LCUI_API LCUI_BOOL LCUIDisplay_IsPipelined( void );
+
 LCUI_API void LCUIDisplay_ShowRectBorder( void );
 
 LCUI_API void LCUIDisplay_HideRectBorder( void );
@@ -132,6 +161,17 @@ LCUI_API int LCUIDisplay_GetHeight( void );
 /** 添加无效区域 */
 LCUI_API void LCUIDisplay_InvalidateArea( LCUI_Rect *rect );
 
+/**
+ * 平移屏幕上一块区域内已绘制的内容
+ * 内容会在下次渲染时直接在帧缓存中移动，只有新露出的区域需要重绘，适用于滚动
+ * 等整块内容只改变位置的场合。仅在窗口模式和全屏模式下可用
+ * @param[in] rect 需要平移的区域，相对于根部件
+ * @param[in] dx 水平方向的移动距离
+ * @param[in] dy 垂直方向的移动距离
+ * @returns 成功返回 0，失败返回负数，此时应改为标记无效区域
+ */
+LCUI_API int LCUIDisplay_ScrollArea( LCUI_Rect *rect, int dx, int dy );
+
 /** 获取当前部件所属的 surface */
 LCUI_API LCUI_Surface LCUIDisplay_GetSurfaceOwner( LCUI_Widget w );
 
@@ -142,7 +182,28 @@ LCUI_Surface LCUIDisplay_GetSurfaceByHandle( void *handle );
 LCUI_API int LCUIDisplay_BindEvent( int event_id, LCUI_EventFunc func, void *arg,
 				    void *data, void( *destroy_data )(void*) );
 
-/** 初始化图形输出模块 */
+/**
+ * 创建无界面的显示驱动
+ * surface 的内容只保存在内存中，surface 的句柄就是它的帧缓存（LCUI_Graph*）。
+ * 创建时会启用虚拟时钟，如果设置了环境变量 LCUI_HEADLESS_DUMP，则每帧的内容
+ * 都会以 PNG 文件的形式保存到该变量所指定的目录中
+ */
+LCUI_API LCUI_DisplayDriver LCUI_CreateHeadlessDisplay( void );
+
+/** 销毁无界面的显示驱动，并停用虚拟时钟 */
+LCUI_API void LCUI_DestroyHeadlessDisplay( LCUI_DisplayDriver driver );
+
+/** 设置无界面显示驱动的帧转储目录，为 NULL 时不转储 */
+LCUI_API int LCUIHeadless_SetDumpPath( const char *path );
+
+/** 获取无界面显示驱动已呈现的帧数 */
+LCUI_API unsigned int LCUIHeadless_GetFrameCount( void );
+
+/**
+ * 初始化图形输出模块
+ * @param[in] driver 显示驱动，为 NULL 时使用当前平台的驱动，如果环境变量
+ *  LCUI_DISPLAY 的值为 headless，则使用无界面的显示驱动
+ */
 LCUI_API int LCUI_InitDisplay( LCUI_DisplayDriver driver );
 
 /** 停用图形输出模块 */
@@ -0,0 +1,136 @@
+/* ***************************************************************************
+ * framestats.h -- frame timing statistics of the main loop.
+ *
+ * Copyright (C) 2017 by Liu Chao <lc-soft@live.cn>
+ *
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ *
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ *
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *
+ * The LCUI project is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ *
+ * You should have received a copy of the GPLv2 along with this file. It is
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+/* ****************************************************************************
+ * framestats.h -- 主循环的帧耗时统计
+ *
+ * 版权所有 (C) 2017 归属于 刘超 <lc-soft@live.cn>
+ *
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ *
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ *
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+#ifndef LCUI_FRAMESTATS_H
+#define LCUI_FRAMESTATS_H
+
+#include <LCUI/surface.h>
+
+LCUI_BEGIN_HEADER
+
+/** 最近帧记录的保留数量 */
+#define LCUI_FRAME_STATS_SIZE	256
+
+/** 每帧最多分别记录的 surface 数量，超出的部分只计入总数 */
+#define LCUI_FRAME_STATS_SURFACES	4
+
+/** 帧的处理阶段 */
+typedef enum LCUI_FramePhase {
+	LCUI_FPHASE_TASKS,	/**< 处理定时器和任务 */
+	LCUI_FPHASE_EVENTS,	/**< 分发驱动的事件 */
+	LCUI_FPHASE_UPDATE,	/**< 更新部件 */
+	LCUI_FPHASE_RENDER,	/**< 渲染 */
+	LCUI_FPHASE_PRESENT,	/**< 呈现 */
+	LCUI_FPHASE_SLEEP,	/**< 等待下一帧或新的工作 */
+	LCUI_FPHASE_TOTAL_NUM
+} LCUI_FramePhase;
+
+/** 一个 surface 在一帧中的渲染记录 */
+typedef struct LCUI_SurfaceRenderRecordRec_ {
+	LCUI_Surface surface;			/**< 渲染的 surface */
+	int rects;				/**< 渲染过的脏矩形数量 */
+	int64_t pixels;				/**< 绘制的像素数量 */
+	int64_t duration;			/**< 渲染耗时，从阶段开始或上一个 surface 渲染完时算起 */
+} LCUI_SurfaceRenderRecordRec, *LCUI_SurfaceRenderRecord;
+
+/** 一帧的记录，时间单位为微秒 */
+typedef struct LCUI_FrameRecordRec_ {
+	unsigned long id;			/**< 帧序号 */
+	int64_t start_time;			/**< 开始时间 */
+	int64_t duration;			/**< 总耗时 */
+	int64_t phases[LCUI_FPHASE_TOTAL_NUM];	/**< 各阶段的耗时 */
+	int surfaces;				/**< 渲染过的 surface 数量 */
+	int rects;				/**< 渲染过的脏矩形数量 */
+	int64_t pixels;				/**< 绘制的像素数量 */
+	LCUI_SurfaceRenderRecordRec renders[LCUI_FRAME_STATS_SURFACES];	/**< 前几个 surface 各自的渲染记录 */
+} LCUI_FrameRecordRec, *LCUI_FrameRecord;
+
+/** 耗时的百分位数，由直方图估算，相对误差不超过 1/8 */
+typedef struct LCUI_FramePercentilesRec_ {
+	int64_t p50;
+	int64_t p95;
+	int64_t p99;
+	int64_t max;
+} LCUI_FramePercentilesRec, *LCUI_FramePercentiles;
+
+/** 帧耗时统计 */
+typedef struct LCUI_FrameStatsRec_ {
+	unsigned long total_frames;		/**< 开始统计以来的帧数 */
+	size_t length;				/**< frames 中的有效记录数 */
+	LCUI_FrameRecordRec frames[LCUI_FRAME_STATS_SIZE];	/**< 最近的帧，按时间先后排列 */
+	LCUI_FramePercentilesRec frame;		/**< 帧总耗时的百分位数 */
+	LCUI_FramePercentilesRec phases[LCUI_FPHASE_TOTAL_NUM];	/**< 各阶段耗时的百分位数 */
+} LCUI_FrameStatsRec, *LCUI_FrameStats;
+
+/**
+ * 启用或禁用帧耗时统计
+ * 禁用时各个探针只检查一个标志，几乎没有开销。重新启用时会清空之前的统计
+ */
+LCUI_API void LCUIFrameStats_Enable( LCUI_BOOL enabled );
+
+/** 判断是否启用了帧耗时统计 */
+LCUI_API LCUI_BOOL LCUIFrameStats_IsEnabled( void );
+
+/** 清空统计数据 */
+LCUI_API void LCUIFrameStats_Reset( void );
+
+/**
+ * 获取帧耗时统计
+ * 可以在任意线程中调用，百分位数统计的是从启用或清空以来的所有帧
+ * @param[out] stats 用于保存统计结果
+ * @return 正常返回 0，未启用统计时返回 -1
+ */
+LCUI_API int LCUI_GetFrameStats( LCUI_FrameStats stats );
+
+/** 标记新的一帧的开始 */
+LCUI_API void LCUIFrameStats_BeginFrame( void );
+
+/** 标记一个阶段的结束，自上一个标记以来的耗时将计入该阶段 */
+LCUI_API void LCUIFrameStats_EndPhase( LCUI_FramePhase phase );
+
+/** 记录一次 surface 渲染，region 为渲染过的脏矩形区域 */
+LCUI_API void LCUIFrameStats_AddRender( LCUI_Surface surface,
+					LCUI_Region region );
+
+/** 标记当前帧的结束，并保存它的记录 */
+LCUI_API void LCUIFrameStats_EndFrame( void );
+
+LCUI_END_HEADER
+
+#endif
@@ -55,11 +55,17 @@ enum GraphColorType {
 	COLOR_TYPE_RGB555,	/**< RGB555 */
 	COLOR_TYPE_RGB565,	/**< RGB565 */
 	COLOR_TYPE_RGB888,	/**< RGB888 */
-	COLOR_TYPE_ARGB8888	/**< RGB8888 */
+	COLOR_TYPE_ARGB8888,	/**< RGB8888 */
+	COLOR_TYPE_PARGB8888	/**< 预乘 alpha 的 ARGB8888 */
 };
 
 #define COLOR_TYPE_RGB COLOR_TYPE_RGB888
 #define COLOR_TYPE_ARGB COLOR_TYPE_ARGB8888
+#define COLOR_TYPE_PARGB COLOR_TYPE_PARGB8888
+
+/** 判断色彩类型是否为 32 位的 ARGB 像素格式（包括预乘 alpha 的格式） */
+#define ColorType_IsARGB(T) \
+	((T) == COLOR_TYPE_ARGB8888 || (T) == COLOR_TYPE_PARGB8888)
 
 /* 将两个像素点的颜色值进行alpha混合 */
 #define _ALPHA_BLEND(__back__ , __fore__, __alpha__)	\
@@ -76,6 +82,13 @@ enum GraphColorType {
 	ALPHA_BLEND( (px1)->b, (px2)->b, a );	\
 }
 
+/* 将像素的颜色值与 alpha 值预乘 */
+#define PIXEL_PREMULTIPLY(px) {					\
+	(px)->r = (uchar_t)(((px)->r * (px)->a + 127) / 255);	\
+	(px)->g = (uchar_t)(((px)->g * (px)->a + 127) / 255);	\
+	(px)->b = (uchar_t)(((px)->b * (px)->a + 127) / 255);	\
+}
+
 /* 获取像素的RGB值 */
 #define RGB_FROM_RGB565(pixel, r, g, b)	\
 {\
@@ -119,6 +132,10 @@ enum GraphColorType {
 #define Graph_SetPixel(G, X, Y, C) 						\
 	if( (G)->color_type == COLOR_TYPE_ARGB ) {				\
 		(G)->argb[(G)->width*(Y)+(X)] = (C);			\
+	} else if( (G)->color_type == COLOR_TYPE_PARGB ) {			\
+		LCUI_ARGB *_px = &(G)->argb[(G)->width*(Y)+(X)];		\
+		*_px = (C);							\
+		PIXEL_PREMULTIPLY( _px );					\
 	} else {								\
 		(G)->bytes[(G)->bytes_per_row*(Y)+(X)*3] = (C).value>>8;	\
 	}
@@ -151,6 +168,42 @@ LCUI_API void Graph_Copy( LCUI_Graph *des, const LCUI_Graph *src );
 
 LCUI_API void Graph_Free( LCUI_Graph *graph );
 
+/**
+ * 平移图像中的像素
+ * 像素在图像（或引用区域）内部按行移动，源区域和目标区域可以重叠，移出的部分
+ * 被丢弃，空出的部分保留原有内容
+ * @param[in] dx 水平方向的偏移量
+ * @param[in] dy 垂直方向的偏移量
+ */
+LCUI_API int Graph_Scroll( LCUI_Graph *graph, int dx, int dy );
+
+/** 初始化图形内存池 */
+LCUI_API void GraphArena_Init( LCUI_GraphArena arena );
+
+/**
+ * 复位图形内存池，之前从中分配的图形都将失效
+ * 如果上一帧的用量超出了内存块大小，则会按最大用量重新分配内存块，以使后面的
+ * 帧在分配时不再需要申请堆内存
+ */
+LCUI_API void GraphArena_Reset( LCUI_GraphArena arena );
+
+/** 销毁图形内存池，释放其占用的内存 */
+LCUI_API void GraphArena_Destroy( LCUI_GraphArena arena );
+
+/** 获取内存池的当前偏移量，用于之后回退到该位置 */
+LCUI_API size_t GraphArena_GetOffset( LCUI_GraphArena arena );
+
+/** 将内存池回退到指定偏移量，在此之后分配的图形都将失效 */
+LCUI_API void GraphArena_Rewind( LCUI_GraphArena arena, size_t offset );
+
+/**
+ * 从内存池中为图形分配像素数据，分配到的内存已清零
+ * 图形不能用 Graph_Free() 释放，它会在内存池回退或复位后失效
+ * @param[in] arena 内存池，若为 NULL 则改用 Graph_Create() 分配堆内存
+ */
+LCUI_API int GraphArena_CreateGraph( LCUI_GraphArena arena,
+				     LCUI_Graph *graph, int w, int h );
+
 /**
  * 为图像创建一个引用
  * @param self 用于存放图像引用的缓存区
@@ -162,8 +215,8 @@ LCUI_API int Graph_Quote( LCUI_Graph *self, LCUI_Graph *source, const LCUI_Rect
 /** 判断图像是否有Alpha透明通道 */
 #define Graph_HasAlpha(G) 						\
 	((G)->quote.is_valid ? (					\
-		(G)->quote.source->color_type == COLOR_TYPE_ARGB	\
-	) : ((G)->color_type == COLOR_TYPE_ARGB))
+		ColorType_IsARGB( (G)->quote.source->color_type )	\
+	) : ColorType_IsARGB( (G)->color_type ))
 
 /** 判断图像是否有效 */
 #define Graph_IsValid(G)							\
@@ -220,6 +273,9 @@ LCUI_API int Graph_Mix( LCUI_Graph *back, const LCUI_Graph *fore,
 
 LCUI_API int Graph_Replace( LCUI_Graph *back, const LCUI_Graph *fore, int left, int top );
 
+/** 初始化图形处理模块，根据 CPU 支持的指令集选择合适的像素混合函数 */
+LCUI_API void LCUI_InitGraph( void );
+
 LCUI_END_HEADER
 
 #include <LCUI/draw.h>
@@ -62,6 +62,7 @@ enum LCUI_StyleKeyName {
 
 	key_z_index,
 	key_opacity,
+	key_will_change,
 	key_box_sizing,
 	key_width,
 	key_min_width,
@@ -160,6 +161,7 @@ typedef struct LCUI_SelectorNodeRec_ {
 	char **classes;			/**< 样式类列表 */
 	char **status;			/**< 状态列表 */
 	char *fullname;			/**< 全名，由 id、type、classes、status 组合而成 */
+	LCUI_Atom atom;			/**< 全名对应的原子 */
 	int rank;			/**< 权值 */
 } LCUI_SelectorNodeRec, *LCUI_SelectorNode;
 
@@ -172,6 +174,17 @@ typedef struct LCUI_SelectorRec_ {
 	LCUI_SelectorNode *nodes;	/**< 选择器结点列表 */
 } LCUI_SelectorRec, *LCUI_Selector;
 
+#define SELECTOR_FILTER_BITS	12
+#define SELECTOR_FILTER_SIZE	(1 << SELECTOR_FILTER_BITS)
+
+/**
+ * 选择器过滤器
+ * 以计数型布隆过滤器记录祖先部件的 id、类型、类和状态，用于在匹配后代选择器时
+ * 快速排除祖先中一定不存在的规则。只会误判为存在，不会误判为不存在。
+ */
+typedef struct LCUI_SelectorFilterRec_ {
+	unsigned char counts[SELECTOR_FILTER_SIZE];
+} LCUI_SelectorFilterRec, *LCUI_SelectorFilter;
 
 #define CheckStyleType(S, K, T) (S[K].is_valid && S[K].type == SVT_##T)
 #define CheckStyleValue(S, K, V) (S[K].is_valid && S[K].type == SV_##V)
@@ -200,6 +213,9 @@ LCUI_API LCUI_Selector Selector( const char *selector );
 
 LCUI_API void Selector_Update( LCUI_Selector s );
 
+/** 根据各个选择器结点全名的原子计算选择器的哈希值，结果与 Selector_Update() 一致 */
+LCUI_API unsigned int Selector_GetHash( const LCUI_Atom *atoms, int length );
+
 LCUI_API void Selector_Delete( LCUI_Selector s );
 
 LCUI_API int SelectorNode_GetNames( LCUI_SelectorNode sn, LinkedList *names );
@@ -215,9 +231,59 @@ LCUI_API void SelectorNode_Delete( LCUI_SelectorNode node );
 LCUI_API LCUI_BOOL SelectorNode_Match( LCUI_SelectorNode sn1,
 				       LCUI_SelectorNode sn2 );
 
+/**
+ * 获取选择器结点在过滤器中的键
+ * @param[in] sn 选择器结点
+ * @param[out] keys 键列表，使用完后需要用 free() 释放
+ * @returns 键的数量，出错时返回负数
+ */
+LCUI_API int SelectorNode_GetFilterKeys( LCUI_SelectorNode sn, unsigned int **keys );
+
+LCUI_API void SelectorFilter_Init( LCUI_SelectorFilter filter );
+
+LCUI_API void SelectorFilter_Add( LCUI_SelectorFilter filter, unsigned int key );
+
+LCUI_API void SelectorFilter_Remove( LCUI_SelectorFilter filter, unsigned int key );
+
+/** 判断过滤器中是否可能包含指定的键 */
+LCUI_API LCUI_BOOL SelectorFilter_MayContain( LCUI_SelectorFilter filter,
+					      unsigned int key );
+
+/**
+ * 判断部件的状态变化是否会影响它自身的样式
+ * @param[in] status 状态名称
+ * @param[in] sn 部件的选择器结点，须包含该状态
+ */
+LCUI_API LCUI_BOOL LCUI_CheckStatusDependency( const char *status,
+					       LCUI_SelectorNode sn );
+
+/**
+ * 获取部件的状态变化可能影响到的后代部件的选择器结点
+ * 只有能与其中某个结点匹配的后代部件才需要更新样式
+ * @param[in] status 状态名称
+ * @param[in] sn 部件的选择器结点，须包含该状态
+ * @param[out] nodes 用于保存选择器结点的副本，需用 SelectorNode_Delete() 释放
+ * @returns 新增的选择器结点数量
+ */
+LCUI_API int LCUI_GetStatusDependents( const char *status, LCUI_SelectorNode sn,
+				       LinkedList *nodes );
+
+/** 获取样式库的版本号，每次添加样式规则后都会变化 */
+LCUI_API unsigned int LCUI_GetStyleSheetVersion( void );
+
 LCUI_API int LCUI_PutStyleSheet( LCUI_Selector selector,
 				 LCUI_StyleSheet in_ss, const char *space );
 
+/**
+ * 开始批量载入样式规则
+ * 在调用 LCUI_EndLoadStyleSheets() 之前，添加规则时不清理样式表缓存，结束时再
+ * 一并清理受影响的缓存项。可以嵌套调用
+ */
+LCUI_API void LCUI_BeginLoadStyleSheets( void );
+
+/** 结束批量载入样式规则 */
+LCUI_API void LCUI_EndLoadStyleSheets( void );
+
 /**
  * 从指定组中查找样式表
  * @param[in] group 组号
@@ -230,6 +296,25 @@ LCUI_API int LCUI_FindStyleSheetFromGroup( int group, const char *name,
 
 LCUI_API void LCUI_GetStyleSheet( LCUI_Selector s, LCUI_StyleSheet out_ss );
 
+/**
+ * 获取样式表，并用祖先选择器过滤器排除不可能匹配的后代选择器规则
+ * @param[in] s 选择器
+ * @param[in] filter 过滤器，必须包含选择器中除最后一个结点外的所有结点的键，
+ *  为 NULL 时与 LCUI_GetStyleSheet() 相同
+ * @param[out] out_ss 用于保存样式表
+ */
+LCUI_API void LCUI_GetStyleSheetWithFilter( LCUI_Selector s,
+					    LCUI_SelectorFilter filter,
+					    LCUI_StyleSheet out_ss );
+
+/**
+ * 从缓存中获取样式表
+ * @param[in] hash 选择器的哈希值
+ * @param[out] out_ss 用于保存样式表
+ * @returns 缓存中有对应的样式表时返回 0，否则返回 -1
+ */
+LCUI_API int LCUI_GetCachedStyleSheet( unsigned int hash, LCUI_StyleSheet out_ss );
+
 LCUI_API int LCUI_SetStyleName( int key, const char *name );
 
 LCUI_API int LCUI_AddStyleName( const char *name );
@@ -102,6 +102,7 @@ typedef struct LCUI_WidgetBoxRect {
 typedef struct LCUI_WidgetTaskBoxRec_ {
 	LCUI_BOOL for_self;			/**< 标志，指示当前部件是否有待处理的任务 */
 	LCUI_BOOL for_children;			/**< 标志，指示是否有待处理的子级部件 */
+	LCUI_BOOL is_scrolling;			/**< 标志，指示位置的变化是否由滚动引起 */
 	LCUI_BOOL buffer[WTT_TOTAL_NUM];	/**< 记录缓存 */
 } LCUI_WidgetTaskBoxRec;
 
@@ -123,6 +124,13 @@ typedef void( *LCUI_WidgetFunction )(LCUI_Widget);
 typedef void( *LCUI_WidgetResizer )(LCUI_Widget, float*, float*);
 typedef void( *LCUI_WidgetAttrSetter )(LCUI_Widget, const char*, const char*);
 typedef void( *LCUI_WidgetTextSetter )(LCUI_Widget, const char*);
+/**
+ * 部件绘制函数
+ * 在启用多线程渲染后，该函数可能会在多个渲染线程中同时被调用，每次调用的
+ * paint->rect 互不重叠。渲染期间主线程会等待所有渲染线程完成，因此绘制函数
+ * 可以安全地读取部件数据，但只能修改 paint->canvas 中的像素，不能修改部件
+ * 及其它共享的数据，也不能调用会修改部件树的接口。
+ */
 typedef void( *LCUI_WidgetPainter )(LCUI_Widget, LCUI_PaintContext);
 
 /** 部件原型数据结构 */
@@ -172,6 +180,7 @@ typedef struct LCUI_WidgetRec_ {
 	char			*type;			/**< 类型 */
 	char			**classes;		/**< 类列表 */
 	char			**status;		/**< 状态列表 */
+	LCUI_Atom		selector_atom;		/**< 选择器结点全名的原子，为 LCUI_ATOM_NONE 时需重新生成 */
 	wchar_t			*title;			/**< 标题 */
 	LCUI_Rect2F		padding;		/**< 内边距框 */
 	LCUI_Rect2F		margin;			/**< 外边距框 */
@@ -186,11 +195,12 @@ typedef struct LCUI_WidgetRec_ {
 	LCUI_WidgetData		data;			/**< 私有数据 */
 	Dict			*attributes;
 	LCUI_WidgetPrototypeC	proto;			/**< 原型 */
-	LCUI_BOOL		enable_graph;		/**< 是否启用位图缓存 */
-	LCUI_Graph		graph;			/**< 位图缓存 */
+	LCUI_BOOL		enable_graph;		/**< 是否启用位图缓存（独立图层） */
+	LCUI_Graph		graph;			/**< 位图缓存，保存部件及其子级部件的绘制结果 */
+	LCUI_RegionRec		graph_dirty_rects;	/**< 位图缓存中需要重绘的区域 */
 	LCUI_EventTrigger	trigger;		/**< 事件触发器 */
 	LCUI_WidgetTaskBoxRec	task;			/**< 任务记录 */
-	LinkedList		dirty_rects;		/**< 记录无效区域（脏矩形） */
+	LCUI_RegionRec		dirty_rects;		/**< 记录无效区域（脏矩形） */
 	LCUI_BOOL		has_dirty_child;	/**< 子级部件是否有无效区域 */
 	LCUI_BOOL		layout_locked;		/**< 子级部件布局是否已锁定 */
 	LCUI_BOOL		event_blocked;		/**< 是否阻止自己和子级部件的事件处理 */
@@ -300,6 +310,16 @@ LCUI_API void Widget_SetMargin( LCUI_Widget w, float top, float right,
 /** 移动部件位置 */
 LCUI_API void Widget_Move( LCUI_Widget w, float left, float top );
 
+/**
+ * 以滚动的方式设置部件的左边距
+ * 只修改 left 样式，更新位置时屏幕上已绘制的内容会被直接平移，只有新露出的区域
+ * 需要重绘，适用于滚动条所控制的内容层
+ */
+LCUI_API void Widget_ScrollLeft( LCUI_Widget w, float left );
+
+/** 以滚动的方式设置部件的上边距，说明同 Widget_ScrollLeft() */
+LCUI_API void Widget_ScrollTop( LCUI_Widget w, float top );
+
 /** 调整部件尺寸 */
 LCUI_API void Widget_Resize( LCUI_Widget w, float width, float height );
 
@@ -358,7 +378,7 @@ LCUI_API void Widget_UpdateLayout( LCUI_Widget w );
 LCUI_API void Widget_ExecUpdateLayout( LCUI_Widget w );
 
 /** 从部件中移除一个状态 */
-int Widget_RemoveStatus( LCUI_Widget w, const char *status_name );
+LCUI_API int Widget_RemoveStatus( LCUI_Widget w, const char *status_name );
 
 /** 打印部件树 */
 LCUI_API void Widget_PrintTree( LCUI_Widget w );
@@ -60,6 +60,17 @@ LCUI_API void Widget_InvalidateArea( LCUI_Widget w, LCUI_Rect *r, int box_type )
  */
 LCUI_API LCUI_BOOL Widget_PushInvalidArea( LCUI_Widget widget,
 					   LCUI_Rect *r, int box_type );
+/**
+ * 以平移屏幕内容的方式标记部件的移动
+ * 仅当部件在移动前后都覆盖了父部件的整个可见区域，且该区域的内容只随部件移动
+ * 而改变时可用，被其它部件遮挡的部分会被标记为无效区域
+ * @param[in] w		已经更新了位置的部件
+ * @param[in] old_x	部件移动前的呈现框 X 坐标
+ * @param[in] old_y	部件移动前的呈现框 Y 坐标
+ * @returns 成功返回 0，不满足条件时返回负数，此时应改为标记无效区域
+ */
+LCUI_API int Widget_PushScrollArea( LCUI_Widget w, float old_x, float old_y );
+
 /** 
  * 获取部件中的无效区域
  * @param[in] widget	目标部件
@@ -76,11 +87,11 @@ LCUI_API int Widget_GetInvalidArea( LCUI_Widget widget, LCUI_Rect *area );
 LCUI_API void Widget_ValidateArea( LCUI_Widget w, LCUI_Rect *r, int box_type );
 
 /**
- * 处理部件及其子级部件中的脏矩形，并合并至一个记录中
+ * 处理部件及其子级部件中的脏矩形，并合并至一个区域中
  * @param[in]	w	目标部件
- * @param[out]	rlist	合并后的脏矩形记录
+ * @param[out]	region	合并后的无效区域
  */
-LCUI_API int Widget_ProcInvalidArea( LCUI_Widget w, LinkedList *rlist );
+LCUI_API int Widget_ProcInvalidArea( LCUI_Widget w, LCUI_Region region );
 
 /** 
  * 将部件中的矩形区域转换成指定范围框内有效的矩形区域
@@ -99,6 +110,17 @@ LCUI_API int Widget_ConvertArea( LCUI_Widget w, LCUI_Rect *in_rect,
  */
 LCUI_API void Widget_Render( LCUI_Widget w, LCUI_PaintContext paint );
 
+/**
+ * 渲染部件在指定区域内的图形内容
+ * 与对区域中的每个矩形分别调用 Widget_Render() 的效果相同，但部件树只需遍历
+ * 一次，每个部件只绘制它与区域重叠的部分
+ * @param[in] w		部件
+ * @param[in] paint 	进行绘制时所需的上下文，其 rect 必须包含整个区域
+ * @param[in] region	需要绘制的区域，与 paint->rect 使用相同的坐标系
+ */
+LCUI_API void Widget_RenderRegion( LCUI_Widget w, LCUI_PaintContext paint,
+				   LCUI_Region region );
+
 LCUI_END_HEADER
 
 #endif
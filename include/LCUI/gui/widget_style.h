@@ -99,10 +99,33 @@ LCUI_API int Widget_FindStyles( LCUI_Widget w, LinkedList *list );
 /** 获取选择器结点 */
 LCUI_SelectorNode Widget_GetSelectorNode( LCUI_Widget w );
 
+/** 初始化部件的继承样式表 */
+void Widget_InitInheritedStyle( LCUI_Widget w );
+
+/** 销毁部件的继承样式表，若它正与其它部件共享，则只解除引用 */
+void Widget_DestroyInheritedStyle( LCUI_Widget w );
+
+/**
+ * 将部件记录到祖先过滤器中，在更新它的子级部件之前调用
+ * @returns 父部件已在过滤器中（或部件是根部件）且记录成功时返回 TRUE
+ */
+LCUI_BOOL Widget_PushAncestorFilter( LCUI_Widget w );
+
+/** 从祖先过滤器中移除部件，在更新完它的子级部件之后调用 */
+void Widget_PopAncestorFilter( LCUI_Widget w );
+
 /** 获取选择器 */
 LCUI_API LCUI_Selector Widget_GetSelector( LCUI_Widget w );
 
 /** 处理子级部件样式变化 */
 LCUI_API int Widget_HandleChildrenStyleChange( LCUI_Widget w, int type, const char *name );
 
+/**
+ * 处理部件状态变化
+ * 根据样式库中的状态依赖索引，只为样式可能受影响的部件及其后代部件添加样式
+ * 刷新任务。须在部件的状态列表包含该状态时调用。
+ * @returns 状态变化可能影响到的后代部件的选择器结点数量
+ */
+LCUI_API int Widget_HandleStatusChange( LCUI_Widget w, const char *name );
+
 #endif
@@ -126,6 +126,7 @@ typedef struct LCUI_AppDriverRec_ {
 	void ( *ProcessEvents )(void);
 	LCUI_BOOL( *WaitEvent )(void);
 	LCUI_BOOL( *PostTask )(LCUI_AppTask);
+	void ( *Wakeup )(void);
 	int( *BindSysEvent )(int, LCUI_EventFunc, void*, void( *)(void*));
 	int( *UnbindSysEvent )(int, LCUI_EventFunc);
 	int( *UnbindSysEvent2 )(int);
@@ -161,6 +162,21 @@ LCUI_API void *LCUI_GetAppData( void );
 
 LCUI_API void LCUI_SetTaskAgent( LCUI_BOOL enabled );
 
+/**
+ * 唤醒主循环
+ * 主循环在空闲等待时不会主动检查界面是否需要更新，在其它线程中提交重绘等
+ * 工作后需要调用该函数，添加任务和标记无效区域时会自动调用它
+ */
+LCUI_API void LCUI_Wakeup( void );
+
+/**
+ * 设置主循环是否在空闲时等待
+ * 启用后，如果没有需要更新的部件和需要重绘的区域，主循环会一直阻塞，直到有
+ * 输入事件、任务、定时器到期或重绘请求为止，而不是按帧率空转。使用虚拟时钟
+ * 时不会等待
+ */
+LCUI_API void LCUI_SetIdleWait( LCUI_BOOL enabled );
+
 /** 处理当前所有事件 */
 LCUI_API void LCUI_ProcessEvents( void );
 
@@ -42,6 +42,25 @@
 
 #include <LCUI/platform/linux/linux_x11events.h>
 
+/**
+ * 监听文件描述符
+ * 当它可读时，事件循环会在主线程中调用 func
+ * @param func 回调函数，为 NULL 时只用于唤醒主循环
+ */
+int LCUI_WatchLinuxFd( int fd, void( *func )(void*), void *arg );
+
+/** 停止监听文件描述符 */
+int LCUI_UnwatchLinuxFd( int fd );
+
+/** 处理已就绪的文件描述符，不会阻塞 */
+void LCUI_ProcessLinuxEvents( void );
+
+/** 阻塞等待，直到有文件描述符就绪、定时器到期或主循环被唤醒为止 */
+LCUI_BOOL LCUI_WaitLinuxEvent( void );
+
+/** 唤醒阻塞在 LCUI_WaitLinuxEvent() 中的主循环，可在任意线程中调用 */
+void LCUI_WakeupLinuxApp( void );
+
 LCUI_AppDriver LCUI_CreateLinuxAppDriver( void );
 void LCUI_DestroyLinuxAppDriver( LCUI_AppDriver app );
 
@@ -37,3 +37,27 @@
  * 没有，请查看：<http://www.gnu.org/licenses/>.
  * ****************************************************************************/
 
+#ifndef LCUI_LINUX_FB_DISPLAY_H
+#define LCUI_LINUX_FB_DISPLAY_H
+
+/**
+ * 创建基于帧缓存设备的显示驱动
+ * 设备路径由环境变量 LCUI_FBDEV 指定，默认为 /dev/fb0。如果该路径是普通文件，
+ * 则使用环境变量 LCUI_FBDEV_MODE 指定的模式（格式为 宽x高x位深，例如
+ * 320x240x16），默认为 800x600x32
+ */
+LCUI_DisplayDriver LCUI_CreateLinuxFBDisplayDriver( void );
+
+/**
+ * 打开指定的帧缓存设备并创建显示驱动
+ * @param[in] device 设备路径，也可以是普通文件，以便在没有帧缓存设备的环境中
+ *  使用，此时按 width、height 和 bpp 参数来确定帧缓存的格式和尺寸
+ * @param[in] bpp 每个像素的位数，支持 16（RGB565）、24（RGB888）和 32
+ */
+LCUI_DisplayDriver LCUI_OpenLinuxFBDisplayDriver( const char *device,
+						  int width, int height,
+						  int bpp );
+
+void LCUI_DestroyLinuxFBDisplayDriver( LCUI_DisplayDriver driver );
+
+#endif
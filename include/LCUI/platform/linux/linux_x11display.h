@@ -42,6 +42,13 @@
 
 LCUI_DisplayDriver LCUI_CreateLinuxX11DisplayDriver( void );
 
+/**
+ * 创建 X11 显示驱动
+ * @param[in] use_shm 是否使用 MIT-SHM 扩展，不使用或 X 服务器不支持时，
+ *  以 XPutImage() 传输像素数据
+ */
+LCUI_DisplayDriver LCUI_OpenLinuxX11DisplayDriver( LCUI_BOOL use_shm );
+
 void LCUI_DestroyLinuxX11DisplayDriver( LCUI_DisplayDriver driver );
 
 #endif
@@ -99,6 +99,27 @@ LCUI_API int LCUITimer_Continue( int timer_id );
  * */
 LCUI_API int LCUITimer_Reset( int timer_id, long int n_ms ) ;
 
+/**
+ * 处理已到期的定时器
+ * 在当前线程中直接调用到期的定时器的回调函数。仅在主循环模式或虚拟时钟下
+ * 有效，其它情况下由定时器线程处理。
+ * @return 已处理的定时器数量
+ */
+LCUI_API size_t LCUITimer_Process( void );
+
+/**
+ * 获取距离下一个定时器到期的时长
+ * @return 剩余的毫秒数，已有定时器到期时返回 0，没有定时器时返回 -1
+ */
+LCUI_API long int LCUITimer_GetTimeout( void );
+
+/**
+ * 设置是否由主循环处理定时器
+ * 启用后定时器线程会退出，主循环需要调用 LCUITimer_Process() 处理到期的
+ * 定时器，并在等待事件时以 LCUITimer_GetTimeout() 的返回值作为超时时长。
+ */
+LCUI_API void LCUITimer_SetMainLoopMode( LCUI_BOOL enabled );
+
 /* 初始化定时器模块 */
 LCUI_API void LCUI_InitTimer( void );
 
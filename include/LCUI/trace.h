@@ -0,0 +1,77 @@
+/* ***************************************************************************
+ * trace.h -- event tracing, exported in the Chrome trace event format.
+ *
+ * Copyright (C) 2017 by Liu Chao <lc-soft@live.cn>
+ *
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ *
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ *
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *
+ * The LCUI project is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ *
+ * You should have received a copy of the GPLv2 along with this file. It is
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+/* ****************************************************************************
+ * trace.h -- 事件跟踪，以 Chrome 跟踪事件格式导出
+ *
+ * 版权所有 (C) 2017 归属于 刘超 <lc-soft@live.cn>
+ *
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ *
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ *
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+#ifndef LCUI_TRACE_H
+#define LCUI_TRACE_H
+
+LCUI_BEGIN_HEADER
+
+/**
+ * 启用或禁用事件跟踪
+ * 禁用时各个探针只检查一个标志，几乎没有开销
+ */
+LCUI_API void LCUITrace_Enable( LCUI_BOOL enabled );
+
+/** 判断是否启用了事件跟踪 */
+LCUI_API LCUI_BOOL LCUITrace_IsEnabled( void );
+
+/**
+ * 记录一个时间段的开始
+ * 事件记录在当前线程自己的缓冲中，记录时不需要加锁，同一线程中的时间段需要
+ * 按嵌套顺序结束
+ * @param[in] category 类别，需要是常量字符串
+ * @param[in] name 名称，会被复制，过长的部分会被截断
+ */
+LCUI_API void LCUITrace_Begin( const char *category, const char *name );
+
+/** 记录一个时间段的结束，参数与 LCUITrace_Begin() 相同 */
+LCUI_API void LCUITrace_End( const char *category, const char *name );
+
+/**
+ * 将已记录的事件写入文件
+ * 文件为 JSON 格式，可以在 Chrome 的 about://tracing 或 Perfetto 中打开。写入后
+ * 这些事件会从缓冲中移除，每次写入的都是上次写入之后记录的事件
+ * @param[in] filepath 文件路径
+ * @return 正常返回写入的事件数量，文件打开失败时返回 -ENOENT
+ */
+LCUI_API int LCUITrace_Flush( const char *filepath );
+
+LCUI_END_HEADER
+
+#endif
@@ -45,7 +45,9 @@
 #include <LCUI/util/rbtree.h>
 #include <LCUI/util/linkedlist.h>
 #include <LCUI/util/dict.h>
+#include <LCUI/util/atom.h>
 #include <LCUI/util/rect.h>
+#include <LCUI/util/region.h>
 #include <LCUI/util/steptimer.h>
 #include <LCUI/util/string.h>
 #include <LCUI/util/parse.h>
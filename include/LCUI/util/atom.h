@@ -0,0 +1,64 @@
+/* ***************************************************************************
+ * atom.h -- interned strings, each name is stored once and identified by an integer.
+ *
+ * Copyright (C) 2017 by Liu Chao <lc-soft@live.cn>
+ *
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ *
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ *
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *
+ * The LCUI project is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ *
+ * You should have received a copy of the GPLv2 along with this file. It is
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+/* ****************************************************************************
+ * atom.h -- 字符串驻留，每个名称只保存一份，用整数标识
+ *
+ * 版权所有 (C) 2017 归属于 刘超 <lc-soft@live.cn>
+ *
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ *
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ *
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+#ifndef LCUI_UTIL_ATOM_H
+#define LCUI_UTIL_ATOM_H
+
+LCUI_BEGIN_HEADER
+
+/** 原子，相同的名称总是对应相同的原子，0 表示空名称 */
+typedef unsigned int LCUI_Atom;
+
+#define LCUI_ATOM_NONE 0
+
+/** 初始化原子表，由 LCUI_InitBase() 在初始化其它模块前调用 */
+LCUI_API void LCUIAtom_Init( void );
+
+/** 获取名称对应的原子，名称还没有登记时会登记它 */
+LCUI_API LCUI_Atom LCUIAtom_Get( const char *name );
+
+/** 查找名称对应的原子，名称还没有登记时返回 LCUI_ATOM_NONE */
+LCUI_API LCUI_Atom LCUIAtom_Find( const char *name );
+
+/** 获取原子对应的名称，返回的字符串在程序运行期间一直有效 */
+LCUI_API const char *LCUIAtom_GetName( LCUI_Atom atom );
+
+LCUI_END_HEADER
+
+#endif
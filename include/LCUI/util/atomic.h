@@ -0,0 +1,84 @@
+/* ***************************************************************************
+ * atomic.h -- atomic operations, used by the lock-free data structures.
+ *
+ * Copyright (C) 2017 by Liu Chao <lc-soft@live.cn>
+ *
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ *
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ *
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *
+ * The LCUI project is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ *
+ * You should have received a copy of the GPLv2 along with this file. It is
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+/* ****************************************************************************
+ * atomic.h -- 原子操作，供无锁数据结构使用。
+ *
+ * 版权所有 (C) 2017 归属于 刘超 <lc-soft@live.cn>
+ *
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ *
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ *
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+#ifndef LCUI_UTIL_ATOMIC_H
+#define LCUI_UTIL_ATOMIC_H
+
+/**
+ * 以下操作都带有完整的内存屏障，操作对象需要声明为 volatile。
+ * 整数类型的操作对象只支持 long 类型。
+ * LCUI_AtomicAdd() 返回的是相加之前的值。
+ */
+#ifdef _MSC_VER
+#include <intrin.h>
+
+#define LCUI_AtomicLoad(PTR) (_ReadWriteBarrier(), *(PTR))
+#define LCUI_AtomicExchange(PTR, VAL) \
+	_InterlockedExchange( (volatile long*)(PTR), (long)(VAL) )
+#ifdef _WIN64
+#define LCUI_AtomicExchangePtr(PTR, VAL) \
+	_InterlockedExchangePointer( (void* volatile*)(PTR), (void*)(VAL) )
+#else
+#define LCUI_AtomicExchangePtr(PTR, VAL) \
+	(void*)_InterlockedExchange( (volatile long*)(PTR), (long)(VAL) )
+#endif
+#define LCUI_AtomicCompareExchange(PTR, OLDVAL, NEWVAL) \
+	(_InterlockedCompareExchange( (volatile long*)(PTR), \
+	 (long)(NEWVAL), (long)(OLDVAL) ) == (long)(OLDVAL))
+#define LCUI_AtomicAdd(PTR, VAL) \
+	_InterlockedExchangeAdd( (volatile long*)(PTR), (long)(VAL) )
+
+#else
+
+#define LCUI_AtomicLoad(PTR) __atomic_load_n( PTR, __ATOMIC_SEQ_CST )
+#define LCUI_AtomicExchange(PTR, VAL) \
+	__atomic_exchange_n( PTR, VAL, __ATOMIC_SEQ_CST )
+#define LCUI_AtomicExchangePtr(PTR, VAL) \
+	__atomic_exchange_n( PTR, VAL, __ATOMIC_SEQ_CST )
+#define LCUI_AtomicCompareExchange(PTR, OLDVAL, NEWVAL) \
+	__sync_bool_compare_and_swap( PTR, OLDVAL, NEWVAL )
+#define LCUI_AtomicAdd(PTR, VAL) \
+	__atomic_fetch_add( PTR, VAL, __ATOMIC_SEQ_CST )
+
+#endif
+
+#define LCUI_AtomicStore(PTR, VAL) (void)LCUI_AtomicExchange( PTR, VAL )
+#define LCUI_AtomicStorePtr(PTR, VAL) (void)LCUI_AtomicExchangePtr( PTR, VAL )
+
+#endif
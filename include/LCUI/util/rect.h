@@ -86,6 +86,16 @@ LCUI_API LCUI_BOOL LCUIRectF_GetOverlayRect( const LCUI_RectF *a,
 /** 合并两个矩形 */
 LCUI_API void LCUIRect_MergeRect( LCUI_Rect *big, LCUI_Rect *a, LCUI_Rect *b );
 
+/**
+ * 裁剪掉矩形中被另一个矩形遮挡的部分
+ * 只有当遮挡矩形横跨整个矩形的宽度或高度时才裁剪，以保证裁剪后仍是矩形
+ * @param[in,out] rect	被裁剪的矩形
+ * @param[in] cover	遮挡矩形
+ * @returns 如果矩形被完全遮挡，则返回TRUE，否则返回FALSE
+ */
+LCUI_API LCUI_BOOL LCUIRect_CutCoveredArea( LCUI_Rect *rect,
+					    const LCUI_Rect *cover );
+
 /** 
  * 根据重叠矩形 rect1，将矩形 rect2 分割成四个矩形
  * 分割方法如下：
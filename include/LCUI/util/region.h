@@ -0,0 +1,111 @@
+/* ***************************************************************************
+ * region.h -- Banded region handling
+ * 
+ * Copyright (C) 2017 by Liu Chao <lc-soft@live.cn>
+ * 
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ * 
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ * 
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *  
+ * The LCUI project is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY 
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ * 
+ * You should have received a copy of the GPLv2 along with this file. It is 
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+ 
+/* ****************************************************************************
+ * region.h -- 分带区域处理
+ *
+ * 版权所有 (C) 2017 归属于 刘超 <lc-soft@live.cn>
+ * 
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ * 
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ * 
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>. 
+ * ****************************************************************************/
+
+#ifndef LCUI_UTIL_REGION_H
+#define LCUI_UTIL_REGION_H
+
+LCUI_BEGIN_HEADER
+
+/**
+ * 区域，由多个互不重叠的矩形组成
+ * 矩形按 y-x 分带排列：同一矩形带中的矩形有相同的上下边界，并按 x 坐标从左到
+ * 右排列；矩形带按 y 坐标从上到下排列，且互不重叠
+ */
+typedef struct LCUI_RegionRec_ {
+	LCUI_Rect *rects;	/**< 矩形数组 */
+	int length;		/**< 矩形数量 */
+	int capacity;		/**< 矩形数组的容量 */
+	LCUI_Rect *spare;	/**< 备用的矩形数组，用于存放以自身为操作数的运算结果 */
+	int spare_capacity;	/**< 备用矩形数组的容量 */
+	LCUI_Rect extents;	/**< 包围盒 */
+} LCUI_RegionRec, *LCUI_Region;
+
+#define Region_IsEmpty(R) ((R)->length <= 0)
+
+/** 初始化区域 */
+LCUI_API void Region_Init( LCUI_Region region );
+
+/** 销毁区域，释放矩形数组和备用矩形数组占用的内存 */
+LCUI_API void Region_Destroy( LCUI_Region region );
+
+/** 清空区域，保留已分配的内存以便复用 */
+LCUI_API void Region_Clear( LCUI_Region region );
+
+/** 复制区域 */
+LCUI_API int Region_Copy( LCUI_Region dst, LCUI_Region src );
+
+/**
+ * 计算两个区域的并集
+ * @param[out] out 结果区域，可以与 a 或 b 相同
+ */
+LCUI_API int Region_Union( LCUI_Region out, LCUI_Region a, LCUI_Region b );
+
+/** 计算两个区域的交集 */
+LCUI_API int Region_Intersect( LCUI_Region out, LCUI_Region a, LCUI_Region b );
+
+/** 从区域 a 中减去区域 b */
+LCUI_API int Region_Subtract( LCUI_Region out, LCUI_Region a, LCUI_Region b );
+
+/** 将矩形合并到区域中 */
+LCUI_API int Region_UnionRect( LCUI_Region region, const LCUI_Rect *rect );
+
+/** 只保留区域与矩形重叠的部分 */
+LCUI_API int Region_IntersectRect( LCUI_Region region, const LCUI_Rect *rect );
+
+/** 计算区域与矩形的交集，结果保存到 out 中，区域本身不变 */
+LCUI_API int Region_IntersectWithRect( LCUI_Region out, LCUI_Region region,
+				       const LCUI_Rect *rect );
+
+/** 从区域中减去矩形 */
+LCUI_API int Region_SubtractRect( LCUI_Region region, const LCUI_Rect *rect );
+
+/** 判断区域是否完全包含矩形 */
+LCUI_API LCUI_BOOL Region_ContainsRect( LCUI_Region region,
+					const LCUI_Rect *rect );
+
+/** 判断区域是否与矩形有重叠 */
+LCUI_API LCUI_BOOL Region_OverlapsRect( LCUI_Region region,
+					const LCUI_Rect *rect );
+
+/** 平移区域 */
+LCUI_API void Region_Translate( LCUI_Region region, int dx, int dy );
+
+LCUI_END_HEADER
+
+#endif
@@ -48,6 +48,22 @@ LCUI_API int64_t LCUI_GetTime( void );
 
 LCUI_API int64_t LCUI_GetTimeDelta( int64_t start );
 
+/** 获取单调时钟的时间，单位为微秒，不受虚拟时钟影响，供性能统计使用 */
+LCUI_API int64_t LCUI_GetTimeUS( void );
+
+/**
+ * 启用或禁用虚拟时钟
+ * 启用后时间只在调用 LCUITime_Advance() 时前进，主循环每一帧的等待也会改为
+ * 直接推进虚拟时间，适用于需要结果可重现的场合。切换前后的时间是连续的。
+ */
+LCUI_API void LCUITime_SetVirtualClock( LCUI_BOOL enabled );
+
+/** 判断是否正在使用虚拟时钟 */
+LCUI_API LCUI_BOOL LCUITime_IsVirtualClock( void );
+
+/** 推进虚拟时钟 */
+LCUI_API void LCUITime_Advance( unsigned int ms );
+
 LCUI_API void LCUI_Sleep( unsigned int s );
 
 LCUI_API void LCUI_MSleep( unsigned int ms );
@@ -39,8 +39,10 @@
 
 //#define DEBUG
 #include <time.h>
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/input.h>
@@ -48,30 +50,80 @@
 #include <LCUI/cursor.h>
 #include <LCUI/thread.h>
 #include <LCUI/display.h>
+#include <LCUI/framestats.h>
 #include <LCUI/platform.h>
 #include LCUI_DISPLAY_H
 
 #define DEFAULT_WIDTH	800
 #define DEFAULT_HEIGHT	600
+#define TILE_SIZE	64
+#define MAX_RENDER_THREADS 16
+#define MAX_SCROLL_RECORDS 8
 
 /** surface 记录 */
 typedef struct SurfaceRecordRec_ {
 	LCUI_BOOL rendered;		/**< 是否已渲染了新内容 */
-	LinkedList rects;		/**< 需重绘的区域列表 */
+	LCUI_RegionRec rects;		/**< 需重绘的区域 */
 	LCUI_Surface surface;		/**< surface */
 	LCUI_Widget widget;		/**< surface 所映射的 widget */
+	LCUI_Graph buffers[2];		/**< 流水线模式下的双缓冲，轮流用于渲染和呈现 */
+	int back;			/**< 用于渲染的缓冲的下标 */
+	LCUI_RegionRec damage;		/**< 后台缓冲中已重绘但还未提交的区域 */
+	LCUI_RegionRec present_rects;	/**< 前台缓冲中等待显示线程呈现的区域 */
 } SurfaceRecordRec, *SurfaceRecord;
 
+/** 区域平移记录 */
+typedef struct ScrollRecordRec_ {
+	LCUI_Rect rect;			/**< 需要平移的区域 */
+	int dx, dy;			/**< 平移的距离 */
+} ScrollRecordRec, *ScrollRecord;
+
+/** 渲染线程 */
+typedef struct RenderWorkerRec_ {
+	LCUI_Thread thread;		/**< 线程，主线程不使用该成员 */
+	LCUI_GraphArenaRec arena;	/**< 绘制时使用的临时图形内存池 */
+	LCUI_RegionRec region;		/**< 当前图块内需要重绘的区域 */
+} RenderWorkerRec, *RenderWorker;
+
+/** 分块渲染任务 */
+typedef struct RenderTaskRec_ {
+	LCUI_Widget widget;		/**< 需要渲染的部件 */
+	LCUI_PaintContext paint;	/**< surface 的绘制上下文 */
+	int cols;			/**< 每行的图块数量 */
+	int total;			/**< 图块总数 */
+	int next;			/**< 下一个待渲染的图块 */
+	int running;			/**< 正在渲染中的图块数量 */
+} RenderTaskRec, *RenderTask;
+
 /** 图形显示功能的上下文数据 */
 static struct DisplayContext {
 	int mode;			/**< 显示模式 */
 	size_t width, height;		/**< 当前缓存的屏幕尺寸 */
 	LCUI_BOOL show_rect_border;	/**< 是否为重绘的区域显示边框 */
 	LCUI_BOOL is_working;		/**< 标志，指示当前模块是否处于工作状态 */
-	LCUI_Thread thread;		/**< 线程，负责画面更新工作 */
+	LCUI_Thread thread;		/**< 显示线程，在流水线模式下负责呈现画面 */
 	LinkedList surfaces;		/**< surface 列表 */
-	LinkedList rects;		/**< 无效区域列表 */
+	LCUI_RegionRec rects;		/**< 无效区域 */
+	LinkedList scrolls;		/**< 待执行的区域平移操作 */
 	LCUI_DisplayDriver driver;
+	struct {
+		int n_threads;		/**< 参与渲染的线程数量，包括主线程 */
+		LCUI_BOOL is_running;	/**< 渲染线程是否在运行 */
+		LCUI_Mutex mutex;	/**< 保护渲染任务的互斥锁 */
+		LCUI_Cond cond;		/**< 有新的渲染任务时通知渲染线程 */
+		LCUI_Cond done;		/**< 渲染任务完成时通知主线程 */
+		RenderTaskRec task;	/**< 当前的渲染任务 */
+		/** 渲染线程列表，第一个由主线程使用 */
+		RenderWorkerRec workers[MAX_RENDER_THREADS];
+	} render;
+	struct {
+		LCUI_BOOL enabled;	/**< 是否启用流水线模式 */
+		LCUI_BOOL is_running;	/**< 显示线程是否在运行 */
+		LCUI_BOOL is_busy;	/**< 显示线程是否正在呈现已提交的帧 */
+		LCUI_Mutex mutex;	/**< 保护显示线程状态的互斥锁 */
+		LCUI_Cond cond;		/**< 有新的帧需要呈现时通知显示线程 */
+		LCUI_Cond done;		/**< 呈现完成时通知主线程 */
+	} pipeline;
 } display;
 
 #define LCUIDisplay_CleanSurfaces() \
@@ -81,6 +133,11 @@ static void OnDestroySurfaceRecord( void *data )
 {
 	SurfaceRecord record = data;
 	Surface_Close( record->surface );
+	Region_Destroy( &record->rects );
+	Region_Destroy( &record->damage );
+	Region_Destroy( &record->present_rects );
+	Graph_Free( &record->buffers[0] );
+	Graph_Free( &record->buffers[1] );
 	free( record );
 }
 
@@ -101,6 +158,361 @@ static void DrawBorder( LCUI_PaintContext paint )
 	Graph_DrawHorizLine( &paint->canvas, color, 1, pos, end_x );
 }
 
+/** 用颜色填充绘制上下文中需要绘制的区域 */
+static void FillRegion( LCUI_PaintContext paint, LCUI_Color color )
+{
+	int i;
+	LCUI_Rect rect;
+	LCUI_Graph canvas;
+	for( i = 0; i < paint->region->length; ++i ) {
+		rect = paint->region->rects[i];
+		rect.x -= paint->rect.x;
+		rect.y -= paint->rect.y;
+		Graph_Quote( &canvas, &paint->canvas, &rect );
+		Graph_FillRect( &canvas, color, NULL, TRUE );
+	}
+}
+
+/** 为绘制上下文中的每个区域绘制边框 */
+static void DrawRegionBorder( LCUI_PaintContext paint )
+{
+	int i;
+	LCUI_Rect rect;
+	LCUI_PaintContextRec rect_paint;
+	for( i = 0; i < paint->region->length; ++i ) {
+		rect = paint->region->rects[i];
+		rect_paint.rect = rect;
+		rect.x -= paint->rect.x;
+		rect.y -= paint->rect.y;
+		Graph_Quote( &rect_paint.canvas, &paint->canvas, &rect );
+		DrawBorder( &rect_paint );
+	}
+}
+
+/** 渲染任务中的一个图块 */
+static void RenderTile( RenderWorker worker, int i )
+{
+	LCUI_Rect rect;
+	LCUI_PaintContextRec paint;
+	RenderTask task = &display.render.task;
+
+	rect.x = task->paint->rect.x + (i % task->cols) * TILE_SIZE;
+	rect.y = task->paint->rect.y + (i / task->cols) * TILE_SIZE;
+	rect.width = TILE_SIZE;
+	rect.height = TILE_SIZE;
+	/* 只取出与图块重叠的部分，不必复制整个脏区域 */
+	Region_IntersectWithRect( &worker->region, task->paint->region, &rect );
+	if( Region_IsEmpty( &worker->region ) ) {
+		return;
+	}
+	paint.rect = worker->region.extents;
+	paint.with_alpha = task->paint->with_alpha;
+	paint.arena = &worker->arena;
+	paint.region = &worker->region;
+	rect = paint.rect;
+	rect.x -= task->paint->rect.x;
+	rect.y -= task->paint->rect.y;
+	Graph_Quote( &paint.canvas, &task->paint->canvas, &rect );
+	FillRegion( &paint, RGB( 255, 255, 255 ) );
+	Widget_RenderRegion( task->widget, &paint, &worker->region );
+}
+
+/** 领取并渲染图块，直到没有剩余的图块，调用前需锁定互斥锁 */
+static void RenderTask_Run( RenderWorker worker )
+{
+	int i;
+	RenderTask task = &display.render.task;
+	while( task->next < task->total ) {
+		i = task->next++;
+		task->running += 1;
+		LCUIMutex_Unlock( &display.render.mutex );
+		RenderTile( worker, i );
+		LCUIMutex_Lock( &display.render.mutex );
+		task->running -= 1;
+	}
+	if( task->running == 0 ) {
+		LCUICond_Signal( &display.render.done );
+	}
+}
+
+static void RenderThread( void *arg )
+{
+	RenderWorker worker = arg;
+	LCUIMutex_Lock( &display.render.mutex );
+	while( display.render.is_running ) {
+		if( display.render.task.next >= display.render.task.total ) {
+			LCUICond_Wait( &display.render.cond,
+				       &display.render.mutex );
+			continue;
+		}
+		RenderTask_Run( worker );
+	}
+	LCUIMutex_Unlock( &display.render.mutex );
+}
+
+/** 将绘制区域分成多个图块，由各个渲染线程并行渲染 */
+static void RenderTiles( LCUI_Widget widget, LCUI_PaintContext paint )
+{
+	RenderTask task = &display.render.task;
+	LCUIMutex_Lock( &display.render.mutex );
+	task->widget = widget;
+	task->paint = paint;
+	task->cols = (paint->rect.width + TILE_SIZE - 1) / TILE_SIZE;
+	task->total = (paint->rect.height + TILE_SIZE - 1) / TILE_SIZE;
+	task->total *= task->cols;
+	task->next = 0;
+	task->running = 0;
+	LCUICond_Broadcast( &display.render.cond );
+	RenderTask_Run( &display.render.workers[0] );
+	while( task->running > 0 ) {
+		LCUICond_Wait( &display.render.done, &display.render.mutex );
+	}
+	task->total = 0;
+	LCUIMutex_Unlock( &display.render.mutex );
+}
+
+static void StartRenderThreads( void )
+{
+	int i;
+	display.render.is_running = TRUE;
+	for( i = 1; i < display.render.n_threads; ++i ) {
+		LCUIThread_Create( &display.render.workers[i].thread,
+				   RenderThread, &display.render.workers[i] );
+	}
+}
+
+static void StopRenderThreads( void )
+{
+	int i;
+	LCUIMutex_Lock( &display.render.mutex );
+	display.render.is_running = FALSE;
+	LCUICond_Broadcast( &display.render.cond );
+	LCUIMutex_Unlock( &display.render.mutex );
+	for( i = 1; i < display.render.n_threads; ++i ) {
+		LCUIThread_Join( display.render.workers[i].thread, NULL );
+	}
+}
+
+/*---------------------------- pipeline <START> -----------------------------*/
+
+/**
+ * 流水线模式
+ * 部件树只能在主线程中访问，所以渲染仍在主线程中进行，但画面是渲染到 surface
+ * 记录自带的后台缓冲中，而不是直接写入 surface 的帧缓存。提交一帧时交换前后
+ * 台缓冲，由显示线程把前台缓冲中的新内容复制到 surface 并呈现，主线程则继续
+ * 处理下一帧的事件、更新和渲染。surface 的互斥锁只在复制期间持有。
+ */
+
+/** 等待显示线程呈现完已提交的帧，之后才能修改 surface 记录和前台缓冲 */
+static void LCUIDisplay_WaitPresent( void )
+{
+	if( !display.pipeline.is_running ) {
+		return;
+	}
+	LCUIMutex_Lock( &display.pipeline.mutex );
+	while( display.pipeline.is_busy ) {
+		LCUICond_Wait( &display.pipeline.done,
+			       &display.pipeline.mutex );
+	}
+	LCUIMutex_Unlock( &display.pipeline.mutex );
+}
+
+/** 准备 surface 记录的双缓冲，尺寸有变化时重新创建并重绘全部区域 */
+static void SurfaceRecord_PrepareBuffers( SurfaceRecord record )
+{
+	int i, width, height;
+	LCUI_Rect rect;
+	width = roundi( record->widget->box.graph.width );
+	height = roundi( record->widget->box.graph.height );
+	if( record->buffers[0].width == width &&
+	    record->buffers[0].height == height ) {
+		return;
+	}
+	LCUIDisplay_WaitPresent();
+	for( i = 0; i < 2; ++i ) {
+		Graph_Free( &record->buffers[i] );
+		Graph_Init( &record->buffers[i] );
+		record->buffers[i].color_type = COLOR_TYPE_PARGB;
+		if( width < 1 || height < 1 ) {
+			continue;
+		}
+		Graph_Create( &record->buffers[i], width, height );
+		Graph_FillRect( &record->buffers[i], RGB( 255, 255, 255 ),
+				NULL, TRUE );
+	}
+	Region_Clear( &record->damage );
+	Region_Clear( &record->present_rects );
+	rect.x = rect.y = 0;
+	rect.width = width;
+	rect.height = height;
+	Region_UnionRect( &record->rects, &rect );
+}
+
+/** 开始绘制 surface 记录，流水线模式下绘制的是它的后台缓冲 */
+static LCUI_PaintContext SurfaceRecord_BeginPaint( SurfaceRecord record,
+						   LCUI_Rect *rect )
+{
+	LCUI_Graph *buffer;
+	LCUI_PaintContext paint;
+	if( !display.pipeline.enabled ) {
+		return Surface_BeginPaint( record->surface, rect );
+	}
+	buffer = &record->buffers[record->back];
+	if( !Graph_IsValid( buffer ) ) {
+		return NULL;
+	}
+	paint = malloc( sizeof( LCUI_PaintContextRec ) );
+	if( !paint ) {
+		return NULL;
+	}
+	paint->rect = *rect;
+	paint->with_alpha = FALSE;
+	paint->arena = NULL;
+	paint->region = NULL;
+	Graph_Init( &paint->canvas );
+	LCUIRect_ValidateArea( &paint->rect, buffer->width, buffer->height );
+	Graph_Quote( &paint->canvas, buffer, &paint->rect );
+	return paint;
+}
+
+static void SurfaceRecord_EndPaint( SurfaceRecord record,
+				    LCUI_PaintContext paint )
+{
+	if( !display.pipeline.enabled ) {
+		Surface_EndPaint( record->surface, paint );
+		return;
+	}
+	if( paint->region ) {
+		Region_Union( &record->damage, &record->damage, paint->region );
+	} else {
+		Region_UnionRect( &record->damage, &paint->rect );
+	}
+	free( paint );
+}
+
+/** 复制缓冲中的区域 */
+static void CopyBufferRegion( LCUI_Graph *des, LCUI_Graph *src,
+			      LCUI_Region region, int offset_x, int offset_y )
+{
+	int i;
+	LCUI_Rect rect;
+	LCUI_Graph slot;
+	for( i = 0; i < region->length; ++i ) {
+		rect = region->rects[i];
+		Graph_Quote( &slot, src, &rect );
+		Graph_Replace( des, &slot, rect.x - offset_x,
+			       rect.y - offset_y );
+	}
+}
+
+/** 将前台缓冲中等待呈现的内容复制到 surface 并呈现，在显示线程中调用 */
+static void SurfaceRecord_Present( SurfaceRecord record )
+{
+	LCUI_PaintContext paint;
+	LCUI_Graph *front = &record->buffers[!record->back];
+	if( Region_IsEmpty( &record->present_rects ) ||
+	    !Surface_IsReady( record->surface ) ) {
+		return;
+	}
+	paint = Surface_BeginPaint( record->surface,
+				    &record->present_rects.extents );
+	if( !paint ) {
+		return;
+	}
+	Region_IntersectRect( &record->present_rects, &paint->rect );
+	CopyBufferRegion( &paint->canvas, front, &record->present_rects,
+			  paint->rect.x, paint->rect.y );
+	paint->region = &record->present_rects;
+	Surface_EndPaint( record->surface, paint );
+	Surface_Present( record->surface );
+	Region_Clear( &record->present_rects );
+}
+
+static void DisplayThread( void *arg )
+{
+	LinkedListNode *node;
+	LCUIMutex_Lock( &display.pipeline.mutex );
+	while( display.pipeline.is_running ) {
+		if( !display.pipeline.is_busy ) {
+			LCUICond_Wait( &display.pipeline.cond,
+				       &display.pipeline.mutex );
+			continue;
+		}
+		LCUIMutex_Unlock( &display.pipeline.mutex );
+		for( LinkedList_Each( node, &display.surfaces ) ) {
+			SurfaceRecord_Present( node->data );
+		}
+		LCUIMutex_Lock( &display.pipeline.mutex );
+		display.pipeline.is_busy = FALSE;
+		LCUICond_Broadcast( &display.pipeline.done );
+	}
+	LCUIMutex_Unlock( &display.pipeline.mutex );
+}
+
+/** 提交渲染好的帧，交换前后台缓冲，然后让显示线程呈现 */
+static void LCUIDisplay_SubmitFrame( void )
+{
+	int back;
+	size_t count = 0;
+	LinkedListNode *node;
+	LCUIDisplay_WaitPresent();
+	for( LinkedList_Each( node, &display.surfaces ) ) {
+		SurfaceRecord record = node->data;
+		if( Region_IsEmpty( &record->damage ) ) {
+			continue;
+		}
+		back = !record->back;
+		record->back = back;
+		/* 新的后台缓冲缺少刚提交的内容，需要从前台缓冲复制过来 */
+		CopyBufferRegion( &record->buffers[back],
+				  &record->buffers[!back],
+				  &record->damage, 0, 0 );
+		Region_Union( &record->present_rects,
+			      &record->present_rects, &record->damage );
+		Region_Clear( &record->damage );
+		++count;
+	}
+	if( count == 0 ) {
+		return;
+	}
+	LCUIMutex_Lock( &display.pipeline.mutex );
+	display.pipeline.is_busy = TRUE;
+	LCUICond_Signal( &display.pipeline.cond );
+	LCUIMutex_Unlock( &display.pipeline.mutex );
+}
+
+static void StartDisplayThread( void )
+{
+	display.pipeline.is_busy = FALSE;
+	display.pipeline.is_running = TRUE;
+	LCUIThread_Create( &display.thread, DisplayThread, NULL );
+}
+
+static void StopDisplayThread( void )
+{
+	LinkedListNode *node;
+	LCUIDisplay_WaitPresent();
+	LCUIMutex_Lock( &display.pipeline.mutex );
+	display.pipeline.is_running = FALSE;
+	LCUICond_Signal( &display.pipeline.cond );
+	LCUIMutex_Unlock( &display.pipeline.mutex );
+	LCUIThread_Join( display.thread, NULL );
+	/* 未提交的内容只在后台缓冲中，需要重绘到 surface 上 */
+	for( LinkedList_Each( node, &display.surfaces ) ) {
+		SurfaceRecord record = node->data;
+		if( !Region_IsEmpty( &record->damage ) ) {
+			Region_Union( &record->rects, &record->rects,
+				      &record->damage );
+			Region_Clear( &record->damage );
+		}
+		Region_Clear( &record->present_rects );
+		Graph_Free( &record->buffers[0] );
+		Graph_Free( &record->buffers[1] );
+	}
+}
+
+/*----------------------------- pipeline <END> ------------------------------*/
+
 void LCUIDisplay_Update( void )
 {
 	LCUI_Surface surface;
@@ -127,17 +539,99 @@ void LCUIDisplay_Update( void )
 	if( display.mode == LCDM_SEAMLESS || !record ) {
 		return;
 	}
-	LinkedList_Concat( &record->rects, &display.rects );
+	Region_Union( &record->rects, &record->rects, &display.rects );
+	Region_Clear( &display.rects );
+}
+
+LCUI_BOOL LCUIDisplay_NeedUpdate( void )
+{
+	LinkedListNode *node;
+	LCUI_Widget root = LCUIWidget_GetRoot();
+
+	if( !display.is_working ) {
+		return FALSE;
+	}
+	if( root->task.for_self || root->task.for_children ||
+	    root->has_dirty_child || !Region_IsEmpty( &root->dirty_rects ) ) {
+		return TRUE;
+	}
+	if( !Region_IsEmpty( &display.rects ) || display.scrolls.length > 0 ) {
+		return TRUE;
+	}
+	for( LinkedList_Each( node, &display.surfaces ) ) {
+		SurfaceRecord record = node->data;
+		if( !Region_IsEmpty( &record->rects ) ) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/**
+ * 平移 surface 中已绘制的内容
+ * 平移区域内的无效区域会随内容一起移动，所以需要把移动后的位置也标记为无效
+ * 区域，再加上平移后新露出的区域，这些区域会在之后的重绘中更新
+ * @returns 如果 surface 的内容有变化则返回 TRUE
+ */
+static LCUI_BOOL ScrollSurface( SurfaceRecord record )
+{
+	LCUI_Rect rect;
+	LinkedListNode *node;
+	LCUI_RegionRec region;
+	LCUI_PaintContext paint;
+	LCUI_BOOL scrolled = FALSE;
+
+	Region_Init( &region );
+	for( LinkedList_Each( node, &display.scrolls ) ) {
+		ScrollRecord scroll = node->data;
+		/* 区域内容全部被移出时，直接重绘整个区域 */
+		if( abs( scroll->dx ) >= scroll->rect.width ||
+		    abs( scroll->dy ) >= scroll->rect.height ) {
+			Region_UnionRect( &record->rects, &scroll->rect );
+			continue;
+		}
+		paint = SurfaceRecord_BeginPaint( record, &scroll->rect );
+		if( !paint ) {
+			Region_UnionRect( &record->rects, &scroll->rect );
+			continue;
+		}
+		Region_Copy( &region, &record->rects );
+		Region_IntersectRect( &region, &paint->rect );
+		Region_Translate( &region, scroll->dx, scroll->dy );
+		Region_IntersectRect( &region, &paint->rect );
+		Region_Union( &record->rects, &record->rects, &region );
+		/* 加上新露出的区域 */
+		rect = paint->rect;
+		rect.x += scroll->dx;
+		rect.y += scroll->dy;
+		Region_Clear( &region );
+		Region_UnionRect( &region, &paint->rect );
+		Region_SubtractRect( &region, &rect );
+		Region_Union( &record->rects, &record->rects, &region );
+		Graph_Scroll( &paint->canvas, scroll->dx, scroll->dy );
+		paint->region = NULL;
+		SurfaceRecord_EndPaint( record, paint );
+		scrolled = TRUE;
+	}
+	LinkedList_Clear( &display.scrolls, free );
+	Region_Destroy( &region );
+	return scrolled;
 }
 
 void LCUIDisplay_Render( void )
 {
-	LinkedListNode *sn, *rn;
+	int i;
+	LinkedListNode *sn;
 	LCUI_PaintContext paint;
+	RenderWorker worker = &display.render.workers[0];
 
 	if( !display.is_working ) {
 		return;
 	}
+	/* 上一帧的临时图形已经用完，复位内存池 */
+	for( i = 0; i < display.render.n_threads; ++i ) {
+		GraphArena_Reset( &display.render.workers[i].arena );
+	}
 	/* 遍历当前的 surface 记录列表 */
 	for( LinkedList_Each( sn, &display.surfaces ) ) {
 		SurfaceRecord record = sn->data;
@@ -148,24 +642,47 @@ void LCUIDisplay_Render( void )
 			continue;
 		}
 		record->rendered = FALSE;
-		/* 在 surface 上逐个重绘无效区域 */
-		for( LinkedList_Each( rn, &record->rects ) ) {
-			paint = Surface_BeginPaint( surface, rn->data );
-			if( !paint ) {
-				continue;
-			}
-			DEBUG_MSG( "[%s]: render rect: (%d,%d,%d,%d)\n",
-				   record->widget->type,
-				   paint->rect.x, paint->rect.y,
-				   paint->rect.width, paint->rect.height );
-			Widget_Render( record->widget, paint );
-			if( display.show_rect_border ) {
-				DrawBorder( paint );
-			}
-			Surface_EndPaint( surface, paint );
-			record->rendered = TRUE;
+		if( display.pipeline.enabled ) {
+			SurfaceRecord_PrepareBuffers( record );
+		}
+		/* 平移操作只在窗口模式和全屏模式下记录，此时只有一个 surface */
+		if( display.scrolls.length > 0 ) {
+			record->rendered = ScrollSurface( record );
+		}
+		if( Region_IsEmpty( &record->rects ) ) {
+			continue;
 		}
-		RectList_Clear( &record->rects );
+		/* 一次性重绘所有无效区域，部件树只需遍历一次 */
+		paint = SurfaceRecord_BeginPaint( record,
+						  &record->rects.extents );
+		if( !paint ) {
+			Region_Clear( &record->rects );
+			continue;
+		}
+		paint->arena = &worker->arena;
+		paint->region = &record->rects;
+		Region_IntersectRect( &record->rects, &paint->rect );
+		DEBUG_MSG( "[%s]: render %d rects in (%d,%d,%d,%d)\n",
+			   record->widget->type, record->rects.length,
+			   paint->rect.x, paint->rect.y,
+			   paint->rect.width, paint->rect.height );
+		/* 区域较小时，分块渲染带来的线程同步开销得不偿失 */
+		if( display.render.n_threads > 1 &&
+		    (paint->rect.width > TILE_SIZE ||
+		     paint->rect.height > TILE_SIZE) ) {
+			RenderTiles( record->widget, paint );
+		} else {
+			FillRegion( paint, RGB( 255, 255, 255 ) );
+			Widget_RenderRegion( record->widget, paint,
+					     &record->rects );
+		}
+		if( display.show_rect_border ) {
+			DrawRegionBorder( paint );
+		}
+		SurfaceRecord_EndPaint( record, paint );
+		record->rendered = TRUE;
+		LCUIFrameStats_AddRender( surface, &record->rects );
+		Region_Clear( &record->rects );
 	}
 }
 
@@ -175,6 +692,10 @@ void LCUIDisplay_Present( void )
 	if( !display.is_working ) {
 		return;
 	}
+	if( display.pipeline.enabled ) {
+		LCUIDisplay_SubmitFrame();
+		return;
+	}
 	for( LinkedList_Each( sn, &display.surfaces ) ) {
 		SurfaceRecord record = sn->data;
 		LCUI_Surface surface = record->surface;
@@ -200,7 +721,43 @@ void LCUIDisplay_InvalidateArea( LCUI_Rect *rect )
 		screen.height = LCUIDisplay_GetHeight();
 		rect = &screen;
 	}
-	RectList_Add( &display.rects, rect );
+	Region_UnionRect( &display.rects, rect );
+	LCUI_Wakeup();
+}
+
+int LCUIDisplay_ScrollArea( LCUI_Rect *rect, int dx, int dy )
+{
+	ScrollRecord scroll;
+
+	if( !display.is_working || display.mode == LCDM_SEAMLESS ) {
+		return -1;
+	}
+	if( dx == 0 && dy == 0 ) {
+		return 0;
+	}
+	/* 连续平移同一个区域时合并为一次平移 */
+	if( display.scrolls.length > 0 ) {
+		scroll = display.scrolls.tail.prev->data;
+		if( scroll->rect.x == rect->x && scroll->rect.y == rect->y &&
+		    scroll->rect.width == rect->width &&
+		    scroll->rect.height == rect->height ) {
+			scroll->dx += dx;
+			scroll->dy += dy;
+			return 0;
+		}
+	}
+	if( display.scrolls.length >= MAX_SCROLL_RECORDS ) {
+		return -1;
+	}
+	scroll = malloc( sizeof( ScrollRecordRec ) );
+	if( !scroll ) {
+		return -ENOMEM;
+	}
+	scroll->rect = *rect;
+	scroll->dx = dx;
+	scroll->dy = dy;
+	LinkedList_Append( &display.scrolls, scroll );
+	return 0;
 }
 
 static LCUI_Widget LCUIDisplay_GetBindWidget( LCUI_Surface surface )
@@ -262,11 +819,17 @@ static void LCUIDisplay_BindSurface( LCUI_Widget widget )
 		return;
 	}
 	rect = &widget->box.graph;
+	LCUIDisplay_WaitPresent();
 	record = NEW( SurfaceRecordRec, 1 );
 	record->surface = Surface_New();
 	record->widget = widget;
 	record->rendered = FALSE;
-	LinkedList_Init( &record->rects );
+	record->back = 0;
+	Region_Init( &record->rects );
+	Region_Init( &record->damage );
+	Region_Init( &record->present_rects );
+	Graph_Init( &record->buffers[0] );
+	Graph_Init( &record->buffers[1] );
 	Surface_SetCaptionW( record->surface, widget->title );
 	if( widget->style->sheet[key_top].is_valid &&
 	    widget->style->sheet[key_left].is_valid ) {
@@ -288,6 +851,7 @@ static void LCUIDisplay_BindSurface( LCUI_Widget widget )
 static void LCUIDisplay_UnbindSurface( LCUI_Widget widget )
 {
 	LinkedListNode *node;
+	LCUIDisplay_WaitPresent();
 	for( LinkedList_Each( node, &display.surfaces ) ) {
 		SurfaceRecord record = node->data;
 		if( record && record->widget == widget ) {
@@ -363,6 +927,8 @@ int LCUIDisplay_SetMode( int mode )
 {
 	int ret;
 	DEBUG_MSG("mode: %d\n", mode);
+	LCUIDisplay_WaitPresent();
+	LinkedList_Clear( &display.scrolls, free );
 	switch( mode ) {
 	case LCDM_WINDOWED:
 		ret = LCUIDisplay_Windowed();
@@ -384,6 +950,59 @@ int LCUIDisplay_GetMode(void)
 	return display.mode;
 }
 
+void LCUIDisplay_SetRenderThreads( int n )
+{
+	if( n < 1 ) {
+		n = 1;
+	} else if( n > MAX_RENDER_THREADS ) {
+		n = MAX_RENDER_THREADS;
+	}
+	if( !display.is_working ) {
+		display.render.n_threads = n;
+		return;
+	}
+	if( n == display.render.n_threads ) {
+		return;
+	}
+	StopRenderThreads();
+	display.render.n_threads = n;
+	StartRenderThreads();
+}
+
+int LCUIDisplay_GetRenderThreads( void )
+{
+	if( display.render.n_threads < 1 ) {
+		return 1;
+	}
+	return display.render.n_threads;
+}
+
+void LCUIDisplay_SetPipelined( LCUI_BOOL enabled )
+{
+	if( display.pipeline.enabled == enabled ) {
+		return;
+	}
+	if( !display.is_working ) {
+		display.pipeline.enabled = enabled;
+		return;
+	}
+	if( enabled ) {
+		if( !display.driver->can_present_async ) {
+			return;
+		}
+		display.pipeline.enabled = TRUE;
+		StartDisplayThread();
+		return;
+	}
+	StopDisplayThread();
+	display.pipeline.enabled = FALSE;
+}
+
+LCUI_BOOL LCUIDisplay_IsPipelined( void )
+{
+	return display.pipeline.enabled;
+}
+
 void LCUIDisplay_ShowRectBorder(void)
 {
 	display.show_rect_border = TRUE;
@@ -640,6 +1259,8 @@ int LCUIDisplay_BindEvent( int event_id,
 
 int LCUI_InitDisplay( LCUI_DisplayDriver driver )
 {
+	int i;
+	char *env;
 	LCUI_Widget root;
 	if( display.is_working ) {
 		return -1;
@@ -647,17 +1268,45 @@ int LCUI_InitDisplay( LCUI_DisplayDriver driver )
 	LOG( "[display] init ...\n" );
 	display.mode = 0;
 	root = LCUIWidget_GetRoot();
-	LinkedList_Init( &display.rects );
+	Region_Init( &display.rects );
 	LinkedList_Init( &display.surfaces );
+	LinkedList_Init( &display.scrolls );
 	if( !driver ) {
-		driver = LCUI_CreateDisplayDriver();
+		env = getenv( "LCUI_DISPLAY" );
+		if( env && strcmp( env, "headless" ) == 0 ) {
+			driver = LCUI_CreateHeadlessDisplay();
+		} else {
+			driver = LCUI_CreateDisplayDriver();
+		}
 		if( !driver ) {
 			LOG( "[display] init failed\n" );
 			return -2;
 		}
 	}
 	display.driver = driver;
+	if( display.render.n_threads < 1 ) {
+		display.render.n_threads = 1;
+	}
+	for( i = 0; i < MAX_RENDER_THREADS; ++i ) {
+		GraphArena_Init( &display.render.workers[i].arena );
+		Region_Init( &display.render.workers[i].region );
+	}
+	LCUIMutex_Init( &display.render.mutex );
+	LCUICond_Init( &display.render.cond );
+	LCUICond_Init( &display.render.done );
+	LCUIMutex_Init( &display.pipeline.mutex );
+	LCUICond_Init( &display.pipeline.cond );
+	LCUICond_Init( &display.pipeline.done );
+	display.render.task.total = 0;
 	display.is_working = TRUE;
+	StartRenderThreads();
+	/* 呈现需要交给主线程完成的驱动无法从流水线模式中获益 */
+	if( !display.driver->can_present_async ) {
+		display.pipeline.enabled = FALSE;
+	}
+	if( display.pipeline.enabled ) {
+		StartDisplayThread();
+	}
 	display.width = DEFAULT_WIDTH;
 	display.height = DEFAULT_HEIGHT;
 	display.driver->bindEvent( DET_RESIZE, OnResize, NULL, NULL );
@@ -672,11 +1321,27 @@ int LCUI_InitDisplay( LCUI_DisplayDriver driver )
 /** 停用图形输出模块 */
 int LCUI_ExitDisplay( void )
 {
+	int i;
 	if( !display.is_working ) {
 		return -1;
 	}
+	StopRenderThreads();
+	if( display.pipeline.is_running ) {
+		StopDisplayThread();
+	}
 	display.is_working = FALSE;
-	RectList_Clear( &display.rects );
+	Region_Destroy( &display.rects );
+	LinkedList_Clear( &display.scrolls, free );
 	LCUIDisplay_CleanSurfaces();
+	for( i = 0; i < MAX_RENDER_THREADS; ++i ) {
+		GraphArena_Destroy( &display.render.workers[i].arena );
+		Region_Destroy( &display.render.workers[i].region );
+	}
+	LCUICond_Destroy( &display.render.done );
+	LCUICond_Destroy( &display.render.cond );
+	LCUIMutex_Destroy( &display.render.mutex );
+	LCUICond_Destroy( &display.pipeline.done );
+	LCUICond_Destroy( &display.pipeline.cond );
+	LCUIMutex_Destroy( &display.pipeline.mutex );
 	return 0;
 }
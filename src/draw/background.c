@@ -182,8 +182,11 @@ void Graph_DrawBackground( LCUI_PaintContext paint, const LCUI_Rect *box,
 	with_alpha = bg->color.alpha < 255;
 	paint_rect.x -= paint->rect.x;
 	paint_rect.y -= paint->rect.y;
-	Graph_Quote( &graph, &paint->canvas, &paint_rect );
-	Graph_FillRect( &graph, bg->color, NULL, TRUE );
+	/* 透明的背景色不会改变画布内容，无需填充 */
+	if( bg->color.alpha > 0 ) {
+		Graph_Quote( &graph, &paint->canvas, &paint_rect );
+		Graph_FillRect( &graph, bg->color, NULL, TRUE );
+	}
 	/* 将坐标转换为相对于背景内容框 */
 	paint_rect.x += paint->rect.x - box->x;
 	paint_rect.y += paint->rect.y - box->y;
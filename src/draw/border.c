@@ -161,7 +161,7 @@ static int Graph_DrawRoundBorderLeftTop( LCUI_Graph *dst, LCUI_Pos center,
 		/* 加上圆与背景图的左边距 */
 		bound_px += (center.x - radius);
 		for( ; px < bound_px; ++px ) {
-			px->alpha = 0;
+			px->value = 0;
 		}
 		/* 计算需要向右填充的像素点的个数n */
 		n = radius - x + width;
@@ -236,7 +236,7 @@ static int Graph_DrawRoundBorderTopLeft( LCUI_Graph *dst, LCUI_Pos center,
 		n += (center.y - radius);
 		bound_px = px - n * dst->width;
 		for( ; px > bound_px; px -= dst->width ) {
-			px->alpha = 0;
+			px->value = 0;
 		}
 		/* 计算需要向下填充的像素点的个数n */
 		n = radius - y + width;
@@ -299,7 +299,7 @@ static int Graph_DrawRoundBorderRightTop( LCUI_Graph *dst, LCUI_Pos center,
 			px = center_px + x;
 		}
 		for( ++px; px <= bound_px; ++px ) {
-			px->alpha = 0;
+			px->value = 0;
 		}
 		/* 计算需要向左填充的像素点的个数n */
 		n = radius + x - width;
@@ -361,7 +361,7 @@ static int Graph_DrawRoundBorderTopRight( LCUI_Graph *dst, LCUI_Pos center,
 		n += (center.y - radius);
 		bound_px = px - n * dst->width;
 		for( ; px > bound_px; px -= dst->width ) {
-			px->alpha = 0;
+			px->value = 0;
 		}
 		n = radius - y + width;
 		n = n > radius ? y : width;
@@ -420,7 +420,7 @@ static int Graph_DrawRoundBorderLeftBottom( LCUI_Graph *dst, LCUI_Pos center,
 		n += (center.x - radius);
 		bound_px = px + n;
 		for( ; px < bound_px; ++px ) {
-			px->alpha = 0;
+			px->value = 0;
 		}
 		n = radius - x + width;
 		n = n > radius ? x : width;
@@ -484,7 +484,7 @@ static int Graph_DrawRoundBorderBottomLeft( LCUI_Graph *dst, LCUI_Pos center,
 		n += (rect.height - center.y - radius);
 		bound_px = px + n * dst->width;
 		for( px += dst->width; px < bound_px; px += dst->width ) {
-			px->alpha = 0;
+			px->value = 0;
 		}
 		/* 计算需要向上填充的像素点的个数n */
 		n = radius + y - width;
@@ -544,7 +544,7 @@ static int Graph_DrawRoundBorderRightBottom( LCUI_Graph *dst, LCUI_Pos center,
 		}
 		bound_px = center_px + bound.right - radius;
 		for( ++px; px < bound_px; ++px ) {
-			px->alpha = 0;
+			px->value = 0;
 		}
 		n = radius + x - width;
 		n = n < bound.left ? x + radius - bound.left : width;
@@ -603,7 +603,7 @@ static int Graph_DrawRoundBorderBottomRight( LCUI_Graph *dst, LCUI_Pos center,
 		n += (rect.height - center.y - radius);
 		bound_px = px + n * dst->width;
 		for( px += dst->width; px < bound_px; px += dst->width ) {
-			px->alpha = 0;
+			px->value = 0;
 		}
 		n = radius + y - width;
 		n = n < radius ? y : width;
@@ -628,12 +628,25 @@ int Graph_DrawBorder( LCUI_PaintContext paint,
 		      LCUI_Rect *box, LCUI_Border *border )
 {
 	LCUI_Pos pos;
-	LCUI_Graph canvas;
+	LCUI_Graph canvas, *graph;
 	LCUI_Rect bound, rect;
+	LCUI_Color left, top, right, bottom;
 
 	if( !Graph_IsValid(&paint->canvas) ) {
 		return -1;
 	}
+	left = border->left.color;
+	top = border->top.color;
+	right = border->right.color;
+	bottom = border->bottom.color;
+	/* 圆角边框是直接写像素的，预乘 alpha 的画布需要预乘后的颜色 */
+	graph = Graph_GetQuote( &paint->canvas );
+	if( graph->color_type == COLOR_TYPE_PARGB ) {
+		PIXEL_PREMULTIPLY( &left );
+		PIXEL_PREMULTIPLY( &top );
+		PIXEL_PREMULTIPLY( &right );
+		PIXEL_PREMULTIPLY( &bottom );
+	}
 	/* 左上角的圆角 */
 	bound.x = box->x;
 	bound.y = box->y;
@@ -650,11 +663,11 @@ int Graph_DrawBorder( LCUI_PaintContext paint,
 		Graph_DrawRoundBorderLeftTop( &canvas, pos,
 					      border->top_left_radius,
 					      border->left.width,
-					      border->left.color );
+					      left );
 		Graph_DrawRoundBorderTopLeft( &canvas, pos,
 					      border->top_left_radius,
 					      border->top.width,
-					      border->top.color );
+					      top );
 	}
 	/* 右上角的圆角 */
 	bound.y = box->y;
@@ -672,11 +685,11 @@ int Graph_DrawBorder( LCUI_PaintContext paint,
 		Graph_DrawRoundBorderRightTop( &canvas, pos,
 					       border->top_right_radius,
 					       border->right.width,
-					       border->right.color );
+					       right );
 		Graph_DrawRoundBorderTopRight( &canvas, pos,
 					       border->top_right_radius,
 					       border->top.width,
-					       border->top.color );
+					       top );
 	}
 	/* 左下角的圆角 */
 	bound.x = box->x;
@@ -696,11 +709,11 @@ int Graph_DrawBorder( LCUI_PaintContext paint,
 		Graph_DrawRoundBorderLeftBottom( &canvas, pos,
 						 border->bottom_left_radius,
 						 border->left.width,
-						 border->left.color );
+						 left );
 		Graph_DrawRoundBorderBottomLeft( &canvas, pos,
 						 border->bottom_left_radius,
 						 border->bottom.width,
-						 border->bottom.color );
+						 bottom );
 	}
 	/* 右下角的圆角 */
 	bound.width = border->bottom_left_radius;
@@ -717,11 +730,11 @@ int Graph_DrawBorder( LCUI_PaintContext paint,
 		Graph_DrawRoundBorderRightBottom( &canvas, pos,
 						 border->bottom_right_radius,
 						 border->right.width,
-						 border->right.color );
+						 right );
 		Graph_DrawRoundBorderBottomRight( &canvas, pos,
 						 border->bottom_right_radius,
 						 border->bottom.width,
-						 border->bottom.color );
+						 bottom );
 	}
 	/* 绘制上边框线 */
 	bound.x = box->x + border->top_left_radius;
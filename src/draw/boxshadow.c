@@ -196,7 +196,7 @@ static void DrawCircle( LCUI_Graph *graph, LCUI_Pos center,
 	if( circle.bottom > area.y + area.height ) {
 		circle.bottom = area.y + area.height;
 	}
-	if( src->color_type != COLOR_TYPE_ARGB ) {
+	if( !ColorType_IsARGB( src->color_type ) ) {
 		return;
 	}
 	px_row_bytes = src->bytes + circle.top*src->bytes_per_row;
@@ -214,30 +214,45 @@ static void DrawCircle( LCUI_Graph *graph, LCUI_Pos center,
 			} else {
 				tmp_px.alpha = 0;
 			}
-			*px++ = tmp_px;
+			*px = tmp_px;
+			if( src->color_type == COLOR_TYPE_PARGB ) {
+				PIXEL_PREMULTIPLY( px );
+			}
+			++px;
 		}
 		px_row_bytes += src->bytes_per_row;
 	}
 }
 
+static void DrawCornerShadow( LCUI_PaintContext paint, LCUI_Rect *bound,
+			      LCUI_Pos center, LCUI_BoxShadow *shadow )
+{
+	LCUI_Rect rect;
+	LCUI_Graph canvas;
+	if( !LCUIRect_GetOverlayRect( bound, &paint->rect, &rect ) ) {
+		return;
+	}
+	/* 圆心和半径按未裁剪的区域计算，保证分区域绘制的结果一致 */
+	center.x -= rect.x;
+	center.y -= rect.y;
+	rect.x -= paint->rect.x;
+	rect.y -= paint->rect.y;
+	Graph_Init( &canvas );
+	Graph_Quote( &canvas, &paint->canvas, &rect );
+	DrawCircle( &canvas, center, BLUR_WIDTH( shadow ), shadow->color );
+}
+
 static void Graph_DrawTopLeftShadow( LCUI_PaintContext paint, LCUI_Rect *box, 
 				     LCUI_BoxShadow *shadow)
 {
 	LCUI_Pos pos;
 	LCUI_Rect bound;
-	LCUI_Graph canvas;
 	bound.width = bound.height = BLUR_WIDTH(shadow);
 	bound.x = box->x + BoxShadow_GetX( shadow );
 	bound.y = box->y + BoxShadow_GetY( shadow );
-	if( LCUIRect_GetOverlayRect( &bound, &paint->rect, &bound ) ) {
-		Graph_Init( &canvas );
-		bound.x -= paint->rect.x;
-		bound.y -= paint->rect.y;
-		pos.x = bound.x + BLUR_WIDTH( shadow );
-		pos.y = bound.y + BLUR_WIDTH( shadow );
-		Graph_Quote( &canvas, &paint->canvas, &bound );
-		DrawCircle( &canvas, pos, bound.width, shadow->color );
-	}
+	pos.x = bound.x + BLUR_WIDTH( shadow );
+	pos.y = bound.y + BLUR_WIDTH( shadow );
+	DrawCornerShadow( paint, &bound, pos, shadow );
 }
 
 static void Graph_DrawTopRightShadow( LCUI_PaintContext paint, LCUI_Rect *box,
@@ -245,21 +260,14 @@ static void Graph_DrawTopRightShadow( LCUI_PaintContext paint, LCUI_Rect *box,
 {
 	LCUI_Pos pos;
 	LCUI_Rect bound;
-	LCUI_Graph canvas;
-	pos.x = 0;
-	pos.y = BLUR_WIDTH( shadow );
 	bound.width = bound.height = BLUR_WIDTH( shadow );
 	bound.y = box->y + BoxShadow_GetY( shadow );
 	bound.x = box->x + BoxShadow_GetX( shadow );
 	bound.x += BoxShadow_GetBoxWidth( shadow, box->width );
 	bound.x += BLUR_WIDTH( shadow ) + INNER_SHADOW_WIDTH( shadow ) * 2;
-	if( LCUIRect_GetOverlayRect( &bound, &paint->rect, &bound ) ) {
-		Graph_Init( &canvas );
-		bound.x -= paint->rect.x;
-		bound.y -= paint->rect.y;
-		Graph_Quote( &canvas, &paint->canvas, &bound );
-		DrawCircle( &canvas, pos, bound.width, shadow->color );
-	}
+	pos.x = bound.x;
+	pos.y = bound.y + BLUR_WIDTH( shadow );
+	DrawCornerShadow( paint, &bound, pos, shadow );
 }
 
 static void Graph_DrawBottomLeftShadow( LCUI_PaintContext paint, LCUI_Rect *box,
@@ -267,20 +275,14 @@ static void Graph_DrawBottomLeftShadow( LCUI_PaintContext paint, LCUI_Rect *box,
 {
 	LCUI_Pos pos;
 	LCUI_Rect bound;
-	LCUI_Graph canvas;
-
-	pos.y = 0;
 	bound.x = box->x + BoxShadow_GetX( shadow );
-	pos.x = bound.width = bound.height = BLUR_WIDTH( shadow );
+	bound.width = bound.height = BLUR_WIDTH( shadow );
 	bound.y = box->y + BoxShadow_GetY( shadow );
 	bound.y += BoxShadow_GetBoxHeight( shadow, box->height );
 	bound.y += INNER_SHADOW_WIDTH( shadow ) * 2 + BLUR_WIDTH( shadow );
-	if( LCUIRect_GetOverlayRect( &bound, &paint->rect, &bound ) ) {
-		bound.x -= paint->rect.x;
-		bound.y -= paint->rect.y;
-		Graph_Quote( &canvas, &paint->canvas, &bound );
-		DrawCircle( &canvas, pos, bound.width, shadow->color );
-	}
+	pos.x = bound.x + BLUR_WIDTH( shadow );
+	pos.y = bound.y;
+	DrawCornerShadow( paint, &bound, pos, shadow );
 }
 
 static void Graph_DrawBottomRightShadow( LCUI_PaintContext paint, LCUI_Rect *box,
@@ -288,8 +290,6 @@ static void Graph_DrawBottomRightShadow( LCUI_PaintContext paint, LCUI_Rect *box
 {
 	LCUI_Pos pos;
 	LCUI_Rect bound;
-	LCUI_Graph canvas;
-	pos.x = pos.y = 0;
 	bound.x = BoxShadow_GetX( shadow ) + BLUR_WIDTH(shadow);
 	bound.x += BoxShadow_GetBoxWidth( shadow, box->width );
 	bound.x += INNER_SHADOW_WIDTH(shadow)*2;
@@ -299,12 +299,9 @@ static void Graph_DrawBottomRightShadow( LCUI_PaintContext paint, LCUI_Rect *box
 	bound.width = bound.height = BLUR_WIDTH(shadow);
 	bound.x += box->x;
 	bound.y += box->y;
-	if( LCUIRect_GetOverlayRect( &bound, &paint->rect, &bound ) ) {
-		bound.x -= paint->rect.x;
-		bound.y -= paint->rect.y;
-		Graph_Quote( &canvas, &paint->canvas, &bound );
-		DrawCircle( &canvas, pos, bound.width, shadow->color );
-	}
+	pos.x = bound.x;
+	pos.y = bound.y;
+	DrawCornerShadow( paint, &bound, pos, shadow );
 }
 
 /**
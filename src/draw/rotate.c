@@ -97,7 +97,7 @@ LCUI_API int Graph_Rotate( LCUI_Graph *src, int rotate_angle, LCUI_Graph *des )
 			// 判断是否在源图范围内   
 			if( (src_x >= 0) && (src_x < width) 
 			&& (src_y >= 0) && (src_y < height)) {
-				if( src->color_type == COLOR_TYPE_ARGB ) {
+				if( ColorType_IsARGB( src->color_type ) ) {
 					pSrcByte = src->bytes + (width*src_y + src_x)*4;
 					*pDesByte++ = *pSrcByte++;
 					*pDesByte++ = *pSrcByte++;
@@ -109,6 +109,12 @@ LCUI_API int Graph_Rotate( LCUI_Graph *src, int rotate_angle, LCUI_Graph *des )
 					*pDesByte++ = *pSrcByte++;
 					*pDesByte++ = *pSrcByte++;
 				}
+			} else if( src->color_type == COLOR_TYPE_PARGB ) {
+				// 预乘 alpha 的透明像素的颜色值都是0
+				*pDesByte++ = 0;
+				*pDesByte++ = 0;
+				*pDesByte++ = 0;
+				*pDesByte++ = 0;
 			} else {
 				// 对于源图中没有的象素，直接赋值为255
 				*pDesByte++ = 255;
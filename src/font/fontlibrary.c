@@ -44,6 +44,7 @@
 #include <LCUI/LCUI.h>
 #include <LCUI/graph.h>
 #include <LCUI/font.h>
+#include <LCUI/trace.h>
 
 #define FONT_CACHE_SIZE	32
 
@@ -454,6 +455,39 @@ static void FontBitmap_MixARGB( LCUI_Graph *graph, LCUI_Rect *write_rect,
 	}
 }
 
+/** 将字体位图混合到预乘 alpha 的图像上，每个分量只需一次乘加运算 */
+static void FontBitmap_MixPARGB( LCUI_Graph *graph, LCUI_Rect *write_rect,
+				 const LCUI_FontBitmap *bmp, LCUI_Color color,
+				 LCUI_Rect *read_rect )
+{
+	int x, y;
+	unsigned int a, ia;
+	LCUI_ARGB *px, *px_row_des;
+	uchar_t *byte_ptr, *byte_row_ptr;
+	byte_row_ptr = bmp->buffer + read_rect->y * bmp->width;
+	px_row_des = graph->argb + write_rect->y * graph->width;
+	byte_row_ptr += read_rect->x;
+	px_row_des += write_rect->x;
+	for( y = 0; y < read_rect->height; ++y ) {
+		px = px_row_des;
+		byte_ptr = byte_row_ptr;
+		for( x = 0; x < read_rect->width; ++x, ++byte_ptr, ++px ) {
+			a = *byte_ptr * color.alpha;
+			if( a == 0 ) {
+				continue;
+			}
+			/* a 和 ia 均以 255 * 255 为单位 1 */
+			ia = 65025 - a;
+			px->r = (color.r * a + px->r * ia + 32512) / 65025;
+			px->g = (color.g * a + px->g * ia + 32512) / 65025;
+			px->b = (color.b * a + px->b * ia + 32512) / 65025;
+			px->a = (255 * a + px->a * ia + 32512) / 65025;
+		}
+		px_row_des += graph->width;
+		byte_row_ptr += bmp->width;
+	}
+}
+
 static void FontBitmap_MixRGB( LCUI_Graph *graph, LCUI_Rect *write_rect,
 			       const LCUI_FontBitmap *bmp, LCUI_Color color,
 			       LCUI_Rect *read_rect )
@@ -505,7 +539,9 @@ int FontBitmap_Mix( LCUI_Graph *graph, LCUI_Pos pos,
 	Graph_GetValidRect( &write_slot, &w_rect );
 	/* 获取背景图引用的源图形 */
 	graph = Graph_GetQuote( graph );
-	if( graph->color_type == COLOR_TYPE_ARGB ) {
+	if( graph->color_type == COLOR_TYPE_PARGB ) {
+		FontBitmap_MixPARGB( graph, &w_rect, bmp, color, &r_rect );
+	} else if( graph->color_type == COLOR_TYPE_ARGB ) {
 		FontBitmap_MixARGB( graph, &w_rect, bmp, color, &r_rect );
 	} else {
 		FontBitmap_MixRGB( graph, &w_rect, bmp, color, &r_rect );
@@ -517,6 +553,7 @@ int FontBitmap_Mix( LCUI_Graph *graph, LCUI_Pos pos,
 int FontBitmap_Load( LCUI_FontBitmap *buff, wchar_t ch,
 		     int font_id, int pixel_size )
 {
+	int ret;
 	LCUI_Font *info = fontlib.default_font;
 	while( 1 ) {
 		if( font_id < 0 || !fontlib.engine ) {
@@ -536,7 +573,10 @@ int FontBitmap_Load( LCUI_FontBitmap *buff, wchar_t ch,
 	if( !info ) {
 		return -1;
 	}
-	return info->engine->render( buff, ch, pixel_size, info );
+	LCUITrace_Begin( "font", "rasterize" );
+	ret = info->engine->render( buff, ch, pixel_size, info );
+	LCUITrace_End( "font", "rasterize" );
+	return ret;
 }
 
 /** 初始化字体处理模块 */
@@ -42,6 +42,7 @@
 #include <LCUI/LCUI.h>
 #include <LCUI/graph.h>
 #include <LCUI/font.h>
+#include <LCUI/trace.h>
 
  /** 文本添加类型 */
 enum TextAddType {
@@ -331,7 +332,7 @@ LCUI_TextLayer TextLayer_New(void)
 	layer->task.redraw_all = 0;
 	Graph_Init( &layer->graph );
 	LinkedList_Init( &layer->dirty_rect );
-	layer->graph.color_type = COLOR_TYPE_ARGB;
+	layer->graph.color_type = COLOR_TYPE_PARGB;
 	TextRowList_InsertNewRow( &layer->rowlist, 0 );
 	return layer;
 }
@@ -1193,6 +1194,7 @@ void TextLayer_ReloadCharBitmap( LCUI_TextLayer layer )
 
 void TextLayer_Update( LCUI_TextLayer layer, LinkedList *rects )
 {
+	LCUITrace_Begin( "text", "TextLayer_Update" );
 	if( layer->task.update_bitmap ) {
 		TextLayer_InvalidateRowsRect( layer, 0, -1 );
 		TextLayer_ReloadCharBitmap( layer );
@@ -1218,6 +1220,7 @@ void TextLayer_Update( LCUI_TextLayer layer, LinkedList *rects )
 	if( rects ) {
 		LinkedList_Concat( rects, &layer->dirty_rect );
 	 }
+	LCUITrace_End( "text", "TextLayer_Update" );
 }
 
 int TextLayer_DrawToGraph( LCUI_TextLayer layer, LCUI_Rect area,
@@ -0,0 +1,273 @@
+/* ***************************************************************************
+ * framestats.c -- frame timing statistics of the main loop.
+ *
+ * Copyright (C) 2017 by Liu Chao <lc-soft@live.cn>
+ *
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ *
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ *
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *
+ * The LCUI project is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ *
+ * You should have received a copy of the GPLv2 along with this file. It is
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+/* ****************************************************************************
+ * framestats.c -- 主循环的帧耗时统计
+ *
+ * 版权所有 (C) 2017 归属于 刘超 <lc-soft@live.cn>
+ *
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ *
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ *
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
+#include <LCUI/framestats.h>
+
+/**
+ * 耗时直方图的桶
+ * 小于 16 微秒的值每微秒一个桶，之后每个 2 的幂区间平分为 8 个桶，所以用桶的
+ * 中值估算的结果相对误差不超过 1/8，最多统计到 2^31 微秒
+ */
+#define HIST_LINEAR	16
+#define HIST_SUB_BITS	3
+#define HIST_SUB	(1 << HIST_SUB_BITS)
+#define HIST_SIZE	(HIST_LINEAR + (31 - 4) * HIST_SUB)
+
+typedef struct HistogramRec_ {
+	unsigned long total;
+	int64_t max;
+	unsigned long buckets[HIST_SIZE];
+} HistogramRec, *Histogram;
+
+static struct LCUI_FrameStatsModule {
+	LCUI_BOOL enabled;
+	LCUI_BOOL in_frame;
+	int64_t mark_time;		/**< 上一个标记的时间 */
+	int64_t render_time;		/**< 上一个 surface 渲染完的时间 */
+	LCUI_FrameRecordRec current;	/**< 当前帧的记录 */
+	unsigned long total_frames;
+	size_t length;
+	size_t next;			/**< 下一条记录在环形缓冲中的位置 */
+	LCUI_FrameRecordRec frames[LCUI_FRAME_STATS_SIZE];
+	HistogramRec frame_hist;
+	HistogramRec phase_hists[LCUI_FPHASE_TOTAL_NUM];
+	LCUI_Mutex mutex;
+	LCUI_BOOL mutex_ready;
+} self;
+
+static int Histogram_GetIndex( int64_t value )
+{
+	int exp = 4;
+	if( value < HIST_LINEAR ) {
+		return value < 0 ? 0 : (int)value;
+	}
+	if( value >= ((int64_t)1 << 31) ) {
+		return HIST_SIZE - 1;
+	}
+	while( (value >> (exp + 1)) > 0 ) {
+		++exp;
+	}
+	return HIST_LINEAR + (exp - 4) * HIST_SUB +
+		(int)((value >> (exp - HIST_SUB_BITS)) & (HIST_SUB - 1));
+}
+
+/** 获取桶的中值 */
+static int64_t Histogram_GetValue( int index )
+{
+	int exp;
+	int64_t width;
+	if( index < HIST_LINEAR ) {
+		return index;
+	}
+	index -= HIST_LINEAR;
+	exp = 4 + index / HIST_SUB;
+	width = (int64_t)1 << (exp - HIST_SUB_BITS);
+	return ((int64_t)1 << exp) + (index % HIST_SUB) * width + width / 2;
+}
+
+static void Histogram_Add( Histogram hist, int64_t value )
+{
+	hist->buckets[Histogram_GetIndex( value )] += 1;
+	hist->total += 1;
+	if( value > hist->max ) {
+		hist->max = value;
+	}
+}
+
+static void Histogram_GetPercentiles( Histogram hist,
+				      LCUI_FramePercentiles out )
+{
+	int i, j;
+	unsigned long count = 0;
+	const int percents[3] = { 50, 95, 99 };
+	int64_t *values[3];
+	values[0] = &out->p50;
+	values[1] = &out->p95;
+	values[2] = &out->p99;
+	out->p50 = out->p95 = out->p99 = 0;
+	out->max = hist->max;
+	if( hist->total == 0 ) {
+		return;
+	}
+	for( i = 0, j = 0; i < HIST_SIZE && j < 3; ++i ) {
+		count += hist->buckets[i];
+		/* count / total >= percent / 100 */
+		while( j < 3 && count * 100 >= hist->total * percents[j] ) {
+			*values[j] = Histogram_GetValue( i );
+			if( *values[j] > hist->max ) {
+				*values[j] = hist->max;
+			}
+			++j;
+		}
+	}
+}
+
+void LCUIFrameStats_Reset( void )
+{
+	if( !self.mutex_ready ) {
+		LCUIMutex_Init( &self.mutex );
+		self.mutex_ready = TRUE;
+	}
+	LCUIMutex_Lock( &self.mutex );
+	self.length = 0;
+	self.next = 0;
+	self.total_frames = 0;
+	memset( &self.frame_hist, 0, sizeof( self.frame_hist ) );
+	memset( self.phase_hists, 0, sizeof( self.phase_hists ) );
+	LCUIMutex_Unlock( &self.mutex );
+}
+
+void LCUIFrameStats_Enable( LCUI_BOOL enabled )
+{
+	if( enabled && !self.enabled ) {
+		LCUIFrameStats_Reset();
+		self.in_frame = FALSE;
+	}
+	self.enabled = enabled;
+}
+
+LCUI_BOOL LCUIFrameStats_IsEnabled( void )
+{
+	return self.enabled;
+}
+
+void LCUIFrameStats_BeginFrame( void )
+{
+	if( !self.enabled ) {
+		return;
+	}
+	memset( &self.current, 0, sizeof( self.current ) );
+	self.mark_time = LCUI_GetTimeUS();
+	self.current.start_time = self.mark_time;
+	self.render_time = 0;
+	self.in_frame = TRUE;
+}
+
+void LCUIFrameStats_EndPhase( LCUI_FramePhase phase )
+{
+	int64_t now;
+	if( !self.enabled || !self.in_frame ) {
+		return;
+	}
+	now = LCUI_GetTimeUS();
+	self.current.phases[phase] += now - self.mark_time;
+	self.mark_time = now;
+}
+
+void LCUIFrameStats_AddRender( LCUI_Surface surface, LCUI_Region region )
+{
+	int i;
+	int64_t now, pixels = 0;
+	LCUI_SurfaceRenderRecord render;
+	if( !self.enabled || !self.in_frame ) {
+		return;
+	}
+	now = LCUI_GetTimeUS();
+	for( i = 0; i < region->length; ++i ) {
+		pixels += (int64_t)region->rects[i].width *
+			region->rects[i].height;
+	}
+	if( self.current.surfaces < LCUI_FRAME_STATS_SURFACES ) {
+		render = &self.current.renders[self.current.surfaces];
+		render->surface = surface;
+		render->rects = region->length;
+		render->pixels = pixels;
+		if( self.render_time > self.mark_time ) {
+			render->duration = now - self.render_time;
+		} else {
+			render->duration = now - self.mark_time;
+		}
+	}
+	self.render_time = now;
+	self.current.surfaces += 1;
+	self.current.rects += region->length;
+	self.current.pixels += pixels;
+}
+
+void LCUIFrameStats_EndFrame( void )
+{
+	int i;
+	LCUI_FrameRecord record = &self.current;
+	if( !self.enabled || !self.in_frame ) {
+		return;
+	}
+	self.in_frame = FALSE;
+	record->duration = LCUI_GetTimeUS() - record->start_time;
+	LCUIMutex_Lock( &self.mutex );
+	record->id = self.total_frames++;
+	self.frames[self.next] = *record;
+	self.next = (self.next + 1) % LCUI_FRAME_STATS_SIZE;
+	if( self.length < LCUI_FRAME_STATS_SIZE ) {
+		self.length += 1;
+	}
+	Histogram_Add( &self.frame_hist, record->duration );
+	for( i = 0; i < LCUI_FPHASE_TOTAL_NUM; ++i ) {
+		Histogram_Add( &self.phase_hists[i], record->phases[i] );
+	}
+	LCUIMutex_Unlock( &self.mutex );
+}
+
+int LCUI_GetFrameStats( LCUI_FrameStats stats )
+{
+	size_t i, start;
+	if( !self.enabled ) {
+		return -1;
+	}
+	LCUIMutex_Lock( &self.mutex );
+	stats->length = self.length;
+	stats->total_frames = self.total_frames;
+	start = (self.next + LCUI_FRAME_STATS_SIZE - self.length) %
+		LCUI_FRAME_STATS_SIZE;
+	for( i = 0; i < self.length; ++i ) {
+		stats->frames[i] =
+			self.frames[(start + i) % LCUI_FRAME_STATS_SIZE];
+	}
+	Histogram_GetPercentiles( &self.frame_hist, &stats->frame );
+	for( i = 0; i < LCUI_FPHASE_TOTAL_NUM; ++i ) {
+		Histogram_GetPercentiles( &self.phase_hists[i],
+					  &stats->phases[i] );
+	}
+	LCUIMutex_Unlock( &self.mutex );
+	return 0;
+}
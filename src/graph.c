@@ -56,7 +56,7 @@ void Graph_PrintInfo( LCUI_Graph *graph )
 	LOG( "width:%d, ", graph->width );
 	LOG( "height:%d, ", graph->height );
 	LOG( "opacity:%.2f, ", graph->opacity );
-	LOG( "%s\n", graph->color_type == COLOR_TYPE_ARGB ? "RGBA" : "RGB" );
+	LOG( "%s\n", Graph_HasAlpha( graph ) ? "RGBA" : "RGB" );
 	if( graph->quote.is_valid ) {
 		LOG( "graph src:" );
 		Graph_PrintInfo( Graph_GetQuote( graph ) );
@@ -127,6 +127,7 @@ static size_t get_pixel_size( int color_type )
 	case COLOR_TYPE_RGB888:
 		return 3;
 	case COLOR_TYPE_ARGB8888:
+	case COLOR_TYPE_PARGB8888:
 	default:break;
 	}
 	return 4;
@@ -153,7 +154,7 @@ static void Pixels_ARGBFormatToRGB( const uchar_t *in_pixels,
 		p_out_px = (LCUI_ARGB8888*)(((uchar_t*)p_out_px) + 3);
 	}
 	/* 最后一个像素，以逐个字节的形式写数据 */
-	p_out_byte = (uchar_t*)(p_out_px + 1);
+	p_out_byte = (uchar_t*)p_out_px;
 	*p_out_byte++ = p_px->blue;
 	*p_out_byte++ = p_px->green;
 	*p_out_byte++ = p_px->red;
@@ -178,6 +179,108 @@ static void Pixels_RGBFormatToARGB( const uchar_t *in_pixels,
 	}
 }
 
+/** 还原预乘 alpha 的像素的颜色值 */
+static void Pixel_Unpremultiply( LCUI_ARGB *px )
+{
+	unsigned int a = px->a;
+	if( a == 255 ) {
+		return;
+	}
+	if( a == 0 ) {
+		px->value = 0;
+		return;
+	}
+	px->r = (uchar_t)(px->r >= a ? 255 : (px->r * 255 + a / 2) / a);
+	px->g = (uchar_t)(px->g >= a ? 255 : (px->g * 255 + a / 2) / a);
+	px->b = (uchar_t)(px->b >= a ? 255 : (px->b * 255 + a / 2) / a);
+}
+
+static void Pixels_ARGBFormatToPARGB( const uchar_t *in_pixels,
+				      uchar_t *out_pixels,
+				      size_t pixel_count )
+{
+	const LCUI_ARGB *p_px, *p_end_px;
+	LCUI_ARGB *p_out_px;
+
+	p_px = (const LCUI_ARGB*)in_pixels;
+	p_out_px = (LCUI_ARGB*)out_pixels;
+	p_end_px = p_px + pixel_count;
+	for( ; p_px < p_end_px; ++p_px, ++p_out_px ) {
+		*p_out_px = *p_px;
+		PIXEL_PREMULTIPLY( p_out_px );
+	}
+}
+
+static void Pixels_PARGBFormatToARGB( const uchar_t *in_pixels,
+				      uchar_t *out_pixels,
+				      size_t pixel_count )
+{
+	const LCUI_ARGB *p_px, *p_end_px;
+	LCUI_ARGB *p_out_px;
+
+	p_px = (const LCUI_ARGB*)in_pixels;
+	p_out_px = (LCUI_ARGB*)out_pixels;
+	p_end_px = p_px + pixel_count;
+	for( ; p_px < p_end_px; ++p_px, ++p_out_px ) {
+		*p_out_px = *p_px;
+		Pixel_Unpremultiply( p_out_px );
+	}
+}
+
+static void Pixels_PARGBFormatToRGB( const uchar_t *in_pixels,
+				     uchar_t *out_pixels,
+				     size_t pixel_count )
+{
+	LCUI_ARGB px;
+	const LCUI_ARGB *p_px, *p_end_px;
+	uchar_t *p_out_byte = out_pixels;
+
+	p_px = (const LCUI_ARGB*)in_pixels;
+	p_end_px = p_px + pixel_count;
+	for( ; p_px < p_end_px; ++p_px ) {
+		px = *p_px;
+		Pixel_Unpremultiply( &px );
+		*p_out_byte++ = px.blue;
+		*p_out_byte++ = px.green;
+		*p_out_byte++ = px.red;
+	}
+}
+
+static void Pixels_ARGBFormatToRGB565( const uchar_t *in_pixels,
+				       uchar_t *out_pixels,
+				       size_t pixel_count )
+{
+	const LCUI_ARGB *p_px, *p_end_px;
+	uint16_t *p_out_px = (uint16_t*)out_pixels;
+
+	p_px = (const LCUI_ARGB*)in_pixels;
+	p_end_px = p_px + pixel_count;
+	for( ; p_px < p_end_px; ++p_px ) {
+		*p_out_px++ = (uint16_t)(((p_px->r & 0xf8) << 8) |
+					 ((p_px->g & 0xfc) << 3) |
+					 (p_px->b >> 3));
+	}
+}
+
+static void Pixels_PARGBFormatToRGB565( const uchar_t *in_pixels,
+					uchar_t *out_pixels,
+					size_t pixel_count )
+{
+	LCUI_ARGB px;
+	const LCUI_ARGB *p_px, *p_end_px;
+	uint16_t *p_out_px = (uint16_t*)out_pixels;
+
+	p_px = (const LCUI_ARGB*)in_pixels;
+	p_end_px = p_px + pixel_count;
+	for( ; p_px < p_end_px; ++p_px ) {
+		px = *p_px;
+		Pixel_Unpremultiply( &px );
+		*p_out_px++ = (uint16_t)(((px.r & 0xf8) << 8) |
+					 ((px.g & 0xfc) << 3) |
+					 (px.b >> 3));
+	}
+}
+
 void PixelsFormat( const uchar_t *in_pixels, int in_color_type,
 		   uchar_t *out_pixels, int out_color_type,
 		   size_t pixel_count )
@@ -187,8 +290,34 @@ void PixelsFormat( const uchar_t *in_pixels, int in_color_type,
 		if( out_color_type == COLOR_TYPE_ARGB8888 ) {
 			return;
 		}
+		if( out_color_type == COLOR_TYPE_PARGB8888 ) {
+			Pixels_ARGBFormatToPARGB( in_pixels, out_pixels,
+						  pixel_count );
+			break;
+		}
+		if( out_color_type == COLOR_TYPE_RGB565 ) {
+			Pixels_ARGBFormatToRGB565( in_pixels, out_pixels,
+						   pixel_count );
+			break;
+		}
 		Pixels_ARGBFormatToRGB( in_pixels, out_pixels, pixel_count );
 		break;
+	case COLOR_TYPE_PARGB8888:
+		if( out_color_type == COLOR_TYPE_PARGB8888 ) {
+			return;
+		}
+		if( out_color_type == COLOR_TYPE_ARGB8888 ) {
+			Pixels_PARGBFormatToARGB( in_pixels, out_pixels,
+						  pixel_count );
+			break;
+		}
+		if( out_color_type == COLOR_TYPE_RGB565 ) {
+			Pixels_PARGBFormatToRGB565( in_pixels, out_pixels,
+						    pixel_count );
+			break;
+		}
+		Pixels_PARGBFormatToRGB( in_pixels, out_pixels, pixel_count );
+		break;
 	case COLOR_TYPE_RGB888:
 		if( out_color_type == COLOR_TYPE_RGB888 ) {
 			return;
@@ -199,7 +328,7 @@ void PixelsFormat( const uchar_t *in_pixels, int in_color_type,
 	}
 }
 
-static int Graph_RGBToARGB( LCUI_Graph *graph )
+static int Graph_RGBToARGB( LCUI_Graph *graph, int color_type )
 {
 	int x, y;
 	LCUI_ARGB *px_des, *px_row_des, *buffer;
@@ -227,7 +356,10 @@ static int Graph_RGBToARGB( LCUI_Graph *graph )
 	}
 	free( graph->argb );
 	graph->argb = buffer;
-	graph->color_type = COLOR_TYPE_ARGB8888;
+	/* 不透明的像素在预乘前后是一样的，无需再转换 */
+	graph->color_type = color_type;
+	graph->bytes_per_pixel = 4;
+	graph->bytes_per_row = graph->width * 4;
 	return 0;
 }
 
@@ -253,8 +385,9 @@ static int Graph_CutRGB( const LCUI_Graph *graph, LCUI_Rect rect,
 	return 0;
 }
 
-static void Graph_ARGBReplaceRGB( LCUI_Graph *des, LCUI_Rect des_rect,
-				  const LCUI_Graph *src, int src_x, int src_y )
+/** 将前景图的像素转换成背景图的像素格式，然后覆盖至背景图上 */
+static void Graph_FormatReplace( LCUI_Graph *des, LCUI_Rect des_rect,
+				 const LCUI_Graph *src, int src_x, int src_y )
 {
 	int y;
 	uchar_t *byte_row_des, *byte_row_src;
@@ -264,7 +397,7 @@ static void Graph_ARGBReplaceRGB( LCUI_Graph *des, LCUI_Rect des_rect,
 	byte_row_des = des->bytes + des_rect.y * des->bytes_per_row;
 	byte_row_des += des_rect.x * des->bytes_per_pixel;
 	for( y = 0; y < des_rect.height; ++y ) {
-		/* 将前景图当前行像素转换成ARGB格式，并直接覆盖至背景图上 */
+		/* 将前景图当前行像素转换格式，并直接覆盖至背景图上 */
 		PixelsFormat( byte_row_src, src->color_type,
 			      byte_row_des, des->color_type, des_rect.width );
 		byte_row_src += src->bytes_per_row;
@@ -397,19 +530,29 @@ static int Graph_ARGBToRGB( LCUI_Graph *graph )
 		px_src = px_row_src;
 		byte_des = byte_row_des;
 		for( x = 0; x < graph->width; ++x ) {
-			px_src->b = *byte_des++;
-			px_src->g = *byte_des++;
-			px_src->r = *byte_des++;
-			px_src->a = 255;
+			*byte_des++ = px_src->b;
+			*byte_des++ = px_src->g;
+			*byte_des++ = px_src->r;
 			++px_src;
 		}
-		byte_row_des += graph->bytes_per_row;
+		byte_row_des += graph->width * 3;
 		px_row_src += graph->width;
 	}
 	free( graph->argb );
 	graph->bytes = buffer;
 	graph->color_type = COLOR_TYPE_RGB888;
 	graph->bytes_per_pixel = 3;
+	graph->bytes_per_row = graph->width * 3;
+	return 0;
+}
+
+/** 在 ARGB 和预乘 alpha 的 ARGB 格式之间转换 */
+static int Graph_ConvertARGB( LCUI_Graph *graph, int color_type )
+{
+	size_t n = graph->width * graph->height;
+	PixelsFormat( graph->bytes, graph->color_type,
+		      graph->bytes, color_type, n );
+	graph->color_type = color_type;
 	return 0;
 }
 
@@ -436,177 +579,710 @@ static int Graph_CutARGB( const LCUI_Graph *graph, LCUI_Rect rect,
 	return 0;
 }
 
-static void Graph_ARGBMixARGB( LCUI_Graph *dst, LCUI_Rect des_rect,
-			       const LCUI_Graph *src, int src_x, int src_y )
+/** 将 0 ~ 65025 范围内的值除以 255 并四舍五入 */
+#define DIV255(X) ((((X) + 128) + (((X) + 128) >> 8)) >> 8)
+
+/**
+ * 像素行混合函数
+ * 将 src 中的 n 个像素混合到 dst 上，opacity 为前景的不透明度（0 ~ 255）
+ */
+typedef void( *PixelRowMixer )(LCUI_ARGB*, const LCUI_ARGB*, int, int);
+typedef void( *PixelRowMixerRGB )(uchar_t*, const LCUI_ARGB*, int, int);
+
+/** 普通混合，保留背景像素的 alpha 值 */
+static void MixRowBlend( LCUI_ARGB *dst, const LCUI_ARGB *src,
+			 int n, int opacity )
 {
-	int x, y;
-	LCUI_ARGB *px_src, *px_dst;
-	LCUI_ARGB *px_row_src, *px_row_des;
-	double a, out_a, out_r, out_g, out_b, src_a;
-	px_row_src = src->argb + src_y*src->width + src_x;
-	px_row_des = dst->argb + des_rect.y*dst->width + des_rect.x;
-	if( src->opacity < 1.0 ) {
-		goto mix_with_opacity;
+	int a;
+	if( opacity >= 255 ) {
+		for( ; n > 0; --n, ++dst, ++src ) {
+			PIXEL_BLEND( dst, src, src->a );
+		}
+		return;
 	}
-	for( y = 0; y < des_rect.height; ++y ) {
-		px_src = px_row_src;
-		px_dst = px_row_des;
-		for( x = 0; x < des_rect.width; ++x ) {
-			src_a = px_src->a / 255.0;
-			a = (1.0 - src_a) * px_dst->a / 255.0;
-			out_r = px_dst->r * a + px_src->r * src_a;
-			out_g = px_dst->g * a + px_src->g * src_a;
-			out_b = px_dst->b * a + px_src->b * src_a;
-			out_a = src_a + a;
-			if( out_a > 0 ) {
-				out_r /= out_a;
-				out_g /= out_a;
-				out_b /= out_a;
+	for( ; n > 0; --n, ++dst, ++src ) {
+		a = src->a * opacity / 255;
+		PIXEL_BLEND( dst, src, a );
+	}
+}
+
+/** 带 alpha 通道的叠加（Porter-Duff over），用定点数代替浮点运算 */
+static void MixRowOver( LCUI_ARGB *dst, const LCUI_ARGB *src,
+			int n, int opacity )
+{
+	unsigned int sa, da, oa;
+	for( ; n > 0; --n, ++dst, ++src ) {
+		/* sa 和 da 均以 255 * 255 为单位 1 */
+		sa = src->a * opacity;
+		if( sa == 0 ) {
+			/* 全透明像素的颜色值没有意义，统一置为 0 */
+			if( dst->a == 0 ) {
+				dst->value = 0;
 			}
-			px_dst->r = (uchar_t)(out_r + 0.5);
-			px_dst->g = (uchar_t)(out_g + 0.5);
-			px_dst->b = (uchar_t)(out_b + 0.5);
-			px_dst->a = (uchar_t)(255.0 * out_a + 0.5);
-			++px_src;
-			++px_dst;
+			continue;
 		}
-		px_row_des += dst->width;
-		px_row_src += src->width;
+		if( sa == 65025 ) {
+			*dst = *src;
+			continue;
+		}
+		da = 65025 - sa;
+		if( dst->a == 255 ) {
+			dst->r = (src->r * sa + dst->r * da + 32512) / 65025;
+			dst->g = (src->g * sa + dst->g * da + 32512) / 65025;
+			dst->b = (src->b * sa + dst->b * da + 32512) / 65025;
+			continue;
+		}
+		/* 背景也是半透明的，需要以 255 * 65025 为单位 1 计算 */
+		da *= dst->a;
+		sa *= 255;
+		oa = sa + da;
+		dst->r = (src->r * sa + dst->r * da + oa / 2) / oa;
+		dst->g = (src->g * sa + dst->g * da + oa / 2) / oa;
+		dst->b = (src->b * sa + dst->b * da + oa / 2) / oa;
+		dst->a = (oa + 32512) / 65025;
 	}
-	return;
+}
 
-mix_with_opacity:
-	for( y = 0; y < des_rect.height; ++y ) {
-		px_src = px_row_src;
-		px_dst = px_row_des;
-		for( x = 0; x < des_rect.width; ++x ) {
-			src_a = px_src->a / 255.0 * src->opacity;
-			a = (1.0 - src_a) * px_dst->a / 255.0;
-			out_r = px_dst->r * a + px_src->r * src_a;
-			out_g = px_dst->g * a + px_src->g * src_a;
-			out_b = px_dst->b * a + px_src->b * src_a;
-			out_a = src_a + a;
-			if( out_a > 0 ) {
-				out_r /= out_a;
-				out_g /= out_a;
-				out_b /= out_a;
-			}
-			px_dst->r = (uchar_t)(out_r + 0.5);
-			px_dst->g = (uchar_t)(out_g + 0.5);
-			px_dst->b = (uchar_t)(out_b + 0.5);
-			px_dst->a = (uchar_t)(255.0 * out_a + 0.5);
-			++px_src;
-			++px_dst;
+static void MixRowBlendRGB( uchar_t *dst, const LCUI_ARGB *src,
+			    int n, int opacity )
+{
+	int a;
+	for( ; n > 0; --n, ++src ) {
+		if( opacity >= 255 ) {
+			a = src->a;
+		} else {
+			a = src->a * opacity / 255;
 		}
-		px_row_des += dst->width;
-		px_row_src += src->width;
+		*dst = _ALPHA_BLEND( *dst, src->b, a );
+		++dst;
+		*dst = _ALPHA_BLEND( *dst, src->g, a );
+		++dst;
+		*dst = _ALPHA_BLEND( *dst, src->r, a );
+		++dst;
 	}
 }
 
-static void Graph_ARGBMixARGB2( LCUI_Graph *dest, LCUI_Rect des_rect,
-				const LCUI_Graph *src, int src_x, int src_y )
+/** 先将 RGB 像素转换为 ARGB 像素，然后再用 ARGB 混合函数处理 */
+static void MixRowBlendRGBByARGB( uchar_t *dst, const LCUI_ARGB *src,
+				  int n, int opacity, PixelRowMixer blend )
 {
-	int x, y, a;
-	LCUI_ARGB *px_src, *px_dest;
-	LCUI_ARGB *px_row_src, *px_row_des;
-	px_row_src = src->argb + src_y*src->width + src_x;
-	px_row_des = dest->argb + des_rect.y*dest->width + des_rect.x;
-	if( src->opacity < 1.0 ) {
-		goto mix_with_opacity;
+	int i, len;
+	LCUI_ARGB buffer[64];
+	while( n > 0 ) {
+		len = n > 64 ? 64 : n;
+		for( i = 0; i < len; ++i ) {
+			buffer[i].b = dst[i * 3];
+			buffer[i].g = dst[i * 3 + 1];
+			buffer[i].r = dst[i * 3 + 2];
+			buffer[i].a = 255;
+		}
+		blend( buffer, src, len, opacity );
+		for( i = 0; i < len; ++i ) {
+			dst[i * 3] = buffer[i].b;
+			dst[i * 3 + 1] = buffer[i].g;
+			dst[i * 3 + 2] = buffer[i].r;
+		}
+		dst += len * 3;
+		src += len;
+		n -= len;
 	}
-	for( y = 0; y < des_rect.height; ++y ) {
-		px_src = px_row_src;
-		px_dest = px_row_des;
-		for( x = 0; x < des_rect.width; ++x ) {
-			PIXEL_BLEND( px_dest, px_src, px_src->a );
-			++px_src;
-			++px_dest;
+}
+
+/**
+ * 预乘 alpha 的像素叠加
+ * dst = src + dst * (255 - src_alpha) / 255，每个分量只需一次乘加运算
+ */
+static void MixRowOverPM( LCUI_ARGB *dst, const LCUI_ARGB *src,
+			  int n, int opacity )
+{
+	int a;
+	LCUI_ARGB px;
+	for( ; n > 0; --n, ++dst, ++src ) {
+		px = *src;
+		if( opacity < 255 ) {
+			px.r = DIV255( px.r * opacity );
+			px.g = DIV255( px.g * opacity );
+			px.b = DIV255( px.b * opacity );
+			px.a = DIV255( px.a * opacity );
 		}
-		px_row_des += dest->width;
-		px_row_src += src->width;
+		if( px.a == 0 ) {
+			continue;
+		}
+		if( px.a == 255 ) {
+			*dst = px;
+			continue;
+		}
+		a = 255 - px.a;
+		dst->r = px.r + DIV255( dst->r * a );
+		dst->g = px.g + DIV255( dst->g * a );
+		dst->b = px.b + DIV255( dst->b * a );
+		dst->a = px.a + DIV255( dst->a * a );
 	}
-	return;
+}
 
-mix_with_opacity:
-	for( y = 0; y < des_rect.height; ++y ) {
-		px_src = px_row_src;
-		px_dest = px_row_des;
-		for( x = 0; x < des_rect.width; ++x ) {
-			a = px_src->a * src->opacity;
-			PIXEL_BLEND( px_dest, px_src, a );
-			++px_src;
-			++px_dest;
+static void MixRowOverPMRGB( uchar_t *dst, const LCUI_ARGB *src,
+			     int n, int opacity )
+{
+	MixRowBlendRGBByARGB( dst, src, n, opacity, MixRowOverPM );
+}
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define PIXEL_MIXER_X86
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#define PIXEL_MIXER_X86
+#define TARGET_SSE2
+#define TARGET_AVX2
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+#ifdef PIXEL_MIXER_X86
+
+/**
+ * SSE2 版本的普通混合
+ * 每次处理 4 个像素，计算方式与 MixRowBlend() 一致：
+ * (fore * a + back * (256 - a)) >> 8
+ */
+TARGET_SSE2 static void MixRowBlend_SSE2( LCUI_ARGB *dst,
+					  const LCUI_ARGB *src,
+					  int n, int opacity )
+{
+	__m128i s, d, a, s_lo, s_hi, d_lo, d_hi, a_lo, a_hi;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i one = _mm_set1_epi16( 1 );
+	const __m128i n256 = _mm_set1_epi16( 256 );
+	const __m128i op = _mm_set1_epi32( opacity );
+	const __m128i amask = _mm_set1_epi32( (int)0xff000000 );
+
+	for( ; n >= 4; n -= 4, dst += 4, src += 4 ) {
+		s = _mm_loadu_si128( (const __m128i*)src );
+		d = _mm_loadu_si128( (const __m128i*)dst );
+		a = _mm_srli_epi32( s, 24 );
+		if( opacity < 255 ) {
+			/* a = a * opacity / 255 */
+			a = _mm_mullo_epi16( a, op );
+			a = _mm_add_epi16( _mm_add_epi16( a, one ),
+					   _mm_srli_epi16( a, 8 ) );
+			a = _mm_srli_epi16( a, 8 );
+		}
+		/* 将 alpha 值扩展到每个颜色分量 */
+		a = _mm_or_si128( a, _mm_slli_epi32( a, 16 ) );
+		a_lo = _mm_unpacklo_epi32( a, a );
+		a_hi = _mm_unpackhi_epi32( a, a );
+		s_lo = _mm_unpacklo_epi8( s, zero );
+		s_hi = _mm_unpackhi_epi8( s, zero );
+		d_lo = _mm_unpacklo_epi8( d, zero );
+		d_hi = _mm_unpackhi_epi8( d, zero );
+		s_lo = _mm_add_epi16( _mm_mullo_epi16( s_lo, a_lo ),
+				      _mm_mullo_epi16( d_lo, _mm_sub_epi16( n256, a_lo ) ) );
+		s_hi = _mm_add_epi16( _mm_mullo_epi16( s_hi, a_hi ),
+				      _mm_mullo_epi16( d_hi, _mm_sub_epi16( n256, a_hi ) ) );
+		s_lo = _mm_srli_epi16( s_lo, 8 );
+		s_hi = _mm_srli_epi16( s_hi, 8 );
+		s = _mm_packus_epi16( s_lo, s_hi );
+		s = _mm_or_si128( _mm_andnot_si128( amask, s ),
+				  _mm_and_si128( amask, d ) );
+		_mm_storeu_si128( (__m128i*)dst, s );
+	}
+	MixRowBlend( dst, src, n, opacity );
+}
+
+/**
+ * SSE2 版本的 alpha 叠加
+ * 背景像素全部不透明时才用 SIMD 指令计算，否则交给 MixRowOver() 处理
+ */
+TARGET_SSE2 static void MixRowOver_SSE2( LCUI_ARGB *dst,
+					 const LCUI_ARGB *src,
+					 int n, int opacity )
+{
+	__m128i s, d, a, s_lo, s_hi, d_lo, d_hi, a_lo, a_hi;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i n128 = _mm_set1_epi16( 128 );
+	const __m128i n255 = _mm_set1_epi16( 255 );
+	const __m128i op = _mm_set1_epi32( opacity );
+	const __m128i amask = _mm_set1_epi32( (int)0xff000000 );
+
+	for( ; n >= 4; n -= 4, dst += 4, src += 4 ) {
+		d = _mm_loadu_si128( (const __m128i*)dst );
+		a = _mm_cmpeq_epi32( _mm_and_si128( d, amask ), amask );
+		if( _mm_movemask_epi8( a ) != 0xffff ) {
+			MixRowOver( dst, src, 4, opacity );
+			continue;
+		}
+		s = _mm_loadu_si128( (const __m128i*)src );
+		a = _mm_srli_epi32( s, 24 );
+		if( opacity < 255 ) {
+			a = _mm_add_epi16( _mm_mullo_epi16( a, op ), n128 );
+			a = _mm_add_epi16( a, _mm_srli_epi16( a, 8 ) );
+			a = _mm_srli_epi16( a, 8 );
+		}
+		a = _mm_or_si128( a, _mm_slli_epi32( a, 16 ) );
+		a_lo = _mm_unpacklo_epi32( a, a );
+		a_hi = _mm_unpackhi_epi32( a, a );
+		s_lo = _mm_unpacklo_epi8( s, zero );
+		s_hi = _mm_unpackhi_epi8( s, zero );
+		d_lo = _mm_unpacklo_epi8( d, zero );
+		d_hi = _mm_unpackhi_epi8( d, zero );
+		/* (fore * a + back * (255 - a)) / 255 */
+		s_lo = _mm_add_epi16( _mm_mullo_epi16( s_lo, a_lo ),
+				      _mm_mullo_epi16( d_lo, _mm_sub_epi16( n255, a_lo ) ) );
+		s_hi = _mm_add_epi16( _mm_mullo_epi16( s_hi, a_hi ),
+				      _mm_mullo_epi16( d_hi, _mm_sub_epi16( n255, a_hi ) ) );
+		s_lo = _mm_add_epi16( s_lo, n128 );
+		s_hi = _mm_add_epi16( s_hi, n128 );
+		s_lo = _mm_add_epi16( s_lo, _mm_srli_epi16( s_lo, 8 ) );
+		s_hi = _mm_add_epi16( s_hi, _mm_srli_epi16( s_hi, 8 ) );
+		s_lo = _mm_srli_epi16( s_lo, 8 );
+		s_hi = _mm_srli_epi16( s_hi, 8 );
+		s = _mm_or_si128( _mm_packus_epi16( s_lo, s_hi ), amask );
+		_mm_storeu_si128( (__m128i*)dst, s );
+	}
+	MixRowOver( dst, src, n, opacity );
+}
+
+/** SSE2 版本的预乘 alpha 像素叠加 */
+TARGET_SSE2 static void MixRowOverPM_SSE2( LCUI_ARGB *dst,
+					   const LCUI_ARGB *src,
+					   int n, int opacity )
+{
+	__m128i s, d, s_lo, s_hi, d_lo, d_hi, a_lo, a_hi;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i n128 = _mm_set1_epi16( 128 );
+	const __m128i n255 = _mm_set1_epi16( 255 );
+	const __m128i op = _mm_set1_epi16( (short)opacity );
+
+	for( ; n >= 4; n -= 4, dst += 4, src += 4 ) {
+		s = _mm_loadu_si128( (const __m128i*)src );
+		/* 全透明的像素不影响背景，直接跳过 */
+		if( _mm_movemask_epi8( _mm_cmpeq_epi32( s, zero ) ) == 0xffff ) {
+			continue;
+		}
+		d = _mm_loadu_si128( (const __m128i*)dst );
+		s_lo = _mm_unpacklo_epi8( s, zero );
+		s_hi = _mm_unpackhi_epi8( s, zero );
+		d_lo = _mm_unpacklo_epi8( d, zero );
+		d_hi = _mm_unpackhi_epi8( d, zero );
+		if( opacity < 255 ) {
+			s_lo = _mm_add_epi16( _mm_mullo_epi16( s_lo, op ), n128 );
+			s_hi = _mm_add_epi16( _mm_mullo_epi16( s_hi, op ), n128 );
+			s_lo = _mm_add_epi16( s_lo, _mm_srli_epi16( s_lo, 8 ) );
+			s_hi = _mm_add_epi16( s_hi, _mm_srli_epi16( s_hi, 8 ) );
+			s_lo = _mm_srli_epi16( s_lo, 8 );
+			s_hi = _mm_srli_epi16( s_hi, 8 );
+		}
+		/* 将 alpha 值扩展到每个分量，并计算 255 - alpha */
+		a_lo = _mm_shufflelo_epi16( s_lo, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+		a_lo = _mm_shufflehi_epi16( a_lo, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+		a_hi = _mm_shufflelo_epi16( s_hi, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+		a_hi = _mm_shufflehi_epi16( a_hi, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+		a_lo = _mm_sub_epi16( n255, a_lo );
+		a_hi = _mm_sub_epi16( n255, a_hi );
+		d_lo = _mm_add_epi16( _mm_mullo_epi16( d_lo, a_lo ), n128 );
+		d_hi = _mm_add_epi16( _mm_mullo_epi16( d_hi, a_hi ), n128 );
+		d_lo = _mm_add_epi16( d_lo, _mm_srli_epi16( d_lo, 8 ) );
+		d_hi = _mm_add_epi16( d_hi, _mm_srli_epi16( d_hi, 8 ) );
+		d_lo = _mm_add_epi16( s_lo, _mm_srli_epi16( d_lo, 8 ) );
+		d_hi = _mm_add_epi16( s_hi, _mm_srli_epi16( d_hi, 8 ) );
+		d = _mm_packus_epi16( d_lo, d_hi );
+		_mm_storeu_si128( (__m128i*)dst, d );
+	}
+	MixRowOverPM( dst, src, n, opacity );
+}
+
+TARGET_SSE2 static void MixRowOverPMRGB_SSE2( uchar_t *dst,
+					      const LCUI_ARGB *src,
+					      int n, int opacity )
+{
+	MixRowBlendRGBByARGB( dst, src, n, opacity, MixRowOverPM_SSE2 );
+}
+
+TARGET_SSE2 static void MixRowBlendRGB_SSE2( uchar_t *dst,
+					     const LCUI_ARGB *src,
+					     int n, int opacity )
+{
+	MixRowBlendRGBByARGB( dst, src, n, opacity, MixRowBlend_SSE2 );
+}
+
+/** AVX2 版本的普通混合，每次处理 8 个像素 */
+TARGET_AVX2 static void MixRowBlend_AVX2( LCUI_ARGB *dst,
+					  const LCUI_ARGB *src,
+					  int n, int opacity )
+{
+	__m256i s, d, a, s_lo, s_hi, d_lo, d_hi, a_lo, a_hi;
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i one = _mm256_set1_epi16( 1 );
+	const __m256i n256 = _mm256_set1_epi16( 256 );
+	const __m256i op = _mm256_set1_epi32( opacity );
+	const __m256i amask = _mm256_set1_epi32( (int)0xff000000 );
+
+	for( ; n >= 8; n -= 8, dst += 8, src += 8 ) {
+		s = _mm256_loadu_si256( (const __m256i*)src );
+		d = _mm256_loadu_si256( (const __m256i*)dst );
+		a = _mm256_srli_epi32( s, 24 );
+		if( opacity < 255 ) {
+			a = _mm256_mullo_epi16( a, op );
+			a = _mm256_add_epi16( _mm256_add_epi16( a, one ),
+					      _mm256_srli_epi16( a, 8 ) );
+			a = _mm256_srli_epi16( a, 8 );
+		}
+		a = _mm256_or_si256( a, _mm256_slli_epi32( a, 16 ) );
+		a_lo = _mm256_unpacklo_epi32( a, a );
+		a_hi = _mm256_unpackhi_epi32( a, a );
+		s_lo = _mm256_unpacklo_epi8( s, zero );
+		s_hi = _mm256_unpackhi_epi8( s, zero );
+		d_lo = _mm256_unpacklo_epi8( d, zero );
+		d_hi = _mm256_unpackhi_epi8( d, zero );
+		s_lo = _mm256_add_epi16( _mm256_mullo_epi16( s_lo, a_lo ),
+					 _mm256_mullo_epi16( d_lo, _mm256_sub_epi16( n256, a_lo ) ) );
+		s_hi = _mm256_add_epi16( _mm256_mullo_epi16( s_hi, a_hi ),
+					 _mm256_mullo_epi16( d_hi, _mm256_sub_epi16( n256, a_hi ) ) );
+		s_lo = _mm256_srli_epi16( s_lo, 8 );
+		s_hi = _mm256_srli_epi16( s_hi, 8 );
+		s = _mm256_packus_epi16( s_lo, s_hi );
+		s = _mm256_or_si256( _mm256_andnot_si256( amask, s ),
+				     _mm256_and_si256( amask, d ) );
+		_mm256_storeu_si256( (__m256i*)dst, s );
+	}
+	MixRowBlend_SSE2( dst, src, n, opacity );
+}
+
+/** AVX2 版本的 alpha 叠加，每次处理 8 个像素 */
+TARGET_AVX2 static void MixRowOver_AVX2( LCUI_ARGB *dst,
+					 const LCUI_ARGB *src,
+					 int n, int opacity )
+{
+	__m256i s, d, a, s_lo, s_hi, d_lo, d_hi, a_lo, a_hi;
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i n128 = _mm256_set1_epi16( 128 );
+	const __m256i n255 = _mm256_set1_epi16( 255 );
+	const __m256i op = _mm256_set1_epi32( opacity );
+	const __m256i amask = _mm256_set1_epi32( (int)0xff000000 );
+
+	for( ; n >= 8; n -= 8, dst += 8, src += 8 ) {
+		d = _mm256_loadu_si256( (const __m256i*)dst );
+		a = _mm256_cmpeq_epi32( _mm256_and_si256( d, amask ), amask );
+		if( _mm256_movemask_epi8( a ) != -1 ) {
+			MixRowOver( dst, src, 8, opacity );
+			continue;
+		}
+		s = _mm256_loadu_si256( (const __m256i*)src );
+		a = _mm256_srli_epi32( s, 24 );
+		if( opacity < 255 ) {
+			a = _mm256_add_epi16( _mm256_mullo_epi16( a, op ), n128 );
+			a = _mm256_add_epi16( a, _mm256_srli_epi16( a, 8 ) );
+			a = _mm256_srli_epi16( a, 8 );
+		}
+		a = _mm256_or_si256( a, _mm256_slli_epi32( a, 16 ) );
+		a_lo = _mm256_unpacklo_epi32( a, a );
+		a_hi = _mm256_unpackhi_epi32( a, a );
+		s_lo = _mm256_unpacklo_epi8( s, zero );
+		s_hi = _mm256_unpackhi_epi8( s, zero );
+		d_lo = _mm256_unpacklo_epi8( d, zero );
+		d_hi = _mm256_unpackhi_epi8( d, zero );
+		s_lo = _mm256_add_epi16( _mm256_mullo_epi16( s_lo, a_lo ),
+					 _mm256_mullo_epi16( d_lo, _mm256_sub_epi16( n255, a_lo ) ) );
+		s_hi = _mm256_add_epi16( _mm256_mullo_epi16( s_hi, a_hi ),
+					 _mm256_mullo_epi16( d_hi, _mm256_sub_epi16( n255, a_hi ) ) );
+		s_lo = _mm256_add_epi16( s_lo, n128 );
+		s_hi = _mm256_add_epi16( s_hi, n128 );
+		s_lo = _mm256_add_epi16( s_lo, _mm256_srli_epi16( s_lo, 8 ) );
+		s_hi = _mm256_add_epi16( s_hi, _mm256_srli_epi16( s_hi, 8 ) );
+		s_lo = _mm256_srli_epi16( s_lo, 8 );
+		s_hi = _mm256_srli_epi16( s_hi, 8 );
+		s = _mm256_or_si256( _mm256_packus_epi16( s_lo, s_hi ), amask );
+		_mm256_storeu_si256( (__m256i*)dst, s );
+	}
+	MixRowOver_SSE2( dst, src, n, opacity );
+}
+
+/** AVX2 版本的预乘 alpha 像素叠加 */
+TARGET_AVX2 static void MixRowOverPM_AVX2( LCUI_ARGB *dst,
+					   const LCUI_ARGB *src,
+					   int n, int opacity )
+{
+	__m256i s, d, s_lo, s_hi, d_lo, d_hi, a_lo, a_hi;
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i n128 = _mm256_set1_epi16( 128 );
+	const __m256i n255 = _mm256_set1_epi16( 255 );
+	const __m256i op = _mm256_set1_epi16( (short)opacity );
+
+	for( ; n >= 8; n -= 8, dst += 8, src += 8 ) {
+		s = _mm256_loadu_si256( (const __m256i*)src );
+		if( _mm256_movemask_epi8( _mm256_cmpeq_epi32( s, zero ) ) == -1 ) {
+			continue;
 		}
-		px_row_des += dest->width;
+		d = _mm256_loadu_si256( (const __m256i*)dst );
+		s_lo = _mm256_unpacklo_epi8( s, zero );
+		s_hi = _mm256_unpackhi_epi8( s, zero );
+		d_lo = _mm256_unpacklo_epi8( d, zero );
+		d_hi = _mm256_unpackhi_epi8( d, zero );
+		if( opacity < 255 ) {
+			s_lo = _mm256_add_epi16( _mm256_mullo_epi16( s_lo, op ), n128 );
+			s_hi = _mm256_add_epi16( _mm256_mullo_epi16( s_hi, op ), n128 );
+			s_lo = _mm256_add_epi16( s_lo, _mm256_srli_epi16( s_lo, 8 ) );
+			s_hi = _mm256_add_epi16( s_hi, _mm256_srli_epi16( s_hi, 8 ) );
+			s_lo = _mm256_srli_epi16( s_lo, 8 );
+			s_hi = _mm256_srli_epi16( s_hi, 8 );
+		}
+		a_lo = _mm256_shufflelo_epi16( s_lo, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+		a_lo = _mm256_shufflehi_epi16( a_lo, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+		a_hi = _mm256_shufflelo_epi16( s_hi, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+		a_hi = _mm256_shufflehi_epi16( a_hi, _MM_SHUFFLE( 3, 3, 3, 3 ) );
+		a_lo = _mm256_sub_epi16( n255, a_lo );
+		a_hi = _mm256_sub_epi16( n255, a_hi );
+		d_lo = _mm256_add_epi16( _mm256_mullo_epi16( d_lo, a_lo ), n128 );
+		d_hi = _mm256_add_epi16( _mm256_mullo_epi16( d_hi, a_hi ), n128 );
+		d_lo = _mm256_add_epi16( d_lo, _mm256_srli_epi16( d_lo, 8 ) );
+		d_hi = _mm256_add_epi16( d_hi, _mm256_srli_epi16( d_hi, 8 ) );
+		d_lo = _mm256_add_epi16( s_lo, _mm256_srli_epi16( d_lo, 8 ) );
+		d_hi = _mm256_add_epi16( s_hi, _mm256_srli_epi16( d_hi, 8 ) );
+		d = _mm256_packus_epi16( d_lo, d_hi );
+		_mm256_storeu_si256( (__m256i*)dst, d );
+	}
+	MixRowOverPM_SSE2( dst, src, n, opacity );
+}
+
+TARGET_AVX2 static void MixRowOverPMRGB_AVX2( uchar_t *dst,
+					      const LCUI_ARGB *src,
+					      int n, int opacity )
+{
+	MixRowBlendRGBByARGB( dst, src, n, opacity, MixRowOverPM_AVX2 );
+}
+
+TARGET_AVX2 static void MixRowBlendRGB_AVX2( uchar_t *dst,
+					     const LCUI_ARGB *src,
+					     int n, int opacity )
+{
+	MixRowBlendRGBByARGB( dst, src, n, opacity, MixRowBlend_AVX2 );
+}
+
+/** 检测 CPU 支持的指令集，返回值：0 不支持，1 支持 SSE2，2 支持 AVX2 */
+static int DetectCPUFeatures( void )
+{
+#ifdef __GNUC__
+	__builtin_cpu_init();
+	if( __builtin_cpu_supports( "avx2" ) ) {
+		return 2;
+	}
+	if( __builtin_cpu_supports( "sse2" ) ) {
+		return 1;
+	}
+	return 0;
+#else
+	int info[4], level = 0;
+	__cpuid( info, 0 );
+	if( info[0] < 1 ) {
+		return 0;
+	}
+	__cpuid( info, 1 );
+	if( info[3] & (1 << 26) ) {
+		level = 1;
+	}
+	/* AVX2 还需要操作系统支持保存 YMM 寄存器 */
+	if( !(info[2] & (1 << 27)) || (_xgetbv( 0 ) & 6) != 6 ) {
+		return level;
+	}
+	__cpuid( info, 0 );
+	if( info[0] < 7 ) {
+		return level;
+	}
+	__cpuidex( info, 7, 0 );
+	if( info[1] & (1 << 5) ) {
+		level = 2;
+	}
+	return level;
+#endif
+}
+
+#endif /* PIXEL_MIXER_X86 */
+
+/** 当前使用的像素混合函数，在 LCUI_InitGraph() 中根据 CPU 特性选择 */
+static struct PixelMixerRec {
+	const char *name;
+	PixelRowMixer blend;
+	PixelRowMixer over;
+	PixelRowMixer over_pm;
+	PixelRowMixerRGB blend_rgb;
+	PixelRowMixerRGB over_pm_rgb;
+} pixel_mixer = {
+	"generic", MixRowBlend, MixRowOver, MixRowOverPM,
+	MixRowBlendRGB, MixRowOverPMRGB
+};
+
+/** 预乘前景像素后再混合到预乘 alpha 的背景上 */
+static void MixRowPremultiplied( LCUI_ARGB *dst, const LCUI_ARGB *src,
+				 int n, int opacity )
+{
+	int len;
+	LCUI_ARGB buffer[64];
+	while( n > 0 ) {
+		len = n > 64 ? 64 : n;
+		Pixels_ARGBFormatToPARGB( (const uchar_t*)src,
+					  (uchar_t*)buffer, len );
+		pixel_mixer.over_pm( dst, buffer, len, opacity );
+		dst += len;
+		src += len;
+		n -= len;
+	}
+}
+
+/** 还原预乘 alpha 的前景像素，然后用普通的混合函数处理 */
+static void MixRowUnpremultiplied( LCUI_ARGB *dst, const LCUI_ARGB *src,
+				   int n, int opacity, PixelRowMixer mix )
+{
+	int len;
+	LCUI_ARGB buffer[64];
+	while( n > 0 ) {
+		len = n > 64 ? 64 : n;
+		Pixels_PARGBFormatToARGB( (const uchar_t*)src,
+					  (uchar_t*)buffer, len );
+		mix( dst, buffer, len, opacity );
+		dst += len;
+		src += len;
+		n -= len;
+	}
+}
+
+static void MixRowUnpremultipliedOver( LCUI_ARGB *dst, const LCUI_ARGB *src,
+				       int n, int opacity )
+{
+	MixRowUnpremultiplied( dst, src, n, opacity, pixel_mixer.over );
+}
+
+static void MixRowUnpremultipliedBlend( LCUI_ARGB *dst, const LCUI_ARGB *src,
+					int n, int opacity )
+{
+	MixRowUnpremultiplied( dst, src, n, opacity, pixel_mixer.blend );
+}
+
+/** 获取图像的不透明度（0 ~ 255） */
+static int Graph_GetOpacity( const LCUI_Graph *graph )
+{
+	if( graph->opacity >= 1.0 ) {
+		return 255;
+	}
+	if( graph->opacity <= 0 ) {
+		return 0;
+	}
+	return (int)(graph->opacity * 255 + 0.5);
+}
+
+/** 逐行调用像素混合函数，将 ARGB 前景图混合到 ARGB 背景图上 */
+static void Graph_MixRows( LCUI_Graph *dst, LCUI_Rect des_rect,
+			   const LCUI_Graph *src, int src_x, int src_y,
+			   PixelRowMixer mix )
+{
+	int y, opacity;
+	LCUI_ARGB *px_row_src, *px_row_des;
+	opacity = Graph_GetOpacity( src );
+	px_row_src = src->argb + src_y*src->width + src_x;
+	px_row_des = dst->argb + des_rect.y*dst->width + des_rect.x;
+	for( y = 0; y < des_rect.height; ++y ) {
+		mix( px_row_des, px_row_src, des_rect.width, opacity );
+		px_row_des += dst->width;
 		px_row_src += src->width;
 	}
 }
 
-static void Graph_RGBMixARGB( LCUI_Graph *des, LCUI_Rect des_rect,
-			      const LCUI_Graph *src, int src_x, int src_y )
+/** 逐行调用像素混合函数，将 ARGB 前景图混合到 RGB 背景图上 */
+static void Graph_MixRowsRGB( LCUI_Graph *des, LCUI_Rect des_rect,
+			      const LCUI_Graph *src, int src_x, int src_y,
+			      PixelRowMixerRGB mix )
 {
-	int x, y;
-	uchar_t a;
-	LCUI_ARGB *px, *px_row;
-	uchar_t *rowbytep, *bytep;
+	int y, opacity;
+	LCUI_ARGB *px_row;
+	uchar_t *rowbytep;
 
+	opacity = Graph_GetOpacity( src );
 	/* 计算并保存第一行的首个像素的位置 */
 	px_row = src->argb + src_y*src->width + src_x;
 	rowbytep = des->bytes + des_rect.y*des->bytes_per_row;
 	rowbytep += des_rect.x*des->bytes_per_pixel;
-	if( src->opacity < 1.0 ) {
-		goto mix_with_opacity;
-	}
 	for( y = 0; y < des_rect.height; ++y ) {
-		px = px_row;
-		bytep = rowbytep;
-		for( x = 0; x < des_rect.width; ++x, ++px ) {
-			*bytep = _ALPHA_BLEND( *bytep, px->b, px->a );
-			++bytep;
-			*bytep = _ALPHA_BLEND( *bytep, px->g, px->a );
-			++bytep;
-			*bytep = _ALPHA_BLEND( *bytep, px->r, px->a );
-			++bytep;
-		}
+		mix( rowbytep, px_row, des_rect.width, opacity );
 		rowbytep += des->bytes_per_row;
 		px_row += src->width;
 	}
-	return;
+}
 
-mix_with_opacity:
-	for( y = 0; y < des_rect.height; ++y ) {
-		px = px_row;
-		bytep = rowbytep;
-		for( x = 0; x < des_rect.width; ++x, ++px ) {
-			a = px->a * src->opacity;
-			*bytep = _ALPHA_BLEND( *bytep, px->b, a );
-			++bytep;
-			*bytep = _ALPHA_BLEND( *bytep, px->g, a );
-			++bytep;
-			*bytep = _ALPHA_BLEND( *bytep, px->r, a );
-			++bytep;
-		}
-		rowbytep += des->bytes_per_row;
-		px_row += src->width;
-	}
+static void Graph_ARGBMixARGB( LCUI_Graph *dst, LCUI_Rect des_rect,
+			       const LCUI_Graph *src, int src_x, int src_y )
+{
+	Graph_MixRows( dst, des_rect, src, src_x, src_y, pixel_mixer.over );
+}
+
+static void Graph_ARGBMixARGB2( LCUI_Graph *dst, LCUI_Rect des_rect,
+				const LCUI_Graph *src, int src_x, int src_y )
+{
+	Graph_MixRows( dst, des_rect, src, src_x, src_y, pixel_mixer.blend );
+}
+
+static void Graph_ARGBMixPARGB( LCUI_Graph *dst, LCUI_Rect des_rect,
+				const LCUI_Graph *src, int src_x, int src_y )
+{
+	Graph_MixRows( dst, des_rect, src, src_x, src_y,
+		       MixRowUnpremultipliedOver );
+}
+
+static void Graph_ARGBMixPARGB2( LCUI_Graph *dst, LCUI_Rect des_rect,
+				 const LCUI_Graph *src, int src_x, int src_y )
+{
+	Graph_MixRows( dst, des_rect, src, src_x, src_y,
+		       MixRowUnpremultipliedBlend );
+}
+
+static void Graph_PARGBMixPARGB( LCUI_Graph *dst, LCUI_Rect des_rect,
+				 const LCUI_Graph *src, int src_x, int src_y )
+{
+	Graph_MixRows( dst, des_rect, src, src_x, src_y, pixel_mixer.over_pm );
+}
+
+static void Graph_PARGBMixARGB( LCUI_Graph *dst, LCUI_Rect des_rect,
+				const LCUI_Graph *src, int src_x, int src_y )
+{
+	Graph_MixRows( dst, des_rect, src, src_x, src_y, MixRowPremultiplied );
+}
+
+static void Graph_RGBMixARGB( LCUI_Graph *des, LCUI_Rect des_rect,
+			      const LCUI_Graph *src, int src_x, int src_y )
+{
+	Graph_MixRowsRGB( des, des_rect, src, src_x, src_y,
+			  pixel_mixer.blend_rgb );
+}
+
+static void Graph_RGBMixPARGB( LCUI_Graph *des, LCUI_Rect des_rect,
+			       const LCUI_Graph *src, int src_x, int src_y )
+{
+	Graph_MixRowsRGB( des, des_rect, src, src_x, src_y,
+			  pixel_mixer.over_pm_rgb );
 }
 
 static int Graph_ARGBReplaceARGB( LCUI_Graph *des, LCUI_Rect des_rect,
 				  const LCUI_Graph *src, int src_x, int src_y )
 {
-	int x, y, row_size;
+	int x, y, row_size, opacity;
 	LCUI_ARGB *px_row_src, *px_row_des, *px_src, *px_des;
 	px_row_src = src->argb + src_y*src->width + src_x;
 	px_row_des = des->argb + des_rect.y*des->width + des_rect.x;
 	if( src->opacity < 1.0 ) {
+		opacity = Graph_GetOpacity( src );
 		for( y = 0; y < des_rect.height; ++y ) {
 			px_src = px_row_src;
 			px_des = px_row_des;
 			for( x = 0; x < des_rect.width; ++x ) {
-				px_des->b = px_src->b;
-				px_des->g = px_src->g;
-				px_des->r = px_src->r;
-				px_des->a = src->opacity*px_src->a;
+				*px_des = *px_src;
+				px_des->a = DIV255( px_src->a * opacity );
+				/* 预乘 alpha 的像素需要同时调整颜色值 */
+				if( src->color_type == COLOR_TYPE_PARGB ) {
+					px_des->r = DIV255( px_src->r * opacity );
+					px_des->g = DIV255( px_src->g * opacity );
+					px_des->b = DIV255( px_src->b * opacity );
+				}
+				++px_src;
+				++px_des;
 			}
 			px_row_src += src->width;
 			px_row_des += des->width;
@@ -678,6 +1354,39 @@ static int Graph_VertiFlipARGB( const LCUI_Graph *graph, LCUI_Graph *buff )
 	return 0;
 }
 
+static int Graph_FillRectPARGB( LCUI_ARGB *px_row_p, size_t width,
+				LCUI_Color color, LCUI_Rect rect,
+				LCUI_BOOL with_alpha )
+{
+	int x, y;
+	LCUI_ARGB *px_p;
+	LCUI_Color pm_color = color;
+
+	PIXEL_PREMULTIPLY( &pm_color );
+	if( with_alpha ) {
+		for( y = 0; y < rect.height; ++y ) {
+			px_p = px_row_p;
+			for( x = 0; x < rect.width; ++x ) {
+				*px_p++ = pm_color;
+			}
+			px_row_p += width;
+		}
+		return 0;
+	}
+	/* 保留原有的 alpha 值，颜色值需按该 alpha 值重新预乘 */
+	for( y = 0; y < rect.height; ++y ) {
+		px_p = px_row_p;
+		for( x = 0; x < rect.width; ++x ) {
+			color.alpha = px_p->alpha;
+			*px_p = color;
+			PIXEL_PREMULTIPLY( px_p );
+			++px_p;
+		}
+		px_row_p += width;
+	}
+	return 0;
+}
+
 static int Graph_FillRectARGB( LCUI_Graph *graph, LCUI_Color color,
 			       LCUI_Rect rect, LCUI_BOOL with_alpha )
 {
@@ -692,6 +1401,10 @@ static int Graph_FillRectARGB( LCUI_Graph *graph, LCUI_Color color,
 	graph = Graph_GetQuote( graph );
 	px_row_p = graph->argb + (rect_src.y + rect.y)*graph->width;
 	px_row_p += rect.x + rect_src.x;
+	if( graph->color_type == COLOR_TYPE_PARGB ) {
+		return Graph_FillRectPARGB( px_row_p, graph->width,
+					    color, rect, with_alpha );
+	}
 	if( with_alpha ) {
 		for( y = 0; y < rect.height; ++y ) {
 			px_p = px_row_p;
@@ -725,13 +1438,26 @@ int Graph_SetColorType( LCUI_Graph *graph, int color_type )
 		switch( color_type ) {
 		case COLOR_TYPE_RGB888:
 			return Graph_ARGBToRGB( graph );
+		case COLOR_TYPE_PARGB8888:
+			return Graph_ConvertARGB( graph, color_type );
+		default:break;
+		}
+		break;
+	case COLOR_TYPE_PARGB8888:
+		switch( color_type ) {
+		case COLOR_TYPE_RGB888:
+			Graph_ConvertARGB( graph, COLOR_TYPE_ARGB8888 );
+			return Graph_ARGBToRGB( graph );
+		case COLOR_TYPE_ARGB8888:
+			return Graph_ConvertARGB( graph, color_type );
 		default:break;
 		}
 		break;
 	case COLOR_TYPE_RGB888:
 		switch( color_type ) {
 		case COLOR_TYPE_ARGB8888:
-			return Graph_RGBToARGB( graph );
+		case COLOR_TYPE_PARGB8888:
+			return Graph_RGBToARGB( graph, color_type );
 		default:break;
 		}
 		break;
@@ -792,6 +1518,58 @@ void Graph_Copy( LCUI_Graph *des, const LCUI_Graph *src )
 	des->opacity = src->opacity;
 }
 
+int Graph_Scroll( LCUI_Graph *graph, int dx, int dy )
+{
+	LCUI_Rect rect;
+	LCUI_Graph *source;
+	int y, width, height;
+	size_t row_size, bytes_per_row;
+	uchar_t *src, *dst;
+
+	if( !Graph_IsValid( graph ) ) {
+		return -1;
+	}
+	source = Graph_GetQuote( graph );
+	Graph_GetValidRect( graph, &rect );
+	width = rect.width - abs( dx );
+	height = rect.height - abs( dy );
+	if( width <= 0 || height <= 0 ) {
+		return 0;
+	}
+	bytes_per_row = source->bytes_per_row;
+	row_size = source->bytes_per_pixel * width;
+	src = source->bytes + bytes_per_row * rect.y;
+	src += source->bytes_per_pixel * rect.x;
+	dst = src;
+	if( dx > 0 ) {
+		dst += source->bytes_per_pixel * dx;
+	} else {
+		src -= source->bytes_per_pixel * dx;
+	}
+	if( dy > 0 ) {
+		dst += bytes_per_row * dy;
+	} else {
+		src -= bytes_per_row * dy;
+	}
+	/* 向下移动时从最后一行开始复制，以免覆盖还未复制的行 */
+	if( dy > 0 ) {
+		src += bytes_per_row * (height - 1);
+		dst += bytes_per_row * (height - 1);
+		for( y = 0; y < height; ++y ) {
+			memmove( dst, src, row_size );
+			src -= bytes_per_row;
+			dst -= bytes_per_row;
+		}
+		return 0;
+	}
+	for( y = 0; y < height; ++y ) {
+		memmove( dst, src, row_size );
+		src += bytes_per_row;
+		dst += bytes_per_row;
+	}
+	return 0;
+}
+
 void Graph_Free( LCUI_Graph *graph )
 {
 	/* 解除引用 */
@@ -809,6 +1587,124 @@ void Graph_Free( LCUI_Graph *graph )
 	graph->mem_size = 0;
 }
 
+/** 内存池中的像素数据按 16 字节对齐 */
+#define ARENA_ALIGN(N) (((N) + 15) & ~(size_t)15)
+
+typedef struct LCUI_GraphArenaBlockRec_ {
+	struct LCUI_GraphArenaBlockRec_ *next;
+} GraphArenaBlockRec, *GraphArenaBlock;
+
+void GraphArena_Init( LCUI_GraphArena arena )
+{
+	arena->bytes = NULL;
+	arena->size = 0;
+	arena->used = 0;
+	arena->peak = 0;
+	arena->blocks = NULL;
+}
+
+static void GraphArena_FreeBlocks( LCUI_GraphArena arena )
+{
+	GraphArenaBlock block;
+	while( arena->blocks ) {
+		block = arena->blocks;
+		arena->blocks = block->next;
+		free( block );
+	}
+}
+
+void GraphArena_Reset( LCUI_GraphArena arena )
+{
+	GraphArena_FreeBlocks( arena );
+	if( arena->peak > arena->size ) {
+		free( arena->bytes );
+		arena->size = arena->peak;
+		arena->bytes = malloc( arena->size );
+		if( !arena->bytes ) {
+			arena->size = 0;
+		}
+	}
+	arena->used = 0;
+	arena->peak = 0;
+}
+
+void GraphArena_Destroy( LCUI_GraphArena arena )
+{
+	GraphArena_FreeBlocks( arena );
+	free( arena->bytes );
+	GraphArena_Init( arena );
+}
+
+size_t GraphArena_GetOffset( LCUI_GraphArena arena )
+{
+	return arena->used;
+}
+
+void GraphArena_Rewind( LCUI_GraphArena arena, size_t offset )
+{
+	if( offset < arena->used ) {
+		arena->used = offset;
+	}
+}
+
+/** 从内存池中分配内存，内存块不足时改为申请额外的内存，在复位时一并释放 */
+static void *GraphArena_Alloc( LCUI_GraphArena arena, size_t size )
+{
+	void *ptr;
+	GraphArenaBlock block;
+	size_t header_size = ARENA_ALIGN( sizeof( GraphArenaBlockRec ) );
+
+	size = ARENA_ALIGN( size );
+	if( arena->used + size <= arena->size ) {
+		ptr = arena->bytes + arena->used;
+	} else {
+		block = malloc( header_size + size );
+		if( !block ) {
+			return NULL;
+		}
+		block->next = arena->blocks;
+		arena->blocks = block;
+		ptr = (uchar_t*)block + header_size;
+	}
+	/* 超出内存块的部分也计入用量，以便复位时扩大内存块 */
+	arena->used += size;
+	if( arena->used > arena->peak ) {
+		arena->peak = arena->used;
+	}
+	return ptr;
+}
+
+int GraphArena_CreateGraph( LCUI_GraphArena arena,
+			    LCUI_Graph *graph, int w, int h )
+{
+	size_t size;
+	if( !arena ) {
+		return Graph_Create( graph, w, h );
+	}
+	if( w > 10000 || h > 10000 ) {
+		_DEBUG_MSG( "graph size is too large!" );
+		abort();
+	}
+	if( h <= 0 || w <= 0 ) {
+		return -1;
+	}
+	graph->bytes_per_pixel = get_pixel_size( graph->color_type );
+	graph->bytes_per_row = graph->bytes_per_pixel * w;
+	size = graph->bytes_per_row * h;
+	graph->bytes = GraphArena_Alloc( arena, size );
+	if( !graph->bytes ) {
+		graph->width = 0;
+		graph->height = 0;
+		graph->mem_size = 0;
+		return -2;
+	}
+	memset( graph->bytes, 0, size );
+	graph->mem_size = size;
+	graph->width = w;
+	graph->height = h;
+	return 0;
+}
+
 int Graph_Quote( LCUI_Graph *self, LCUI_Graph *source, const LCUI_Rect *rect )
 {
 	LCUI_Rect quote_rect;
@@ -872,7 +1768,7 @@ int Graph_SetAlphaBits( LCUI_Graph *graph, uchar_t *a, size_t size )
 	if( size > (size_t)(graph->width * graph->height) ) {
 		size = (size_t)(graph->width * graph->height);
 	}
-	if( graph->color_type != COLOR_TYPE_ARGB ) {
+	if( !ColorType_IsARGB( graph->color_type ) ) {
 		return -2;
 	}
 	for( i = 0; i < size; ++i ) {
@@ -889,7 +1785,7 @@ int Graph_SetRedBits( LCUI_Graph *graph, uchar_t *r, size_t size )
 	if( size > (size_t)(graph->width * graph->height) ) {
 		size = (size_t)(graph->width * graph->height);
 	}
-	if( graph->color_type == COLOR_TYPE_ARGB ) {
+	if( ColorType_IsARGB( graph->color_type ) ) {
 		for( i = 0; i < size; ++i ) {
 			graph->argb[i].r = r[i];
 		}
@@ -911,7 +1807,7 @@ int Graph_SetGreenBits( LCUI_Graph *graph, uchar_t *g, size_t size )
 	if( size > (size_t)(graph->width * graph->height) ) {
 		size = (size_t)(graph->width * graph->height);
 	}
-	if( graph->color_type == COLOR_TYPE_ARGB ) {
+	if( ColorType_IsARGB( graph->color_type ) ) {
 		for( i = 0; i < size; ++i ) {
 			graph->argb[i].g = g[i];
 		}
@@ -933,7 +1829,7 @@ int Graph_SetBlueBits( LCUI_Graph *graph, uchar_t *b, size_t size )
 	if( size > (size_t)(graph->width * graph->height) ) {
 		size = (size_t)(graph->width * graph->height);
 	}
-	if( graph->color_type == COLOR_TYPE_ARGB ) {
+	if( ColorType_IsARGB( graph->color_type ) ) {
 		for( i = 0; i < size; ++i ) {
 			graph->argb[i].b = b[i];
 		}
@@ -985,7 +1881,7 @@ int Graph_Zoom( const LCUI_Graph *graph, LCUI_Graph *buff,
 	if( Graph_Create( buff, width, height ) < 0 ) {
 		return -2;
 	}
-	if( graph->color_type == COLOR_TYPE_ARGB ) {
+	if( ColorType_IsARGB( graph->color_type ) ) {
 		LCUI_ARGB *px_src, *px_des, *px_row_src;
 		for( y = 0; y < height; ++y ) {
 			src_y = y * scale_y;
@@ -1031,6 +1927,7 @@ int Graph_Cut( const LCUI_Graph *graph, LCUI_Rect rect,
 	}
 	switch( graph->color_type ) {
 	case COLOR_TYPE_ARGB8888:
+	case COLOR_TYPE_PARGB8888:
 		return Graph_CutARGB( graph, rect, buff );
 	case COLOR_TYPE_RGB888:
 		return Graph_CutRGB( graph, rect, buff );
@@ -1046,6 +1943,7 @@ int Graph_HorizFlip( const LCUI_Graph *graph, LCUI_Graph *buff )
 	case COLOR_TYPE_RGB888:
 		return Graph_HorizFlipRGB( graph, buff );
 	case COLOR_TYPE_ARGB8888:
+	case COLOR_TYPE_PARGB8888:
 		return Graph_HorizFlipARGB( graph, buff );
 	default:break;
 	}
@@ -1058,6 +1956,7 @@ int Graph_VertiFlip( const LCUI_Graph *graph, LCUI_Graph *buff )
 	case COLOR_TYPE_RGB888:
 		return Graph_VertiFlipRGB( graph, buff );
 	case COLOR_TYPE_ARGB8888:
+	case COLOR_TYPE_PARGB8888:
 		return Graph_VertiFlipARGB( graph, buff );
 	default:break;
 	}
@@ -1079,6 +1978,7 @@ int Graph_FillRect( LCUI_Graph *graph, LCUI_Color color,
 	case COLOR_TYPE_RGB888:
 		return Graph_FillRectRGB( graph, color, rect2 );
 	case COLOR_TYPE_ARGB8888:
+	case COLOR_TYPE_PARGB8888:
 		return Graph_FillRectARGB( graph, color, rect2, with_alpha );
 	default:break;
 	}
@@ -1100,6 +2000,19 @@ int Graph_FillAlpha( LCUI_Graph *graph, uchar_t alpha )
 		return -2;
 	}
 	pixel_row = graph->argb + rect.y*graph->width + rect.x;
+	if( graph->color_type == COLOR_TYPE_PARGB ) {
+		for( y = 0; y < rect.height; ++y ) {
+			pixel = pixel_row;
+			for( x = 0; x < rect.width; ++x ) {
+				Pixel_Unpremultiply( pixel );
+				pixel->alpha = alpha;
+				PIXEL_PREMULTIPLY( pixel );
+				++pixel;
+			}
+			pixel_row += graph->width;
+		}
+		return 0;
+	}
 	for( y = 0; y < rect.height; ++y ) {
 		pixel = pixel_row;
 		for( x = 0; x < rect.width; ++x ) {
@@ -1169,18 +2082,42 @@ int Graph_Mix( LCUI_Graph *back, const LCUI_Graph *fore,
 		if( back->color_type == COLOR_TYPE_RGB888 ) {
 			mixer = Graph_RGBReplaceRGB;
 		} else {
-			mixer = Graph_ARGBReplaceRGB;
+			mixer = Graph_FormatReplace;
 		}
 		break;
 	case COLOR_TYPE_ARGB8888:
-		if( back->color_type == COLOR_TYPE_RGB888 ) {
+		switch( back->color_type ) {
+		case COLOR_TYPE_RGB888:
 			mixer = Graph_RGBMixARGB;
-		} else {
+			break;
+		case COLOR_TYPE_PARGB8888:
+			mixer = Graph_PARGBMixARGB;
+			break;
+		default:
 			if( with_alpha ) {
 				mixer = Graph_ARGBMixARGB;
 			} else {
 				mixer = Graph_ARGBMixARGB2;
 			}
+			break;
+		}
+		break;
+	case COLOR_TYPE_PARGB8888:
+		/* 预乘 alpha 的背景总是能正确的合成 alpha 通道 */
+		switch( back->color_type ) {
+		case COLOR_TYPE_RGB888:
+			mixer = Graph_RGBMixPARGB;
+			break;
+		case COLOR_TYPE_PARGB8888:
+			mixer = Graph_PARGBMixPARGB;
+			break;
+		default:
+			if( with_alpha ) {
+				mixer = Graph_ARGBMixPARGB;
+			} else {
+				mixer = Graph_ARGBMixPARGB2;
+			}
+			break;
 		}
 	default:break;
 	}
@@ -1214,13 +2151,45 @@ int Graph_Replace( LCUI_Graph *back, const LCUI_Graph *fore, int left, int top )
 	top = read_rect.y;
 	fore = Graph_GetQuote( fore );
 	back = Graph_GetQuote( back );
+	/* 像素格式不同时需要先转换格式 */
+	if( fore->color_type != back->color_type ) {
+		Graph_FormatReplace( back, write_rect, fore, left, top );
+		return -1;
+	}
 	switch( fore->color_type ) {
 	case COLOR_TYPE_RGB888:
 		Graph_RGBReplaceRGB( back, write_rect, fore, left, top );
 		break;
 	case COLOR_TYPE_ARGB8888:
+	case COLOR_TYPE_PARGB8888:
 		Graph_ARGBReplaceARGB( back, write_rect, fore, left, top );
 	default:break;
 	}
 	return -1;
 }
+
+void LCUI_InitGraph( void )
+{
+#ifdef PIXEL_MIXER_X86
+	switch( DetectCPUFeatures() ) {
+	case 2:
+		pixel_mixer.name = "avx2";
+		pixel_mixer.blend = MixRowBlend_AVX2;
+		pixel_mixer.over = MixRowOver_AVX2;
+		pixel_mixer.over_pm = MixRowOverPM_AVX2;
+		pixel_mixer.blend_rgb = MixRowBlendRGB_AVX2;
+		pixel_mixer.over_pm_rgb = MixRowOverPMRGB_AVX2;
+		break;
+	case 1:
+		pixel_mixer.name = "sse2";
+		pixel_mixer.blend = MixRowBlend_SSE2;
+		pixel_mixer.over = MixRowOver_SSE2;
+		pixel_mixer.over_pm = MixRowOverPM_SSE2;
+		pixel_mixer.blend_rgb = MixRowBlendRGB_SSE2;
+		pixel_mixer.over_pm_rgb = MixRowOverPMRGB_SSE2;
+		break;
+	default: break;
+	}
+#endif
+	LOG( "[graph] pixel mixer: %s\n", pixel_mixer.name );
+}
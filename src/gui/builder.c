@@ -193,6 +193,7 @@ static int ParseWidget( XMLParserContext ctx, xmlNodePtr node )
 			} else {
 				w->type = strdup( prop_val );
 			}
+			w->selector_atom = LCUI_ATOM_NONE;
 			continue;
 		}
 		else if( PropNameIs("id") ) {
@@ -101,13 +101,46 @@ typedef struct StyleLinkRec_ {
 	StyleLinkGroup group;	/**< 所属组 */
 	LinkedList styles;	/**< 作用于当前选择器的样式 */
 	Dict *parents;		/**< 父级节点 */
+	LinkedList parent_links;	/**< 父级节点列表，便于在查找前用过滤器筛选 */
+	unsigned int *keys;	/**< 所属组的选择器结点在过滤器中的键 */
+	int nkeys;		/**< 键的数量 */
 } StyleLinkRec, *StyleLink;
 
+/** 样式表缓存的依赖标记，记录缓存项在某个选择器结点名称的索引中的位置 */
+typedef struct StyleCacheTagRec_ {
+	LinkedList *list;		/**< 所在的索引列表 */
+	LinkedListNode node;		/**< 在索引列表中的结点 */
+} StyleCacheTagRec, *StyleCacheTag;
+
+/** 样式表缓存项 */
+typedef struct StyleCacheRec_ {
+	LCUI_StyleSheet sheet;		/**< 计算出的样式表 */
+	LCUI_Selector selector;		/**< 选择器副本，用于判断新规则是否可能匹配 */
+	LinkedList tags;		/**< 依赖标记列表 */
+} StyleCacheRec, *StyleCache;
+
+/** 状态出现在祖先结点中的规则 */
+typedef struct StatusRuleRec_ {
+	LCUI_SelectorNode ancestor;	/**< 含有该状态的祖先结点 */
+	LCUI_SelectorNode target;	/**< 规则的最后一个结点 */
+} StatusRuleRec, *StatusRule;
+
+/** 状态依赖记录，用于在部件状态变化时确定哪些部件的样式可能受影响 */
+typedef struct StatusDependencyRec_ {
+	LinkedList targets;		/**< 含有该状态的最后一个结点，状态变化会影响部件自身 */
+	LinkedList rules;		/**< 该状态出现在祖先结点中的规则 */
+} StatusDependencyRec, *StatusDependency;
+
 static struct {
 	LCUI_BOOL is_inited;
 	LCUI_Mutex mutex;		/**< 互斥锁 */
 	LinkedList groups;		/**< 样式组列表 */
 	Dict *cache;			/**< 样式表缓存，以选择器的 hash 值索引 */
+	Dict *cache_tags;		/**< 缓存项索引，以最后一个选择器结点的名称索引 */
+	int bulk_level;			/**< 批量载入的嵌套层数 */
+	LinkedList pending_rules;	/**< 批量载入期间添加的规则的选择器 */
+	unsigned int version;		/**< 版本号，每添加一条规则就递增一次 */
+	Dict *status_index;		/**< 状态依赖索引，以状态名称索引 */
 	Dict *names;			/**< 样式属性名称表，以值的名称索引 */
 	Dict *value_keys;		/**< 样式属性值表，以值的名称索引 */
 	Dict *value_names;		/**< 样式属性值名称表，以值索引 */
@@ -130,6 +163,8 @@ static KeyNameGroupRec style_name_map[] = {
 	{ key_max_height, "max-height" },
 	{ key_display, "display" },
 	{ key_z_index, "z-index" },
+	{ key_opacity, "opacity" },
+	{ key_will_change, "will-change" },
 	{ key_top, "top" },
 	{ key_right, "right" },
 	{ key_left, "left" },
@@ -208,7 +243,8 @@ static KeyNameGroupRec style_value_map[] = {
 	{ SV_ABSOLUTE, "absolute" },
 	{ SV_BLOCK, "block" },
 	{ SV_INLINE_BLOCK, "inline-block" },
-	{ SV_NOWRAP, "nowrap" }
+	{ SV_NOWRAP, "nowrap" },
+	{ SV_OPACITY, "opacity" }
 };
 
 static int LCUI_DirectAddStyleName( int key, const char *name )
@@ -329,7 +365,7 @@ LCUI_BOOL SelectorNode_Match( LCUI_SelectorNode sn1,
 		for( i = 0; sn2->classes[i]; ++i ) {
 			for( j = 0; sn1->classes[j]; ++j ) {
 				if( strcmp( sn2->classes[i],
-					    sn1->classes[i] ) == 0 ) {
+					    sn1->classes[j] ) == 0 ) {
 					j = -1;
 					break;
 				}
@@ -346,7 +382,7 @@ LCUI_BOOL SelectorNode_Match( LCUI_SelectorNode sn1,
 		for( i = 0; sn2->status[i]; ++i ) {
 			for( j = 0; sn1->status[j]; ++j ) {
 				if( strcmp( sn2->status[i],
-					    sn1->status[i] ) == 0 ) {
+					    sn1->status[j] ) == 0 ) {
 					j = -1;
 					break;
 				}
@@ -365,6 +401,7 @@ static void SelectorNode_Copy( LCUI_SelectorNode dst, LCUI_SelectorNode src )
 	dst->id = src->id ? strdup( src->id ) : NULL;
 	dst->type = src->type ? strdup( src->type ) : NULL;
 	dst->fullname = src->fullname ? strdup( src->fullname ) : NULL;
+	dst->atom = src->atom;
 	if( src->classes ) {
 		for( i = 0; src->classes[i]; ++i ) {
 			sortedstrsadd( &dst->classes, src->classes[i] );
@@ -377,6 +414,97 @@ static void SelectorNode_Copy( LCUI_SelectorNode dst, LCUI_SelectorNode src )
 	}
 }
 
+enum SelectorFilterKeyType {
+	FILTER_KEY_TYPE,
+	FILTER_KEY_ID,
+	FILTER_KEY_CLASS,
+	FILTER_KEY_STATUS
+};
+
+#define FilterKey(NAME, TYPE) (LCUIAtom_Get( NAME ) << 2 | TYPE)
+
+int SelectorNode_GetFilterKeys( LCUI_SelectorNode sn, unsigned int **keys )
+{
+	int i, n = 0;
+	unsigned int *k;
+	LCUI_BOOL has_type;
+
+	has_type = sn->type && strcmp( sn->type, "*" ) != 0;
+	n += has_type ? 1 : 0;
+	n += sn->id ? 1 : 0;
+	for( i = 0; sn->classes && sn->classes[i]; ++i, ++n );
+	for( i = 0; sn->status && sn->status[i]; ++i, ++n );
+	*keys = NULL;
+	if( n == 0 ) {
+		return 0;
+	}
+	k = NEW( unsigned int, n );
+	if( !k ) {
+		return -ENOMEM;
+	}
+	*keys = k;
+	if( has_type ) {
+		*k++ = FilterKey( sn->type, FILTER_KEY_TYPE );
+	}
+	if( sn->id ) {
+		*k++ = FilterKey( sn->id, FILTER_KEY_ID );
+	}
+	for( i = 0; sn->classes && sn->classes[i]; ++i ) {
+		*k++ = FilterKey( sn->classes[i], FILTER_KEY_CLASS );
+	}
+	for( i = 0; sn->status && sn->status[i]; ++i ) {
+		*k++ = FilterKey( sn->status[i], FILTER_KEY_STATUS );
+	}
+	return n;
+}
+
+/** 由键计算出两个计数器的位置 */
+#define SelectorFilter_Hash(KEY) ((KEY) * 2654435761U)
+#define SelectorFilter_Index1(H) ((H) >> (32 - SELECTOR_FILTER_BITS))
+#define SelectorFilter_Index2(H) ((H) & (SELECTOR_FILTER_SIZE - 1))
+
+void SelectorFilter_Init( LCUI_SelectorFilter filter )
+{
+	memset( filter->counts, 0, sizeof( filter->counts ) );
+}
+
+static void SelectorFilter_Increase( unsigned char *count )
+{
+	if( *count < 0xff ) {
+		*count += 1;
+	}
+}
+
+/** 计数器达到上限后便不再减少，以免把其它键的计数也减掉 */
+static void SelectorFilter_Decrease( unsigned char *count )
+{
+	if( *count > 0 && *count < 0xff ) {
+		*count -= 1;
+	}
+}
+
+void SelectorFilter_Add( LCUI_SelectorFilter filter, unsigned int key )
+{
+	unsigned int hash = SelectorFilter_Hash( key );
+	SelectorFilter_Increase( &filter->counts[SelectorFilter_Index1( hash )] );
+	SelectorFilter_Increase( &filter->counts[SelectorFilter_Index2( hash )] );
+}
+
+void SelectorFilter_Remove( LCUI_SelectorFilter filter, unsigned int key )
+{
+	unsigned int hash = SelectorFilter_Hash( key );
+	SelectorFilter_Decrease( &filter->counts[SelectorFilter_Index1( hash )] );
+	SelectorFilter_Decrease( &filter->counts[SelectorFilter_Index2( hash )] );
+}
+
+LCUI_BOOL SelectorFilter_MayContain( LCUI_SelectorFilter filter,
+				     unsigned int key )
+{
+	unsigned int hash = SelectorFilter_Hash( key );
+	return filter->counts[SelectorFilter_Index1( hash )] > 0 &&
+		filter->counts[SelectorFilter_Index2( hash )] > 0;
+}
+
 void SelectorNode_Delete( LCUI_SelectorNode node )
 {
 	if( node->type ) {
@@ -827,21 +955,28 @@ int SelectorNode_Update( LCUI_SelectorNode node )
 		free( node->fullname );
 	}
 	node->fullname = fullname;
+	node->atom = LCUIAtom_Get( fullname );
 	return len;
 }
 
-void Selector_Update( LCUI_Selector s )
+unsigned int Selector_GetHash( const LCUI_Atom *atoms, int length )
 {
 	int i;
-	const unsigned char *p;
 	unsigned int hash = 5381;
+	for( i = 0; i < length; ++i ) {
+		hash = ((hash << 5) + hash) + atoms[i];
+	}
+	return hash;
+}
+
+void Selector_Update( LCUI_Selector s )
+{
+	int i;
+	LCUI_Atom atoms[MAX_SELECTOR_DEPTH];
 	for( i = 0; i < s->length; ++i ) {
-		p = (unsigned char*)s->nodes[i]->fullname;
-		while( *p ) {
-			hash = ((hash << 5) + hash) + (*p++);
-		}
+		atoms[i] = s->nodes[i]->atom;
 	}
-	s->hash = hash;
+	s->hash = Selector_GetHash( atoms, s->length );
 }
 
 LCUI_Selector Selector( const char *selector )
@@ -966,12 +1101,38 @@ static void DeleteStyleNode( StyleNode node )
 	node->sheet = NULL;
 }
 
+/** 以原子为键的字典，原子直接存放在键指针中，不需要额外分配内存 */
+static unsigned int AtomKeyDict_HashFunction( const void *key )
+{
+	return Dict_IntHashFunction( (unsigned int)(size_t)key );
+}
+
+static int AtomKeyDict_KeyCompare( void *privdata,
+				   const void *key1, const void *key2 )
+{
+	return key1 == key2;
+}
+
+static DictType DictType_AtomKey = {
+	AtomKeyDict_HashFunction,
+	NULL,
+	NULL,
+	AtomKeyDict_KeyCompare,
+	NULL,
+	NULL
+};
+
+#define AtomKey(ATOM) ((void*)(size_t)(ATOM))
+
 static StyleLink CreateStyleLink( void )
 {
 	StyleLink link = NEW( StyleLinkRec, 1 );
 	link->group = NULL;
 	LinkedList_Init( &link->styles );
-	link->parents = Dict_Create( &DictType_StringCopyKey, NULL );
+	LinkedList_Init( &link->parent_links );
+	link->parents = Dict_Create( &DictType_AtomKey, NULL );
+	link->keys = NULL;
+	link->nkeys = 0;
 	return link;
 }
 
@@ -980,6 +1141,11 @@ static void DeleteStyleLink( StyleLink link )
 	link->group = NULL;
 	Dict_Release( link->parents );
 	link->parents = NULL;
+	LinkedList_Clear( &link->parent_links, NULL );
+	if( link->keys ) {
+		free( link->keys );
+		link->keys = NULL;
+	}
 	LinkedList_Clear( &link->styles, (FuncPtr)DeleteStyleNode );
 }
 
@@ -1018,7 +1184,7 @@ static Dict *CreateStyleGroup( void )
 {
 	Dict *dict;
 	DictType *dtype = NEW( DictType, 1 );
-	*dtype = DictType_StringCopyKey;
+	*dtype = DictType_AtomKey;
 	dtype->valDestructor = OnDeleteStyleLinkGroup;
 	dict = Dict_Create( dtype, dtype );
 	return dict;
@@ -1036,17 +1202,17 @@ static LCUI_StyleSheet LCUI_SelectStyleSheet( LCUI_Selector selector,
 					      const char *space )
 {
 	int i, right;
-	StyleLink link;
 	StyleNode snode;
 	StyleLinkGroup slg;
 	LinkedListNode *node;
 	LCUI_SelectorNode sn;
-	Dict *group, *parents;
+	Dict *group;
+	StyleLink link, prev;
 	char buf[MAX_SELECTOR_LEN];
 	char fullname[MAX_SELECTOR_LEN];
 
 	link = NULL;
-	parents = NULL;
+	prev = NULL;
 	for( i = 0, right = selector->length - 1; right >= 0; --right, ++i ) {
 		group = LinkedList_Get( &library.groups, i );
 		if( !group ) {
@@ -1054,10 +1220,10 @@ static LCUI_StyleSheet LCUI_SelectStyleSheet( LCUI_Selector selector,
 			LinkedList_Append( &library.groups, group );
 		}
 		sn = selector->nodes[right];
-		slg = Dict_FetchValue( group, sn->fullname );
+		slg = Dict_FetchValue( group, AtomKey( sn->atom ) );
 		if( !slg ) {
 			slg = CreateStyleLinkGroup( sn );
-			Dict_Add( group, sn->fullname, slg );
+			Dict_Add( group, AtomKey( sn->atom ), slg );
 		}
 		if( i == 0 ) {
 			strcpy( fullname, "*" );
@@ -1069,6 +1235,11 @@ static LCUI_StyleSheet LCUI_SelectStyleSheet( LCUI_Selector selector,
 			link = CreateStyleLink();
 			link->group = slg;
 			link->selector = strdup( fullname );
+			link->nkeys = SelectorNode_GetFilterKeys( &slg->snode,
+								  &link->keys );
+			if( link->nkeys < 0 ) {
+				link->nkeys = 0;
+			}
 			Dict_Add( slg->links, fullname, link );
 		}
 		if( i == 0 ) {
@@ -1079,12 +1250,13 @@ static LCUI_StyleSheet LCUI_SelectStyleSheet( LCUI_Selector selector,
 			sprintf( buf, "%s %s", sn->fullname, fullname );
 		}
 		/* 如果有上一级的父链接记录，则将当前链接添加进去 */
-		if( parents ) {
-			if( !Dict_FetchValue( parents, sn->fullname ) ) {
-				Dict_Add( parents, sn->fullname, link );
+		if( prev ) {
+			if( !Dict_FetchValue( prev->parents, AtomKey( sn->atom ) ) ) {
+				Dict_Add( prev->parents, AtomKey( sn->atom ), link );
+				LinkedList_Append( &prev->parent_links, link );
 			}
 		}
-		parents = link->parents;
+		prev = link;
 	}
 	if( !link ) {
 		return NULL;
@@ -1116,20 +1288,324 @@ static LCUI_StyleSheet LCUI_SelectStyleSheet( LCUI_Selector selector,
 	return snode->sheet;
 }
 
+static LCUI_Selector Selector_Copy( LCUI_Selector s )
+{
+	int i;
+	LCUI_Selector s2 = NEW( LCUI_SelectorRec, 1 );
+	s2->rank = s->rank;
+	s2->hash = s->hash;
+	s2->length = s->length;
+	s2->batch_num = s->batch_num;
+	s2->nodes = NEW( LCUI_SelectorNode, MAX_SELECTOR_DEPTH );
+	for( i = 0; i < s->length; ++i ) {
+		s2->nodes[i] = NEW( LCUI_SelectorNodeRec, 1 );
+		SelectorNode_Copy( s2->nodes[i], s->nodes[i] );
+		s2->nodes[i]->rank = s->nodes[i]->rank;
+	}
+	s2->nodes[i] = NULL;
+	return s2;
+}
+
+static void DeleteStyleCacheTag( void *arg )
+{
+	StyleCacheTag tag = arg;
+	LinkedList_Unlink( tag->list, &tag->node );
+	free( tag );
+}
+
+static void DeleteStyleCache( StyleCache cache )
+{
+	LinkedList_Clear( &cache->tags, DeleteStyleCacheTag );
+	Selector_Delete( cache->selector );
+	StyleSheet_Delete( cache->sheet );
+	free( cache );
+}
+
+/** 将缓存项添加到名称索引中 */
+static void StyleCache_AddTag( StyleCache cache, const char *name )
+{
+	LinkedList *list;
+	StyleCacheTag tag;
+	list = Dict_FetchValue( library.cache_tags, name );
+	if( !list ) {
+		list = NEW( LinkedList, 1 );
+		LinkedList_Init( list );
+		Dict_Add( library.cache_tags, (void*)name, list );
+	}
+	tag = NEW( StyleCacheTagRec, 1 );
+	tag->list = list;
+	tag->node.data = cache;
+	LinkedList_AppendNode( list, &tag->node );
+	LinkedList_Append( &cache->tags, tag );
+}
+
+/**
+ * 创建样式表缓存项
+ * 规则的最后一个选择器结点只有在它的名称属于选择器的最后一个结点时才可能匹配，
+ * 所以用这些名称给缓存项做标记，添加规则时只需检查标记了该名称的缓存项
+ */
+static StyleCache CreateStyleCache( LCUI_Selector s, LCUI_StyleSheet ss )
+{
+	LinkedList names;
+	LinkedListNode *node;
+	StyleCache cache = NEW( StyleCacheRec, 1 );
+	cache->sheet = ss;
+	cache->selector = Selector_Copy( s );
+	LinkedList_Init( &cache->tags );
+	LinkedList_Init( &names );
+	if( s->length > 0 ) {
+		SelectorNode_GetNames( s->nodes[s->length - 1], &names );
+	}
+	LinkedList_Append( &names, strdup( "*" ) );
+	for( LinkedList_Each( node, &names ) ) {
+		StyleCache_AddTag( cache, node->data );
+	}
+	LinkedList_Clear( &names, free );
+	return cache;
+}
+
+/** 判断规则的父级选择器结点是否能依次在选择器的父级结点中找到 */
+static LCUI_BOOL Selector_MatchParents( LCUI_Selector s, LCUI_Selector rule )
+{
+	int i = s->length - 2, j = rule->length - 2;
+	for( ; j >= 0; --j ) {
+		while( i >= 0 && !SelectorNode_Match( s->nodes[i],
+						      rule->nodes[j] ) ) {
+			--i;
+		}
+		if( i < 0 ) {
+			return FALSE;
+		}
+		--i;
+	}
+	return TRUE;
+}
+
+/** 删除可能受新规则影响的样式表缓存 */
+static void LCUI_InvalidateStyleCache( LCUI_Selector rule )
+{
+	LinkedList *list;
+	StyleCache cache;
+	LinkedList hashes;
+	LinkedListNode *node;
+	unsigned int *hash;
+	const char *name;
+
+	if( rule->length < 1 ) {
+		return;
+	}
+	name = rule->nodes[rule->length - 1]->fullname;
+	if( !name ) {
+		return;
+	}
+	list = Dict_FetchValue( library.cache_tags, name );
+	if( !list ) {
+		return;
+	}
+	/* 删除缓存项会改动索引列表，所以先记下需要删除的缓存项 */
+	LinkedList_Init( &hashes );
+	for( LinkedList_Each( node, list ) ) {
+		cache = node->data;
+		if( Selector_MatchParents( cache->selector, rule ) ) {
+			hash = NEW( unsigned int, 1 );
+			*hash = cache->selector->hash;
+			LinkedList_Append( &hashes, hash );
+		}
+	}
+	for( LinkedList_Each( node, &hashes ) ) {
+		Dict_Delete( library.cache, node->data );
+	}
+	LinkedList_Clear( &hashes, free );
+}
+
+void LCUI_BeginLoadStyleSheets( void )
+{
+	LCUIMutex_Lock( &library.mutex );
+	library.bulk_level += 1;
+	LCUIMutex_Unlock( &library.mutex );
+}
+
+void LCUI_EndLoadStyleSheets( void )
+{
+	LinkedListNode *node;
+	LCUIMutex_Lock( &library.mutex );
+	if( library.bulk_level < 1 || --library.bulk_level > 0 ) {
+		LCUIMutex_Unlock( &library.mutex );
+		return;
+	}
+	for( LinkedList_Each( node, &library.pending_rules ) ) {
+		LCUI_InvalidateStyleCache( node->data );
+	}
+	LinkedList_Clear( &library.pending_rules, (FuncPtr)Selector_Delete );
+	LCUIMutex_Unlock( &library.mutex );
+}
+
+static LCUI_SelectorNode SelectorNode_Duplicate( LCUI_SelectorNode sn )
+{
+	LCUI_SelectorNode node = NEW( LCUI_SelectorNodeRec, 1 );
+	SelectorNode_Copy( node, sn );
+	node->rank = sn->rank;
+	return node;
+}
+
+static void DeleteStatusRule( void *arg )
+{
+	StatusRule rule = arg;
+	SelectorNode_Delete( rule->ancestor );
+	SelectorNode_Delete( rule->target );
+	free( rule );
+}
+
+static void DeleteStatusDependency( void *privdata, void *val )
+{
+	StatusDependency dep = val;
+	LinkedList_Clear( &dep->targets, (FuncPtr)SelectorNode_Delete );
+	LinkedList_Clear( &dep->rules, DeleteStatusRule );
+	free( dep );
+}
+
+/** 判断列表中是否已有相同的选择器结点 */
+static LCUI_BOOL SelectorNodeList_Has( LinkedList *list, LCUI_SelectorNode sn )
+{
+	LinkedListNode *node;
+	for( LinkedList_Each( node, list ) ) {
+		if( ((LCUI_SelectorNode)node->data)->atom == sn->atom ) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+static void StatusDependency_AddRule( StatusDependency dep,
+				      LCUI_SelectorNode ancestor,
+				      LCUI_SelectorNode target )
+{
+	StatusRule rule;
+	LinkedListNode *node;
+	for( LinkedList_Each( node, &dep->rules ) ) {
+		rule = node->data;
+		if( rule->ancestor->atom == ancestor->atom &&
+		    rule->target->atom == target->atom ) {
+			return;
+		}
+	}
+	rule = NEW( StatusRuleRec, 1 );
+	rule->ancestor = SelectorNode_Duplicate( ancestor );
+	rule->target = SelectorNode_Duplicate( target );
+	LinkedList_Append( &dep->rules, rule );
+}
+
+/** 将规则中出现的状态记录到状态依赖索引中 */
+static void LCUI_IndexStatus( LCUI_Selector selector )
+{
+	int i, j;
+	StatusDependency dep;
+	LCUI_SelectorNode sn, target;
+
+	if( selector->length < 1 ) {
+		return;
+	}
+	target = selector->nodes[selector->length - 1];
+	for( i = 0; i < selector->length; ++i ) {
+		sn = selector->nodes[i];
+		for( j = 0; sn->status && sn->status[j]; ++j ) {
+			dep = Dict_FetchValue( library.status_index,
+					       sn->status[j] );
+			if( !dep ) {
+				dep = NEW( StatusDependencyRec, 1 );
+				LinkedList_Init( &dep->targets );
+				LinkedList_Init( &dep->rules );
+				Dict_Add( library.status_index,
+					  sn->status[j], dep );
+			}
+			if( sn != target ) {
+				StatusDependency_AddRule( dep, sn, target );
+			} else if( !SelectorNodeList_Has( &dep->targets, sn ) ) {
+				LinkedList_Append( &dep->targets,
+						   SelectorNode_Duplicate( sn ) );
+			}
+		}
+	}
+}
+
+LCUI_BOOL LCUI_CheckStatusDependency( const char *status,
+				      LCUI_SelectorNode sn )
+{
+	StatusDependency dep;
+	LinkedListNode *node;
+	LCUI_BOOL result = FALSE;
+
+	LCUIMutex_Lock( &library.mutex );
+	dep = Dict_FetchValue( library.status_index, status );
+	if( dep ) {
+		for( LinkedList_Each( node, &dep->targets ) ) {
+			if( SelectorNode_Match( sn, node->data ) ) {
+				result = TRUE;
+				break;
+			}
+		}
+	}
+	LCUIMutex_Unlock( &library.mutex );
+	return result;
+}
+
+int LCUI_GetStatusDependents( const char *status, LCUI_SelectorNode sn,
+			      LinkedList *nodes )
+{
+	int count = 0;
+	StatusRule rule;
+	StatusDependency dep;
+	LinkedListNode *node;
+
+	LCUIMutex_Lock( &library.mutex );
+	dep = Dict_FetchValue( library.status_index, status );
+	if( !dep ) {
+		LCUIMutex_Unlock( &library.mutex );
+		return 0;
+	}
+	for( LinkedList_Each( node, &dep->rules ) ) {
+		rule = node->data;
+		if( !SelectorNode_Match( sn, rule->ancestor ) ||
+		    SelectorNodeList_Has( nodes, rule->target ) ) {
+			continue;
+		}
+		LinkedList_Append( nodes, SelectorNode_Duplicate( rule->target ) );
+		++count;
+	}
+	LCUIMutex_Unlock( &library.mutex );
+	return count;
+}
+
 int LCUI_PutStyleSheet( LCUI_Selector selector,
 			LCUI_StyleSheet in_ss, const char *space )
 {
 	LCUI_StyleSheet ss;
 	LCUIMutex_Lock( &library.mutex );
-	Dict_Empty( library.cache );
+	if( library.bulk_level > 0 ) {
+		LinkedList_Append( &library.pending_rules,
+				   Selector_Copy( selector ) );
+	} else {
+		LCUI_InvalidateStyleCache( selector );
+	}
 	ss = LCUI_SelectStyleSheet( selector, space );
 	if( ss ) {
 		StyleSheet_Replace( ss, in_ss );
 	}
+	LCUI_IndexStatus( selector );
+	library.version += 1;
 	LCUIMutex_Unlock( &library.mutex );
 	return 0;
 }
 
+unsigned int LCUI_GetStyleSheetVersion( void )
+{
+	unsigned int version;
+	LCUIMutex_Lock( &library.mutex );
+	version = library.version;
+	LCUIMutex_Unlock( &library.mutex );
+	return version;
+}
+
 static int StyleLink_GetStyleSheets( StyleLink link, LinkedList *outlist )
 {
 	StyleNode snode, out_snode;
@@ -1166,41 +1642,140 @@ static int StyleLink_GetStyleSheets( StyleLink link, LinkedList *outlist )
 	return link->styles.length;
 }
 
-static int LCUI_FindStyleSheetFromLink( StyleLink link, LCUI_Selector s,
-					int i, LinkedList *list )
+/** 选择器结点可被匹配的名称的原子列表，只包含已登记的名称 */
+typedef struct NameAtomsRec_ {
+	int length;			/**< 原子数量，为 -1 时表示还未生成 */
+	LCUI_Atom *atoms;
+} NameAtomsRec, *NameAtoms;
+
+/** 样式表查找器 */
+typedef struct StyleFinderRec_ {
+	LCUI_Selector selector;		/**< 选择器 */
+	LCUI_SelectorFilter filter;	/**< 祖先选择器过滤器，可以为 NULL */
+	NameAtomsRec names[MAX_SELECTOR_DEPTH];	/**< 各个结点的名称，按需生成 */
+	LinkedList *list;		/**< 找到的样式表列表 */
+} StyleFinderRec, *StyleFinder;
+
+/**
+ * 使用过滤器时，若父级链接的数量不超过剩余祖先数量的这个倍数，则逐个筛选父级
+ * 链接，否则按祖先的名称查找父级链接
+ */
+#define STYLE_LINK_SCAN_FACTOR	16
+
+static void NameAtoms_Init( NameAtoms names, LCUI_SelectorNode sn )
 {
-	int count = 0;
+	LCUI_Atom atom;
+	LinkedList list;
+	LinkedListNode *node;
+	LinkedList_Init( &list );
+	SelectorNode_GetNames( sn, &list );
+	names->length = 0;
+	names->atoms = NEW( LCUI_Atom, list.length + 1 );
+	for( LinkedList_Each( node, &list ) ) {
+		atom = LCUIAtom_Find( node->data );
+		if( atom != LCUI_ATOM_NONE && names->atoms ) {
+			names->atoms[names->length++] = atom;
+		}
+	}
+	LinkedList_Clear( &list, free );
+}
+
+static LCUI_BOOL NameAtoms_Has( NameAtoms names, LCUI_Atom atom )
+{
+	int i;
+	for( i = 0; i < names->length; ++i ) {
+		if( names->atoms[i] == atom ) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/** 获取选择器中第 i 个结点的名称，名称的生成开销较大，所以只在用到时生成 */
+static NameAtoms StyleFinder_GetNames( StyleFinder finder, int i )
+{
+	if( finder->names[i].length < 0 ) {
+		NameAtoms_Init( &finder->names[i], finder->selector->nodes[i] );
+	}
+	return &finder->names[i];
+}
+
+/** 判断样式链接所属的选择器结点是否可能与某个祖先匹配 */
+static LCUI_BOOL StyleLink_MayMatch( StyleLink link,
+				     LCUI_SelectorFilter filter )
+{
+	int i;
+	for( i = 0; i < link->nkeys; ++i ) {
+		if( !SelectorFilter_MayContain( filter, link->keys[i] ) ) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+static int LCUI_FindStyleSheetFromLink( StyleFinder finder,
+					StyleLink link, int i )
+{
+	int j, count = 0;
+	NameAtoms names;
 	StyleLink parent;
-	LinkedList names;
 	LinkedListNode *node;
-	LCUI_SelectorNode sn;
 
-	LinkedList_Init( &names );
-	count += StyleLink_GetStyleSheets( link, list );
+	count += StyleLink_GetStyleSheets( link, finder->list );
+	/*
+	 * 父级链接不多时，逐个用过滤器排除掉在祖先中一定不存在的，剩下的才与祖先
+	 * 的名称比较，这样大部分父级链接不需要字典查找，祖先的名称也不用生成
+	 */
+	if( finder->filter &&
+	    link->parent_links.length <= i * STYLE_LINK_SCAN_FACTOR ) {
+		for( LinkedList_Each( node, &link->parent_links ) ) {
+			parent = node->data;
+			if( !StyleLink_MayMatch( parent, finder->filter ) ) {
+				continue;
+			}
+			for( j = i - 1; j >= 0; --j ) {
+				/* 先比较结点的各个属性，不满足的就不必生成名称 */
+				if( !SelectorNode_Match( finder->selector->nodes[j],
+							 &parent->group->snode ) ) {
+					continue;
+				}
+				names = StyleFinder_GetNames( finder, j );
+				if( !NameAtoms_Has( names,
+						    parent->group->snode.atom ) ) {
+					continue;
+				}
+				count += LCUI_FindStyleSheetFromLink( finder,
+								      parent, j );
+			}
+		}
+		return count;
+	}
 	while( --i >= 0 ) {
-		sn = s->nodes[i];
-		SelectorNode_GetNames( sn, &names );
-		for( LinkedList_Each( node, &names ) ) {
-			parent = Dict_FetchValue( link->parents, node->data );
+		names = StyleFinder_GetNames( finder, i );
+		for( j = 0; j < names->length; ++j ) {
+			parent = Dict_FetchValue( link->parents,
+						  AtomKey( names->atoms[j] ) );
 			if( !parent ) {
 				continue;
 			}
-			count += LCUI_FindStyleSheetFromLink( parent, s,
-							      i, list );
+			count += LCUI_FindStyleSheetFromLink( finder,
+							      parent, i );
 		}
-		LinkedList_Clear( &names, free );
 	}
 	return count;
 }
 
-int LCUI_FindStyleSheetFromGroup( int group, const char *name, 
-				  LCUI_Selector s, LinkedList *list )
+static int FindStyleSheetFromGroup( int group, const char *name,
+				    LCUI_Selector s,
+				    LCUI_SelectorFilter filter,
+				    LinkedList *list )
 {
-	int i, count;
+	int i, j, count;
 	Dict *groups;
 	StyleLinkGroup slg;
-	LinkedListNode *node;
-	LinkedList names;
+	StyleFinderRec finder;
+	LCUI_Atom atom, *atoms;
+	int n_atoms;
 
 	groups = LinkedList_Get( &library.groups, group );
 	if( !groups || s->length < 1 ) {
@@ -1208,33 +1783,52 @@ int LCUI_FindStyleSheetFromGroup( int group, const char *name,
 	}
 	count = 0;
 	i = s->length - 1;
-	LinkedList_Init( &names );
+	finder.selector = s;
+	finder.filter = filter;
+	finder.list = list;
+	for( j = 0; j <= i; ++j ) {
+		finder.names[j].length = -1;
+		finder.names[j].atoms = NULL;
+	}
 	if( name ) {
-		LinkedList_Append( &names, strdup( name ) );
+		atom = LCUIAtom_Find( name );
+		n_atoms = atom != LCUI_ATOM_NONE ? 1 : 0;
+		atoms = &atom;
 	} else {
-		SelectorNode_GetNames( s->nodes[i], &names );
-		LinkedList_Append( &names, strdup( "*" ) );
+		NameAtoms_Init( &finder.names[i], s->nodes[i] );
+		atom = LCUIAtom_Find( "*" );
+		if( atom != LCUI_ATOM_NONE && finder.names[i].atoms ) {
+			finder.names[i].atoms[finder.names[i].length++] = atom;
+		}
+		n_atoms = finder.names[i].length;
+		atoms = finder.names[i].atoms;
 	}
-	for( LinkedList_Each( node, &names ) ) {
+	for( j = 0; j < n_atoms; ++j ) {
 		DictEntry *entry;
 		DictIterator *iter;
-		char *name = node->data;
-		slg = Dict_FetchValue( groups, name );
+		slg = Dict_FetchValue( groups, AtomKey( atoms[j] ) );
 		if( !slg ) {
 			continue;
 		}
 		iter = Dict_GetIterator( slg->links );
 		while( (entry = Dict_Next( iter )) ) {
 			StyleLink link = DictEntry_GetVal( entry );
-			count += LCUI_FindStyleSheetFromLink( link, s, 
-							      i, list );
+			count += LCUI_FindStyleSheetFromLink( &finder, link, i );
 		}
 		Dict_ReleaseIterator( iter );
 	}
-	LinkedList_Clear( &names, free );
+	for( j = 0; j <= i; ++j ) {
+		free( finder.names[j].atoms );
+	}
 	return count;
 }
 
+int LCUI_FindStyleSheetFromGroup( int group, const char *name, 
+				  LCUI_Selector s, LinkedList *list )
+{
+	return FindStyleSheetFromGroup( group, name, s, NULL, list );
+}
+
 void LCUI_PrintStyleSheet( LCUI_StyleSheet ss )
 {
 	int key;
@@ -1355,35 +1949,63 @@ void LCUI_PrintCSSLibrary( void )
 	LOG( "style library end\n" );
 }
 
-void LCUI_GetStyleSheet( LCUI_Selector s, LCUI_StyleSheet out_ss )
+void LCUI_GetStyleSheetWithFilter( LCUI_Selector s,
+				   LCUI_SelectorFilter filter,
+				   LCUI_StyleSheet out_ss )
 {
 	LinkedList list;
 	LinkedListNode *node;
 	LCUI_StyleSheet ss;
+	StyleCache cache;
 	LinkedList_Init( &list );
 	StyleSheet_Clear( out_ss );
 	LCUIMutex_Lock( &library.mutex );
-	ss = Dict_FetchValue( library.cache, &s->hash );
-	if( ss ) {
-		StyleSheet_Replace( out_ss, ss );
+	cache = Dict_FetchValue( library.cache, &s->hash );
+	if( cache ) {
+		StyleSheet_Replace( out_ss, cache->sheet );
 		LCUIMutex_Unlock( &library.mutex );
 		return;
 	}
 	ss = StyleSheet();
-	LCUI_FindStyleSheet( s, &list );
+	FindStyleSheetFromGroup( 0, NULL, s, filter, &list );
 	for( LinkedList_Each( node, &list ) ) {
 		StyleNode sn = node->data;
 		StyleSheet_Merge( ss, sn->sheet );
 	}
 	LinkedList_Clear( &list, NULL );
-	Dict_Add( library.cache, &s->hash, ss );
+	Dict_Add( library.cache, &s->hash, CreateStyleCache( s, ss ) );
 	StyleSheet_Replace( out_ss, ss );
 	LCUIMutex_Unlock( &library.mutex );
 }
 
+void LCUI_GetStyleSheet( LCUI_Selector s, LCUI_StyleSheet out_ss )
+{
+	LCUI_GetStyleSheetWithFilter( s, NULL, out_ss );
+}
+
+int LCUI_GetCachedStyleSheet( unsigned int hash, LCUI_StyleSheet out_ss )
+{
+	StyleCache cache;
+	LCUIMutex_Lock( &library.mutex );
+	cache = Dict_FetchValue( library.cache, &hash );
+	if( !cache ) {
+		LCUIMutex_Unlock( &library.mutex );
+		return -1;
+	}
+	StyleSheet_Clear( out_ss );
+	StyleSheet_Replace( out_ss, cache->sheet );
+	LCUIMutex_Unlock( &library.mutex );
+	return 0;
+}
+
 static void DestroyStyleSheetCache( void *privdata, void *val )
 {
-	StyleSheet_Delete( val );
+	DeleteStyleCache( val );
+}
+
+static void DestroyStyleCacheTags( void *privdata, void *val )
+{
+	free( val );
 }
 
 static void DestroyStyleName( void *privdata, void *val )
@@ -1417,7 +2039,7 @@ static void *IntKeyDict_KeyDup( void *privdata, const void *key )
 void LCUI_InitCSSLibrary( void )
 {
 	KeyNameGroup skn, skn_end;
-	static DictType cachedict, namedict;
+	static DictType cachedict, namedict, tagdict, statusdict;
 	cachedict.keyDup = IntKeyDict_KeyDup;
 	cachedict.keyCompare = IntKeyDict_KeyCompare;
 	cachedict.hashFunction = IntKeyDict_HashFunction;
@@ -1431,6 +2053,14 @@ void LCUI_InitCSSLibrary( void )
 	namedict.valDestructor = DestroyStyleName;
 	library.names = Dict_Create( &namedict, NULL );
 	library.cache = Dict_Create( &cachedict, NULL );
+	tagdict = DictType_StringCopyKey;
+	tagdict.valDestructor = DestroyStyleCacheTags;
+	library.cache_tags = Dict_Create( &tagdict, NULL );
+	statusdict = DictType_StringCopyKey;
+	statusdict.valDestructor = DeleteStatusDependency;
+	library.status_index = Dict_Create( &statusdict, NULL );
+	library.bulk_level = 0;
+	LinkedList_Init( &library.pending_rules );
 	library.value_names = Dict_Create( &namedict, NULL );
 	library.value_keys = Dict_Create( &DictType_StringKey, NULL );
 	LinkedList_Init( &library.groups );
@@ -1452,6 +2082,9 @@ void LCUI_ExitCSSLibrary( void )
 	library.is_inited = FALSE;
 	Dict_Release( library.names );
 	Dict_Release( library.cache );
+	Dict_Release( library.cache_tags );
+	Dict_Release( library.status_index );
+	LinkedList_Clear( &library.pending_rules, (FuncPtr)Selector_Delete );
 	Dict_Release( library.value_keys );
 	Dict_Release( library.value_names );
 	LCUIMutex_Destroy( &library.mutex );
@@ -586,6 +586,7 @@ static LCUI_StyleParserRec style_parser_map[] = {
 	{ key_left, NULL, OnParseNumber },
 	{ key_z_index, NULL, OnParseValue },
 	{ key_opacity, NULL, OnParseNumber },
+	{ key_will_change, NULL, OnParseStyleOption },
 	{ key_position, NULL, OnParseStyleOption },
 	{ key_visible, NULL, OnParseBoolean },
 	{ key_vertical_align, NULL, OnParseStyleOption },
@@ -819,12 +820,14 @@ int LCUI_LoadCSSFile( const char *filepath )
 		return -1;
 	}
 	ctx = NewCSSParserContext( 512, filepath );
+	LCUI_BeginLoadStyleSheets();
 	n = fread( buff, 1, 511, fp );
 	while( n > 0 ) {
 		buff[n] = 0;
 		LCUI_LoadCSSBlock( ctx, buff );
 		n = fread( buff, 1, 511, fp );
 	}
+	LCUI_EndLoadStyleSheets();
 	DeleteCSSParserContext( &ctx );
 	fclose( fp );
 	return 0;
@@ -837,9 +840,11 @@ int LCUI_LoadCSSString( const char *str, const char *space )
 	CSSParserContext ctx;
 	DEBUG_MSG("parse begin\n");
 	ctx = NewCSSParserContext( 512, space );
+	LCUI_BeginLoadStyleSheets();
 	for( cur = str; len > 0; cur += len ) {
 		len = LCUI_LoadCSSBlock( ctx, cur );
 	}
+	LCUI_EndLoadStyleSheets();
 	DeleteCSSParserContext( &ctx );
 	DEBUG_MSG("parse end\n");
 	return 0;
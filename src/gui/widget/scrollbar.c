@@ -253,7 +253,6 @@ static void Slider_OnMouseMove( LCUI_Widget slider,
 			}
 		}
 		layer_pos = layer_pos * n;
-		SetStyle( layer->custom_style, key_left, -layer_pos, px );
 	} else {
 		x = 0;
 		y = scrollbar->slider_y;
@@ -278,7 +277,6 @@ static void Slider_OnMouseMove( LCUI_Widget slider,
 			}
 		}
 		layer_pos = layer_pos * n;
-		SetStyle( layer->custom_style, key_top, -layer_pos, px );
 	}
 	if( scrollbar->pos != layer_pos ) {
 		LCUI_WidgetEventRec e;
@@ -287,7 +285,11 @@ static void Slider_OnMouseMove( LCUI_Widget slider,
 		Widget_TriggerEvent( layer, &e, &layer_pos );
 	}
 	scrollbar->pos = layer_pos;
-	Widget_UpdateStyle( layer, FALSE );
+	if( scrollbar->direction == SBD_HORIZONTAL ) {
+		Widget_ScrollLeft( layer, -layer_pos );
+	} else {
+		Widget_ScrollTop( layer, -layer_pos );
+	}
 	Widget_Move( slider, x, y );
 }
 
@@ -555,7 +557,6 @@ void ScrollBar_SetPosition( LCUI_Widget w, int pos )
 		slider_pos = w->box.content.width - slider->width;
 		slider_pos = slider_pos * pos / (size - box_size);
 		SetStyle( slider->custom_style, key_left, slider_pos, px );
-		SetStyle( layer->custom_style, key_left, -pos, px );
 	} else {
 		size = scrollbar->layer->box.outer.height;
 		if( scrollbar->box ) {
@@ -576,7 +577,6 @@ void ScrollBar_SetPosition( LCUI_Widget w, int pos )
 			slider_pos = slider_pos * pos / (size - box_size);
 		}
 		SetStyle( slider->custom_style, key_top, slider_pos, px );
-		SetStyle( layer->custom_style, key_top, -pos, px );
 	}
 	if( scrollbar->pos != pos ) {
 		LCUI_WidgetEventRec e;
@@ -586,7 +586,12 @@ void ScrollBar_SetPosition( LCUI_Widget w, int pos )
 	}
 	scrollbar->pos = pos;
 	Widget_UpdateStyle( slider, FALSE );
-	Widget_UpdateStyle( layer, FALSE );
+	/* 只是平移内容层，已绘制的内容可以直接平移 */
+	if( scrollbar->direction == SBD_HORIZONTAL ) {
+		Widget_ScrollLeft( layer, -pos );
+	} else {
+		Widget_ScrollTop( layer, -pos );
+	}
 }
 
 void ScrollBar_SetDirection( LCUI_Widget w, int direction )
@@ -244,7 +244,7 @@ static void Widget_Init( LCUI_Widget widget )
 	widget->trigger = EventTrigger();
 	widget->style = StyleSheet();
 	widget->custom_style = StyleSheet();
-	widget->inherited_style = StyleSheet();
+	Widget_InitInheritedStyle( widget );
 	widget->computed_style.opacity = 1.0;
 	widget->computed_style.visible = TRUE;
 	widget->computed_style.focusable = FALSE;
@@ -265,7 +265,8 @@ static void Widget_Init( LCUI_Widget widget )
 	Border_Init( &widget->computed_style.border );
 	LinkedList_Init( &widget->children );
 	LinkedList_Init( &widget->children_show );
-	LinkedList_Init( &widget->dirty_rects );
+	Region_Init( &widget->dirty_rects );
+	Region_Init( &widget->graph_dirty_rects );
 	Graph_Init( &widget->graph );
 }
 
@@ -289,6 +290,7 @@ LCUI_Widget LCUIWidget_New( const char *type )
 		} else {
 			widget->type = strdup( type );
 		}
+		widget->selector_atom = LCUI_ATOM_NONE;
 	}
 	Widget_AddTask( widget, WTT_REFRESH_STYLE );
 	return widget;
@@ -314,8 +316,10 @@ void Widget_ExecDestroy( LCUI_Widget widget )
 	if( widget->proto && widget->proto->destroy ) {
 		widget->proto->destroy( widget );
 	}
-	RectList_Clear( &widget->dirty_rects );
-	StyleSheet_Delete( widget->inherited_style );
+	Region_Destroy( &widget->dirty_rects );
+	Region_Destroy( &widget->graph_dirty_rects );
+	Graph_Free( &widget->graph );
+	Widget_DestroyInheritedStyle( widget );
 	StyleSheet_Delete( widget->custom_style );
 	StyleSheet_Delete( widget->style );
 	if( widget->parent ) {
@@ -491,6 +495,7 @@ void Widget_SetTitleW( LCUI_Widget w, const wchar_t *title )
 int Widget_SetId( LCUI_Widget w, const char *idstr )
 {
 	LCUIMutex_Lock( &LCUIWidget.mutex );
+	w->selector_atom = LCUI_ATOM_NONE;
 	if( w->id ) {
 		Dict_Delete( LCUIWidget.ids, w->id );
 		free( w->id );
@@ -768,9 +773,57 @@ void Widget_UpdateVisibility( LCUI_Widget w )
 	Widget_PostSurfaceEvent( w, visible ? WET_SHOW : WET_HIDE );
 }
 
+/** 更新位图尺寸 */
+static void Widget_UpdateGraphBox( LCUI_Widget w )
+{
+	LCUI_RectF *rb = &w->box.border;
+	LCUI_RectF *rg = &w->box.graph;
+	LCUI_BoxShadow *shadow = &w->computed_style.shadow;
+	rg->x = w->x - BoxShadow_GetBoxX( shadow );
+	rg->y = w->y - BoxShadow_GetBoxY( shadow );
+	rg->width = BoxShadow_GetWidth( shadow, rb->width );
+	rg->height = BoxShadow_GetHeight( shadow, rb->height );
+	Region_Clear( &w->graph_dirty_rects );
+	if( !w->enable_graph ) {
+		Graph_Free( &w->graph );
+		return;
+	}
+	/* 图层中还有子部件的内容，它们可能是透明的，所以需要带透明度 */
+	w->graph.color_type = COLOR_TYPE_PARGB;
+	if( Graph_Create( &w->graph, rg->width, rg->height ) == 0 ) {
+		LCUI_Rect rect;
+		rect.x = rect.y = 0;
+		rect.width = w->graph.width;
+		rect.height = w->graph.height;
+		Region_UnionRect( &w->graph_dirty_rects, &rect );
+	}
+}
+
+/**
+ * 判断部件是否需要独立的图层
+ * 声明了 will-change: opacity 的部件始终使用独立图层；已经显示的部件的不透明
+ * 度发生变化时，视为在播放透明度动画，自动启用独立图层，直到不透明度恢复为 1
+ */
+static LCUI_BOOL Widget_NeedLayer( LCUI_Widget w, float opacity )
+{
+	LCUI_Style s = &w->style->sheet[key_will_change];
+	if( s->is_valid && s->type == SVT_STYLE && s->style == SV_OPACITY ) {
+		return TRUE;
+	}
+	if( opacity >= 1.0 ) {
+		return FALSE;
+	}
+	if( w->enable_graph ) {
+		return TRUE;
+	}
+	return w->state == WSTATE_NORMAL &&
+		w->computed_style.opacity != opacity;
+}
+
 void Widget_UpdateOpacity( LCUI_Widget w )
 {
 	float opacity = 1.0;
+	LCUI_BOOL enable_graph;
 	LCUI_Style s = &w->style->sheet[key_opacity];
 	if( s->is_valid ) {
 		switch( s->type ) {
@@ -784,9 +837,22 @@ void Widget_UpdateOpacity( LCUI_Widget w )
 			opacity = 0.0;
 		}
 	}
+	enable_graph = Widget_NeedLayer( w, opacity );
 	w->computed_style.opacity = opacity;
-	Widget_InvalidateArea( w, NULL, SV_GRAPH_BOX );
+	/* 合成图层时引用的是位图缓存，Graph_Mix() 使用的是它的不透明度 */
+	w->graph.opacity = opacity;
 	DEBUG_MSG("opacity: %0.2f\n", opacity);
+	if( enable_graph != w->enable_graph ) {
+		w->enable_graph = enable_graph;
+		Widget_UpdateGraphBox( w );
+	} else if( enable_graph && w->parent ) {
+		LCUI_Rect rect;
+		/* 图层内容没有变化，只需在父级部件中重新合成该图层 */
+		RectF2Rect( w->box.graph, rect );
+		Widget_InvalidateArea( w->parent, &rect, SV_PADDING_BOX );
+		return;
+	}
+	Widget_InvalidateArea( w, NULL, SV_GRAPH_BOX );
 }
 
 void Widget_UpdateZIndex( LCUI_Widget w )
@@ -891,33 +957,12 @@ static void Widget_UpdateChildrenSize( LCUI_Widget w )
 	}
 }
 
-void Widget_UpdatePosition( LCUI_Widget w )
+/** 根据定位方式计算部件各个框的坐标 */
+static void Widget_ComputePosition( LCUI_Widget w )
 {
-	LCUI_Rect rect;
-	int position = ComputeStyleOption( w, key_position, SV_STATIC );
-	int valign = ComputeStyleOption( w, key_vertical_align, SV_TOP );
-	w->computed_style.vertical_align = valign;
-	w->computed_style.left = ComputeXMetric( w, key_left );
-	w->computed_style.right = ComputeXMetric( w, key_right );
-	w->computed_style.top = ComputeYMetric( w, key_top );
-	w->computed_style.bottom = ComputeYMetric( w, key_bottom );
-	if( w->parent && w->computed_style.position != position ) {
-		w->computed_style.position = position;
-		Widget_UpdateLayout( w->parent );
-		Widget_ClearComputedSize( w );
-		Widget_UpdateChildrenSize( w );
-		/* 当部件尺寸是按百分比动态计算的时候需要重新计算尺寸 */
-		if( CheckStyleType( w->style->sheet, key_width, scale ) ||
-		    CheckStyleType( w->style->sheet, key_height, scale ) ) {
-			Widget_UpdateSize( w );
-		}
-	}
-	w->computed_style.position = position;
-	RectF2Rect( w->box.graph, rect );
-	Widget_UpdateZIndex( w );
 	w->x = w->origin_x;
 	w->y = w->origin_y;
-	switch( position ) {
+	switch( w->computed_style.position ) {
 	case SV_ABSOLUTE:
 		w->x = w->y = 0;
 		if( w->style->sheet[key_left].is_valid ) {
@@ -957,7 +1002,7 @@ void Widget_UpdatePosition( LCUI_Widget w )
 		}
 		break;
 	}
-	switch( valign ) {
+	switch( w->computed_style.vertical_align ) {
 	case SV_MIDDLE:
 		if( !w->parent ) {
 			break;
@@ -990,45 +1035,54 @@ void Widget_UpdatePosition( LCUI_Widget w )
 	w->box.content.y = w->box.padding.y + w->padding.top;
 	w->box.graph.x -= BoxShadow_GetBoxX( &w->computed_style.shadow );
 	w->box.graph.y -= BoxShadow_GetBoxY( &w->computed_style.shadow );
+}
+
+void Widget_UpdatePosition( LCUI_Widget w )
+{
+	float x, y;
+	LCUI_Rect rect;
+	LCUI_BOOL is_same_position;
+	int position = ComputeStyleOption( w, key_position, SV_STATIC );
+	int valign = ComputeStyleOption( w, key_vertical_align, SV_TOP );
+	w->computed_style.vertical_align = valign;
+	w->computed_style.left = ComputeXMetric( w, key_left );
+	w->computed_style.right = ComputeXMetric( w, key_right );
+	w->computed_style.top = ComputeYMetric( w, key_top );
+	w->computed_style.bottom = ComputeYMetric( w, key_bottom );
+	is_same_position = w->computed_style.position == position;
+	if( w->parent && !is_same_position ) {
+		w->computed_style.position = position;
+		Widget_UpdateLayout( w->parent );
+		Widget_ClearComputedSize( w );
+		Widget_UpdateChildrenSize( w );
+		/* 当部件尺寸是按百分比动态计算的时候需要重新计算尺寸 */
+		if( CheckStyleType( w->style->sheet, key_width, scale ) ||
+		    CheckStyleType( w->style->sheet, key_height, scale ) ) {
+			Widget_UpdateSize( w );
+		}
+	}
+	w->computed_style.position = position;
+	RectF2Rect( w->box.graph, rect );
+	x = w->box.graph.x;
+	y = w->box.graph.y;
+	Widget_UpdateZIndex( w );
+	Widget_ComputePosition( w );
 	if( w->parent ) {
 		DEBUG_MSG("new-rect: %d,%d,%d,%d\n", w->box.graph.x, w->box.graph.y, w->box.graph.w, w->box.graph.h);
 		DEBUG_MSG("old-rect: %d,%d,%d,%d\n", rect.x, rect.y, rect.width, rect.height);
-		/* 标记移动前后的区域 */
-		Widget_PushInvalidArea( w, NULL, SV_GRAPH_BOX );
-		Widget_PushInvalidArea( w->parent, &rect, SV_PADDING_BOX );
+		/* 滚动引起的移动可以直接平移已绘制的内容，否则标记移动前后的区域 */
+		if( !w->task.is_scrolling || !is_same_position ||
+		    Widget_PushScrollArea( w, x, y ) != 0 ) {
+			Widget_PushInvalidArea( w, NULL, SV_GRAPH_BOX );
+			Widget_PushInvalidArea( w->parent, &rect,
+						SV_PADDING_BOX );
+		}
 	}
+	w->task.is_scrolling = FALSE;
 	/* 检测是否为顶级部件并做相应处理 */
 	Widget_PostSurfaceEvent( w, WET_MOVE );
 }
 
-/** 更新位图尺寸 */
-static void Widget_UpdateGraphBox( LCUI_Widget w )
-{
-	LCUI_RectF *rb = &w->box.border;
-	LCUI_RectF *rg = &w->box.graph;
-	LCUI_BoxShadow *shadow = &w->computed_style.shadow;
-	rg->x = w->x - BoxShadow_GetBoxX( shadow );
-	rg->y = w->y - BoxShadow_GetBoxY( shadow );
-	rg->width = BoxShadow_GetWidth( shadow, rb->width );
-	rg->height = BoxShadow_GetHeight( shadow, rb->height );
-	if( !w->enable_graph ) {
-		Graph_Free( &w->graph );
-		return;
-	}
-	/* 如果有会产生透明效果的样式 */
-	if( w->computed_style.border.bottom_left_radius > 0
-	    || w->computed_style.border.bottom_right_radius > 0
-	    || w->computed_style.border.top_left_radius > 0
-	    || w->computed_style.border.top_right_radius > 0
-	    || w->computed_style.background.color.alpha < 255
-	    || w->computed_style.shadow.blur > 0 ) {
-		w->graph.color_type = COLOR_TYPE_ARGB;
-	} else {
-		w->graph.color_type = COLOR_TYPE_RGB;
-	}
-	Graph_Create( &w->graph, rg->width, rg->height );
-}
-
 /** 计算合适的内容框大小 */
 static void Widget_ComputeContentSize( LCUI_Widget w,
 				       float *width, float *height )
@@ -1360,6 +1414,8 @@ void Widget_UpdateSize( LCUI_Widget w )
 	    (rect.width <= 0 || rect.height <= 0) ) {
 		return;
 	}
+	/* 尺寸变化后，已绘制的内容不能再直接平移 */
+	w->task.is_scrolling = FALSE;
 	if( w->style->sheet[key_height].type != SVT_AUTO ) {
 		Widget_UpdateLayout( w );
 	}
@@ -1449,6 +1505,28 @@ void Widget_Move( LCUI_Widget w, float left, float top )
 	Widget_UpdateStyle( w, FALSE );
 }
 
+/** 以滚动的方式设置部件的定位样式，更新位置时会尝试直接平移已绘制的内容 */
+static void Widget_ScrollTo( LCUI_Widget w, int key, float pos )
+{
+	LCUI_Style s = &w->custom_style->sheet[key];
+	if( s->is_valid && s->type == SVT_PX && s->val_px == pos ) {
+		return;
+	}
+	SetStyle( w->custom_style, key, pos, px );
+	w->task.is_scrolling = TRUE;
+	Widget_UpdateStyle( w, FALSE );
+}
+
+void Widget_ScrollLeft( LCUI_Widget w, float left )
+{
+	Widget_ScrollTo( w, key_left, left );
+}
+
+void Widget_ScrollTop( LCUI_Widget w, float top )
+{
+	Widget_ScrollTo( w, key_top, top );
+}
+
 void Widget_Resize( LCUI_Widget w, float width, float height )
 {
 	SetStyle( w->custom_style, key_width, width, px );
@@ -1570,6 +1648,7 @@ int Widget_AddClass( LCUI_Widget w, const char *class_name )
 	if( strsadd( &w->classes, class_name ) <= 0 ) {
 		return 0;
 	}
+	w->selector_atom = LCUI_ATOM_NONE;
 	Widget_HandleChildrenStyleChange( w, 0, class_name );
 	Widget_UpdateStyle( w, TRUE );
 	return 1;
@@ -1590,6 +1669,7 @@ int Widget_RemoveClass( LCUI_Widget w, const char *class_name )
 	if( strshas( w->classes, class_name ) ) {
 		Widget_HandleChildrenStyleChange( w, 0, class_name );
 		strsdel( &w->classes, class_name );
+		w->selector_atom = LCUI_ATOM_NONE;
 		Widget_UpdateStyle( w, TRUE );
 		return 1;
 	}
@@ -1604,8 +1684,8 @@ int Widget_AddStatus( LCUI_Widget w, const char *status_name )
 	if( strsadd( &w->status, status_name ) <= 0 ) {
 		return 0;
 	}
-	Widget_HandleChildrenStyleChange( w, 1, status_name );
-	Widget_UpdateStyle( w, TRUE );
+	w->selector_atom = LCUI_ATOM_NONE;
+	Widget_HandleStatusChange( w, status_name );
 	return 1;
 }
 
@@ -1620,9 +1700,9 @@ LCUI_BOOL Widget_HasStatus( LCUI_Widget w, const char *status_name )
 int Widget_RemoveStatus( LCUI_Widget w, const char *status_name )
 {
 	if( strshas( w->status, status_name ) ) {
-		Widget_HandleChildrenStyleChange( w, 1, status_name );
+		Widget_HandleStatusChange( w, status_name );
 		strsdel( &w->status, status_name );
-		Widget_UpdateStyle( w, TRUE );
+		w->selector_atom = LCUI_ATOM_NONE;
 		return 1;
 	}
 	return 0;
@@ -43,6 +43,20 @@
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/gui/widget.h>
+#include <LCUI/display.h>
+#include <LCUI/trace.h>
+
+/** 遮挡剔除时最多记录的不透明子部件数量 */
+#define MAX_OCCLUDERS 8
+
+/** 一次遍历部件树时最多处理的区域数量 */
+#define MAX_RENDER_RECTS 64
+
+/** 不透明的子部件，用于剔除被它遮挡的子部件 */
+typedef struct OccluderRec_ {
+	int index;		/**< 在显示顺序中的位置，0 表示最顶层 */
+	LCUI_Rect rect;		/**< 不透明区域，相对于当前脏矩形 */
+} OccluderRec, *Occluder;
 
 /** 判断部件是否有可绘制内容 */
 static LCUI_BOOL Widget_IsPaintable( LCUI_Widget w )
@@ -58,6 +72,51 @@ static LCUI_BOOL Widget_IsPaintable( LCUI_Widget w )
 	return w->proto && w->proto->paint;
 }
 
+/** 判断边框是否没有圆角，且可见的边框线都是不透明的 */
+static LCUI_BOOL Border_IsOpaque( const LCUI_Border *b )
+{
+	if( b->top_left_radius > 0 || b->top_right_radius > 0 ||
+	    b->bottom_left_radius > 0 || b->bottom_right_radius > 0 ) {
+		return FALSE;
+	}
+	if( (b->top.width > 0 && b->top.color.alpha < 255) ||
+	    (b->right.width > 0 && b->right.color.alpha < 255) ||
+	    (b->bottom.width > 0 && b->bottom.color.alpha < 255) ||
+	    (b->left.width > 0 && b->left.color.alpha < 255) ) {
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/**
+ * 判断部件能否直接绘制到目标画布上
+ * 阴影、圆角边框以及半透明的背景色和边框在绘制时会覆盖画布中已有的像素，
+ * 这类部件需要先绘制到独立的位图中，再混合到画布上
+ */
+static LCUI_BOOL Widget_CanPaintDirectly( LCUI_Widget w )
+{
+	const LCUI_WidgetStyle *s = &w->computed_style;
+	if( s->shadow.blur > 0 || s->shadow.spread > 0 ||
+	    s->shadow.x != 0 || s->shadow.y != 0 ) {
+		return FALSE;
+	}
+	if( s->background.color.alpha > 0 &&
+	    s->background.color.alpha < 255 ) {
+		return FALSE;
+	}
+	return Border_IsOpaque( &s->border );
+}
+
+/** 判断部件的边框框区域是否完全不透明 */
+static LCUI_BOOL Widget_IsOpaque( LCUI_Widget w )
+{
+	const LCUI_WidgetStyle *s = &w->computed_style;
+	if( s->opacity < 1.0 || s->background.color.alpha < 255 ) {
+		return FALSE;
+	}
+	return Border_IsOpaque( &s->border );
+}
+
 /**
  * 根据所处框区域，调整矩形
  * @param[in] w		目标部件
@@ -91,16 +150,48 @@ static void Widget_AdjustArea(	LCUI_Widget w, LCUI_Rect *in_rect,
 	out_rect->y += roundi( box->y - w->box.graph.y );
 }
 
+/**
+ * 标记部件及其祖先部件的位图缓存中需要重绘的区域
+ * @param[in] w 部件
+ * @param[in] rect 区域，相对于部件的呈现框
+ */
+static void Widget_InvalidateGraphArea( LCUI_Widget w, const LCUI_Rect *rect )
+{
+	LCUI_Rect r = *rect;
+	LCUI_BOOL has_graph = FALSE;
+	while( w ) {
+		if( w->enable_graph && Graph_IsValid( &w->graph ) ) {
+			Region_UnionRect( &w->graph_dirty_rects, &r );
+			has_graph = TRUE;
+		}
+		if( !w->parent ) {
+			break;
+		}
+		/* 确保处理无效区域时能遍历到有位图缓存的部件 */
+		if( has_graph ) {
+			w->parent->has_dirty_child = TRUE;
+		}
+		/* 与 Widget_Render() 中计算子部件坐标的方式保持一致 */
+		r.x += roundi( w->box.graph.x + w->parent->box.padding.x -
+			       w->parent->box.graph.x );
+		r.y += roundi( w->box.graph.y + w->parent->box.padding.y -
+			       w->parent->box.graph.y );
+		w = w->parent;
+	}
+}
+
 void Widget_InvalidateArea( LCUI_Widget w, LCUI_Rect *r, int box_type )
 {
 	LCUI_Rect rect;
 	Widget_AdjustArea( w, r, &rect, box_type );
+	Widget_InvalidateGraphArea( w, &rect );
 	DEBUG_MSG( "[%s]: invalidRect:(%d,%d,%d,%d)\n", w->type,
 		   rect.x, rect.y, rect.width, rect.height );
-	RectList_Add( &w->dirty_rects, &rect );
+	Region_UnionRect( &w->dirty_rects, &rect );
 	while( w = w->parent, w ) {
 		w->has_dirty_child = TRUE;
 	}
+	LCUI_Wakeup();
 }
 
 LCUI_BOOL Widget_PushInvalidArea( LCUI_Widget widget, 
@@ -115,6 +206,7 @@ LCUI_BOOL Widget_PushInvalidArea( LCUI_Widget widget,
 		w = root;
 	}
 	Widget_AdjustArea( w, r, &rect, box_type );
+	Widget_InvalidateGraphArea( w, &rect );
 	rectf.x = rect.x + w->box.graph.x;
 	rectf.y = rect.y + w->box.graph.y;
 	rectf.width = rect.width;
@@ -137,13 +229,10 @@ LCUI_BOOL Widget_PushInvalidArea( LCUI_Widget widget,
 int Widget_GetInvalidArea( LCUI_Widget widget, LCUI_Rect *area )
 {
 	LCUI_Rect *rect;
-	if( widget->dirty_rects.length <= 0 ) {
+	if( Region_IsEmpty( &widget->dirty_rects ) ) {
 		return -1;
 	}
-	rect = LinkedList_Get( &widget->dirty_rects, 0 );
-	if( !rect ) {
-		return -2;
-	}
+	rect = &widget->dirty_rects.rects[0];
 	DEBUG_MSG("p_rect: %d,%d,%d,%d\n", rect->x, rect->y, rect->width, rect->height);
 	*area = *rect;
 	return 0;
@@ -153,7 +242,149 @@ void Widget_ValidateArea( LCUI_Widget w, LCUI_Rect *r, int box_type )
 {
 	LCUI_Rect rect;
 	Widget_AdjustArea( w, r, &rect, box_type );
-	RectList_Delete( &w->dirty_rects, &rect );
+	Region_SubtractRect( &w->dirty_rects, &rect );
+}
+
+/** 获取部件内边距框相对于呈现框的区域，与 Widget_RenderContent() 保持一致 */
+static void Widget_GetViewport( LCUI_Widget w, LCUI_Rect *rect )
+{
+	rect->x = roundi( w->box.padding.x - w->box.graph.x );
+	rect->y = roundi( w->box.padding.y - w->box.graph.y );
+	rect->width = roundi( w->box.padding.width );
+	rect->height = roundi( w->box.padding.height );
+}
+
+/**
+ * 将与区域重叠的子部件标记为无效区域
+ * @param[in] w 父部件
+ * @param[in] target 需要跳过的子部件
+ * @param[in] above_only 是否只处理显示在 target 上层的子部件
+ * @param[in] rect 区域，相对于父部件的呈现框
+ */
+static void Widget_InvalidateOverlappedChildren( LCUI_Widget w,
+						 LCUI_Widget target,
+						 LCUI_BOOL above_only,
+						 LCUI_Rect *rect )
+{
+	LCUI_Rect child_rect;
+	LinkedListNode *node;
+	float content_left = w->box.padding.x - w->box.graph.x;
+	float content_top = w->box.padding.y - w->box.graph.y;
+
+	for( LinkedList_Each( node, &w->children_show ) ) {
+		LCUI_Widget child = node->data;
+		if( child == target ) {
+			if( above_only ) {
+				break;
+			}
+			continue;
+		}
+		if( !child->computed_style.visible ||
+		    child->state != WSTATE_NORMAL ) {
+			continue;
+		}
+		child_rect.x = roundi( child->box.graph.x + content_left );
+		child_rect.y = roundi( child->box.graph.y + content_top );
+		child_rect.width = roundi( child->box.graph.width );
+		child_rect.height = roundi( child->box.graph.height );
+		if( LCUIRect_IsCoverRect( &child_rect, rect ) ) {
+			Widget_InvalidateArea( child, NULL, SV_GRAPH_BOX );
+		}
+	}
+}
+
+int Widget_PushScrollArea( LCUI_Widget w, float old_x, float old_y )
+{
+	int i, dx, dy;
+	LCUI_Widget parent, child;
+	LCUI_RegionRec region;
+	LCUI_Rect viewport, rect, box;
+	float x, y, content_left, content_top;
+
+	parent = w->parent;
+	if( !parent || w->state != WSTATE_NORMAL ||
+	    !w->computed_style.visible ) {
+		return -1;
+	}
+	/* 视口中的像素只能由部件自身决定，或者是衬在纯色背景上的 */
+	if( !Widget_IsOpaque( w ) && (!Widget_IsOpaque( parent ) ||
+	    Graph_IsValid( &parent->computed_style.background.image ) ||
+	    (parent->proto && parent->proto->paint)) ) {
+		return -1;
+	}
+	/* 祖先部件的位图缓存和不透明度都会影响屏幕上的像素 */
+	for( child = parent; child; child = child->parent ) {
+		/* 根部件的状态不会变为 WSTATE_NORMAL，不用检查 */
+		if( !child->parent ) {
+			if( child != LCUIWidget_GetRoot() ) {
+				return -1;
+			}
+		} else if( child->state != WSTATE_NORMAL ) {
+			return -1;
+		}
+		if( !child->computed_style.visible ||
+		    child->computed_style.opacity < 1.0 ||
+		    child->enable_graph ) {
+			return -1;
+		}
+	}
+	content_left = parent->box.padding.x - parent->box.graph.x;
+	content_top = parent->box.padding.y - parent->box.graph.y;
+	dx = roundi( w->box.graph.x + content_left );
+	dx -= roundi( old_x + content_left );
+	dy = roundi( w->box.graph.y + content_top );
+	dy -= roundi( old_y + content_top );
+	Widget_GetViewport( parent, &viewport );
+	/* 只有移动前后都被部件覆盖的区域可以平移，其余区域需要重绘 */
+	Region_Init( &region );
+	for( i = 0; i < 2; ++i ) {
+		x = i == 0 ? old_x : w->box.graph.x;
+		y = i == 0 ? old_y : w->box.graph.y;
+		box.x = roundi( x + content_left );
+		box.y = roundi( y + content_top );
+		box.x += (int)(w->box.border.x - w->box.graph.x);
+		box.y += (int)(w->box.border.y - w->box.graph.y);
+		box.width = (int)w->box.border.width;
+		box.height = (int)w->box.border.height;
+		if( !LCUIRect_GetOverlayRect( &viewport, &box, &box ) ) {
+			Region_Destroy( &region );
+			return -1;
+		}
+		Region_UnionRect( &region, &box );
+		if( i == 0 ) {
+			rect = box;
+		} else if( !LCUIRect_GetOverlayRect( &rect, &box, &viewport ) ) {
+			Region_Destroy( &region );
+			return -1;
+		}
+	}
+	if( dx == 0 && dy == 0 ) {
+		Region_Destroy( &region );
+		return 0;
+	}
+	Region_SubtractRect( &region, &viewport );
+	for( i = 0; i < region.length; ++i ) {
+		Widget_InvalidateArea( parent, &region.rects[i],
+				       SV_GRAPH_BOX );
+	}
+	Region_Destroy( &region );
+	/* 其它部件不随内容移动，将与视口重叠的部分标记为无效区域 */
+	Widget_InvalidateOverlappedChildren( parent, w, FALSE, &viewport );
+	for( child = parent; child->parent; child = child->parent ) {
+		parent = child->parent;
+		content_left = parent->box.padding.x - parent->box.graph.x;
+		content_top = parent->box.padding.y - parent->box.graph.y;
+		/* 转换为相对于上一级部件呈现框的坐标，并裁剪掉不可见的部分 */
+		viewport.x += roundi( child->box.graph.x + content_left );
+		viewport.y += roundi( child->box.graph.y + content_top );
+		Widget_GetViewport( parent, &rect );
+		if( !LCUIRect_GetOverlayRect( &viewport, &rect, &viewport ) ) {
+			return 0;
+		}
+		Widget_InvalidateOverlappedChildren( parent, child,
+						     TRUE, &viewport );
+	}
+	return LCUIDisplay_ScrollArea( &viewport, dx, dy );
 }
 
 /** 当前部件的绘制函数 */
@@ -166,10 +397,6 @@ static void Widget_OnPaint( LCUI_Widget w, LCUI_PaintContext paint )
 	s = &w->computed_style;
 	box.width = w->box.graph.width;
 	box.height = w->box.graph.height;
-	/* 如果是有位图缓存的话，则先清空缓存里的阴影区域 */
-	if( w->enable_graph ) {
-		Graph_ClearShadowArea( paint, &box, &s->shadow );
-	}
 	Graph_DrawBoxShadow( paint, &box, &s->shadow );
 	box.x = w->box.border.x - w->box.graph.x;
 	box.y = w->box.border.y - w->box.graph.y;
@@ -182,46 +409,70 @@ static void Widget_OnPaint( LCUI_Widget w, LCUI_PaintContext paint )
 	}
 }
 
+static void Widget_RenderContent( LCUI_Widget w, LCUI_PaintContext paint,
+				 float opacity );
+
+/** 重绘部件位图缓存中的无效区域，位图缓存中的内容是不透明度为 1 时的效果 */
+static void Widget_UpdateGraph( LCUI_Widget w )
+{
+	int i;
+	LCUI_Rect rect;
+	LCUI_PaintContextRec paint;
+
+	if( !w->enable_graph || !Graph_IsValid( &w->graph ) ||
+	    Region_IsEmpty( &w->graph_dirty_rects ) ) {
+		return;
+	}
+	rect.x = rect.y = 0;
+	rect.width = w->graph.width;
+	rect.height = w->graph.height;
+	Region_IntersectRect( &w->graph_dirty_rects, &rect );
+	paint.arena = NULL;
+	paint.region = NULL;
+	paint.with_alpha = TRUE;
+	for( i = 0; i < w->graph_dirty_rects.length; ++i ) {
+		paint.rect = w->graph_dirty_rects.rects[i];
+		Graph_Quote( &paint.canvas, &w->graph, &paint.rect );
+		Graph_FillRect( &paint.canvas, ARGB( 0, 0, 0, 0 ), NULL, TRUE );
+		Widget_RenderContent( w, &paint, 1.0 );
+	}
+	Region_Clear( &w->graph_dirty_rects );
+}
+
 /**
  * 处理部件无效区域
  * @param[in] w 部件
  * @param[in] x 当前部件的绝对 X 坐标
  * @param[in] y 当前部件的绝对 Y 坐标
  * @param[in] valid_box 当前部件内的有效框
- * @param[out] rlist 收集到的无效区域列表
+ * @param[out] region 收集到的无效区域
  */
 static int _Widget_ProcInvalidArea( LCUI_Widget w, float x, float y, 
 				    LCUI_RectF *valid_box, 
-				    LinkedList *rlist )
+				    LCUI_Region region )
 {
-	int count;
+	int i, count;
 	LCUI_Widget child;
 	LinkedListNode *node;
 	LCUI_RectF child_box;
 	count = w->dirty_rects.length;
 	/* 取出当前记录的无效区域 */
-	for( LinkedList_Each( node, &w->dirty_rects ) ) {
+	for( i = 0; i < w->dirty_rects.length; ++i ) {
 		LCUI_Rect rect;
-		LCUI_Rect *r = node->data;
-		/* 若有独立位图缓存，则重绘脏矩形区域 */
-		if( w->enable_graph && Graph_IsValid( &w->graph ) ) {
-			LCUI_PaintContextRec paint;
-			paint.rect = *r;
-			Graph_Quote( &paint.canvas, &w->graph, &paint.rect );
-			Widget_OnPaint( w, &paint );
-		}
+		LCUI_Rect *r = &w->dirty_rects.rects[i];
 		RectF2Rect( *valid_box, rect );
 		/* 取出与容器内有效区域相交的区域 */
 		if( LCUIRect_GetOverlayRect( r, &rect, &rect ) ) {
 			/* 转换成绝对坐标 */
 			rect.x = roundi( rect.x + x );
 			rect.y = roundi( rect.y + y );
-			RectList_Add( rlist, &rect );
+			Region_UnionRect( region, &rect );
 		}
 	}
-	RectList_Clear( &w->dirty_rects );
+	Region_Clear( &w->dirty_rects );
 	/* 若子级部件没有脏矩形记录 */
 	if( !w->has_dirty_child ) {
+		Widget_UpdateGraph( w );
 		return count;
 	}
 	/* 转换为内边距框的坐标 */
@@ -252,18 +503,20 @@ static int _Widget_ProcInvalidArea( LCUI_Widget w, float x, float y,
 		child_box.x -= w->box.padding.x - w->box.graph.x;
 		child_box.y -= w->box.padding.y - w->box.graph.y;
 		count += _Widget_ProcInvalidArea( child, child_x, child_y, 
-						  &child_box, rlist );
+						  &child_box, region );
 	}
 	w->has_dirty_child = FALSE;
+	/* 子级部件的位图缓存已经更新，现在可以更新当前部件的位图缓存 */
+	Widget_UpdateGraph( w );
 	return count;
 }
 
-int Widget_ProcInvalidArea( LCUI_Widget w, LinkedList *rlist )
+int Widget_ProcInvalidArea( LCUI_Widget w, LCUI_Region region )
 {
 	LCUI_RectF valid_box;
 	valid_box = w->box.graph;
 	valid_box.x = valid_box.y = 0;
-	return _Widget_ProcInvalidArea( w, 0, 0, &valid_box, rlist );
+	return _Widget_ProcInvalidArea( w, 0, 0, &valid_box, region );
 }
 
 int Widget_ConvertArea( LCUI_Widget w, LCUI_Rect *in_rect,
@@ -318,8 +571,121 @@ int Widget_ConvertArea( LCUI_Widget w, LCUI_Rect *in_rect,
 	return 0;
 }
 
-void Widget_Render( LCUI_Widget w, LCUI_PaintContext paint )
+/**
+ * 按照显示顺序，从顶到底收集子部件中的不透明区域
+ * @param[in] w 部件
+ * @param[in] x 内容框相对于当前脏矩形的 X 坐标
+ * @param[in] y 内容框相对于当前脏矩形的 Y 坐标
+ * @param[in] content_rect 内容框中需要绘制的区域，相对于当前脏矩形
+ * @param[out] occluders 收集到的不透明区域
+ * @returns 不透明区域的数量
+ */
+static int Widget_GetOccluders( LCUI_Widget w, float x, float y,
+				const LCUI_Rect *content_rect,
+				OccluderRec occluders[MAX_OCCLUDERS] )
 {
+	int i = 0, n = 0;
+	LCUI_Rect rect;
+	LCUI_Widget child;
+	LinkedListNode *node;
+
+	for( LinkedList_Each( node, &w->children_show ) ) {
+		child = node->data;
+		if( !child->computed_style.visible ||
+		    child->state != WSTATE_NORMAL ||
+		    !Widget_IsOpaque( child ) ) {
+			++i;
+			continue;
+		}
+		/* 背景和边框绘制在边框框内，与 Widget_OnPaint() 的计算方式保持一致 */
+		rect.x = roundi( child->box.graph.x + x );
+		rect.y = roundi( child->box.graph.y + y );
+		rect.x += (int)(child->box.border.x - child->box.graph.x);
+		rect.y += (int)(child->box.border.y - child->box.graph.y);
+		rect.width = (int)child->box.border.width;
+		rect.height = (int)child->box.border.height;
+		if( LCUIRect_GetOverlayRect( content_rect, &rect, &rect ) ) {
+			occluders[n].index = i;
+			occluders[n].rect = rect;
+			++n;
+			/* 如果已经遮住整个区域，那么更底层的部件都是不可见的 */
+			if( rect.width == content_rect->width &&
+			    rect.height == content_rect->height ) {
+				break;
+			}
+			if( n >= MAX_OCCLUDERS ) {
+				break;
+			}
+		}
+		++i;
+	}
+	return n;
+}
+
+/**
+ * 裁剪掉绘制区域中被上层的不透明部件遮挡的部分
+ * @param[in] index 部件在显示顺序中的位置
+ * @param[in,out] rect 部件的绘制区域
+ * @returns 如果绘制区域被完全遮挡，则返回 TRUE
+ */
+static LCUI_BOOL CutOccludedArea( OccluderRec *occluders, int n,
+				  int index, LCUI_Rect *rect )
+{
+	int i;
+	for( i = 0; i < n && occluders[i].index < index; ++i ) {
+		if( LCUIRect_CutCoveredArea( rect, &occluders[i].rect ) ) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/** 绘制部件自身的内容，并混合到画布上 */
+static void Widget_PaintSelf( LCUI_Widget w, LCUI_PaintContext paint )
+{
+	size_t arena_offset = 0;
+	LCUI_Graph self_graph;
+	LCUI_PaintContextRec self_paint;
+
+	Graph_Init( &self_graph );
+	self_paint.rect = paint->rect;
+	self_paint.arena = paint->arena;
+	/* 直接绘制到画布上，省去一次位图混合 */
+	if( Widget_CanPaintDirectly( w ) ) {
+		self_paint.canvas = paint->canvas;
+		self_paint.with_alpha = paint->with_alpha;
+		Widget_OnPaint( w, &self_paint );
+		return;
+	}
+	if( paint->arena ) {
+		arena_offset = GraphArena_GetOffset( paint->arena );
+	}
+	self_graph.color_type = COLOR_TYPE_PARGB;
+	GraphArena_CreateGraph( paint->arena, &self_graph,
+				paint->rect.width, paint->rect.height );
+	self_paint.canvas = self_graph;
+	self_paint.with_alpha = TRUE;
+	Widget_OnPaint( w, &self_paint );
+	Graph_Mix( &paint->canvas, &self_graph, 0, 0, paint->with_alpha );
+	if( paint->arena ) {
+		GraphArena_Rewind( paint->arena, arena_offset );
+	} else {
+		Graph_Free( &self_graph );
+	}
+}
+
+/**
+ * 渲染部件及其子级部件
+ * @param[in] w 部件
+ * @param[in] paint 绘制上下文
+ * @param[in] opacity 部件的不透明度
+ */
+static void Widget_RenderContent( LCUI_Widget w, LCUI_PaintContext paint,
+				 float opacity )
+{
+	int index, n_occluders;
+	OccluderRec occluders[MAX_OCCLUDERS];
+	size_t arena_offset = 0;
 	LinkedListNode *node;
 	float content_left, content_top;
 	LCUI_PaintContextRec self_paint;
@@ -333,9 +699,15 @@ void Widget_Render( LCUI_Widget w, LCUI_PaintContext paint )
 	Graph_Init( &self_graph );
 	Graph_Init( &layer_graph );
 	Graph_Init( &content_graph );
-	layer_graph.color_type = COLOR_TYPE_ARGB;
+	layer_graph.color_type = COLOR_TYPE_PARGB;
+	self_paint.arena = paint->arena;
+	child_paint.arena = paint->arena;
+	/* 临时图形都从内存池中分配，在返回时回退到当前位置即可全部释放 */
+	if( paint->arena ) {
+		arena_offset = GraphArena_GetOffset( paint->arena );
+	}
 	/* 若部件本身是透明的 */
-	if( w->computed_style.opacity < 1.0 ) {
+	if( opacity < 1.0 ) {
 		has_self_graph = TRUE;
 		has_content_graph = TRUE;
 		has_layer_graph = TRUE;
@@ -351,21 +723,19 @@ void Widget_Render( LCUI_Widget w, LCUI_PaintContext paint )
 	is_paintable = Widget_IsPaintable( w );
 	/* 如果部件有需要绘制的内容 */
 	if( is_paintable ) {
-		if( w->enable_graph && Graph_IsValid( &w->graph ) ) {
-			Graph_Quote( &self_graph, &w->graph, &paint->rect );
+		/* 若不需要缓存自身位图则直接绘制到画布上 */
+		if( !has_self_graph ) {
+			Widget_PaintSelf( w, paint );
 		} else {
-			self_graph.color_type = COLOR_TYPE_ARGB;
-			Graph_Create( &self_graph, paint->rect.width,
-				      paint->rect.height );
+			self_graph.color_type = COLOR_TYPE_PARGB;
+			GraphArena_CreateGraph( paint->arena, &self_graph,
+						paint->rect.width,
+						paint->rect.height );
 			self_paint.canvas = self_graph;
 			self_paint.rect = paint->rect;
+			self_paint.with_alpha = TRUE;
 			Widget_OnPaint( w, &self_paint );
 		}
-		/* 若不需要缓存自身位图则直接绘制到画布上 */
-		if( !has_self_graph ) {
-			Graph_Mix( &paint->canvas, &self_graph,
-				   0, 0, paint->with_alpha );
-		}
 	}
 	/* 计算内容框相对于图层的坐标 */
 	content_left = w->box.padding.x - w->box.graph.x;
@@ -389,18 +759,24 @@ void Widget_Render( LCUI_Widget w, LCUI_PaintContext paint )
 	/* 若需要部件内容区的位图缓存 */
 	if( has_content_graph ) {
 		child_paint.with_alpha = TRUE;
-		content_graph.color_type = COLOR_TYPE_ARGB;
-		Graph_Create( &content_graph,
-			      content_rect.width, content_rect.height );
+		content_graph.color_type = COLOR_TYPE_PARGB;
+		GraphArena_CreateGraph( paint->arena, &content_graph,
+					content_rect.width,
+					content_rect.height );
 	} else {
 		child_paint.with_alpha = paint->with_alpha;
 		/* 引用该区域的位图，作为内容框的位图 */
 		Graph_Quote( &content_graph, &paint->canvas, &content_rect );
 	}
+	n_occluders = Widget_GetOccluders( w, content_left - paint->rect.x,
+					   content_top - paint->rect.y,
+					   &content_rect, occluders );
+	index = w->children_show.length;
 	/* 按照显示顺序，从底到顶，递归遍历子级部件 */
 	LinkedList_ForEachReverse( node, &w->children_show ) {
 		LCUI_Rect child_rect;
 		LCUI_Widget child = node->data;
+		--index;
 		if( !child->computed_style.visible || 
 		    child->state != WSTATE_NORMAL ) {
 			continue;
@@ -420,6 +796,11 @@ void Widget_Render( LCUI_Widget w, LCUI_PaintContext paint )
 		if( !has_overlay ) {
 			continue;
 		}
+		/* 跳过被上层不透明部件遮挡的区域 */
+		if( CutOccludedArea( occluders, n_occluders,
+				     index, &child_paint.rect ) ) {
+			continue;
+		}
 		/* 将子部件绘制区域转换成相对于当前部件内容框 */
 		canvas_rect.x = child_paint.rect.x - content_rect.x;
 		canvas_rect.y = child_paint.rect.y - content_rect.y;
@@ -446,17 +827,18 @@ content_paint_done:
 	 * 前部件的图层，然后将该图层混合到输出的位图中
 	 */
 	if( has_layer_graph ) {
+		GraphArena_CreateGraph( paint->arena, &layer_graph,
+					paint->rect.width,
+					paint->rect.height );
 		if( is_paintable ) {
-			Graph_Copy( &layer_graph, &self_graph );
+			Graph_Replace( &layer_graph, &self_graph, 0, 0 );
 			Graph_Mix( &layer_graph, &content_graph,
 				   content_rect.x, content_rect.y, TRUE );
 		} else {
-			Graph_Create( &layer_graph, paint->rect.width, 
-				      paint->rect.height );
 			Graph_Replace( &layer_graph, &content_graph, 
 				       content_rect.x, content_rect.y );
 		}
-		layer_graph.opacity = w->computed_style.opacity;
+		layer_graph.opacity = opacity;
 		Graph_Mix( &paint->canvas, &layer_graph, 
 			   0, 0, paint->with_alpha );
 	}
@@ -464,7 +846,166 @@ content_paint_done:
 		Graph_Mix( &paint->canvas, &content_graph,
 			   content_rect.x, content_rect.y, TRUE );
 	}
+	if( paint->arena ) {
+		GraphArena_Rewind( paint->arena, arena_offset );
+		return;
+	}
 	Graph_Free( &layer_graph );
 	Graph_Free( &self_graph );
 	Graph_Free( &content_graph );
 }
+
+void Widget_Render( LCUI_Widget w, LCUI_PaintContext paint )
+{
+	LCUI_Graph graph;
+	const char *name = w->type ? w->type : "widget";
+	LCUITrace_Begin( "render", name );
+	/* 若位图缓存中的内容是有效的，则只需按不透明度将它混合到画布上 */
+	if( w->enable_graph && Graph_IsValid( &w->graph ) &&
+	    !Region_OverlapsRect( &w->graph_dirty_rects, &paint->rect ) ) {
+		Graph_Quote( &graph, &w->graph, &paint->rect );
+		Graph_Mix( &paint->canvas, &graph, 0, 0, paint->with_alpha );
+	} else {
+		Widget_RenderContent( w, paint, w->computed_style.opacity );
+	}
+	LCUITrace_End( "render", name );
+}
+
+/**
+ * 在多个互不重叠的区域中渲染部件，部件树只需遍历一次
+ * @param[in] w 部件
+ * @param[in] paint 绘制上下文，其中的 rect 为所有区域的包围盒
+ * @param[in] rects 需要绘制的区域，相对于部件呈现框
+ * @param[in] n_rects 区域数量
+ */
+static void Widget_RenderRects( LCUI_Widget w, LCUI_PaintContext paint,
+				const LCUI_Rect *rects, int n_rects )
+{
+	int i, n, index, n_occluders;
+	LCUI_Widget child;
+	LinkedListNode *node;
+	float content_left, content_top;
+	LCUI_PaintContextRec sub_paint;
+	OccluderRec occluders[MAX_OCCLUDERS];
+	LCUI_Rect rect, child_rect, content_rect;
+	LCUI_Rect child_rects[MAX_RENDER_RECTS];
+
+	sub_paint.arena = paint->arena;
+	sub_paint.with_alpha = paint->with_alpha;
+	/* 半透明或有位图缓存的部件需要按图层合成，只能逐个区域渲染 */
+	if( n_rects == 1 || w->enable_graph ||
+	    w->computed_style.opacity < 1.0 ) {
+		for( i = 0; i < n_rects; ++i ) {
+			sub_paint.rect = rects[i];
+			rect = rects[i];
+			rect.x -= paint->rect.x;
+			rect.y -= paint->rect.y;
+			Graph_Quote( &sub_paint.canvas, &paint->canvas, &rect );
+			Widget_Render( w, &sub_paint );
+		}
+		return;
+	}
+	if( Widget_IsPaintable( w ) ) {
+		for( i = 0; i < n_rects; ++i ) {
+			sub_paint.rect = rects[i];
+			rect = rects[i];
+			rect.x -= paint->rect.x;
+			rect.y -= paint->rect.y;
+			Graph_Quote( &sub_paint.canvas, &paint->canvas, &rect );
+			Widget_PaintSelf( w, &sub_paint );
+		}
+	}
+	content_left = w->box.padding.x - w->box.graph.x;
+	content_top = w->box.padding.y - w->box.graph.y;
+	content_rect.x = roundi( content_left );
+	content_rect.y = roundi( content_top );
+	content_rect.width = roundi( w->box.padding.width );
+	content_rect.height = roundi( w->box.padding.height );
+	if( !LCUIRect_GetOverlayRect( &content_rect, &paint->rect,
+				      &content_rect ) ) {
+		return;
+	}
+	n_occluders = Widget_GetOccluders( w, content_left, content_top,
+					   &content_rect, occluders );
+	index = w->children_show.length;
+	/* 按照显示顺序，从底到顶，只向与区域重叠的子级部件递归 */
+	LinkedList_ForEachReverse( node, &w->children_show ) {
+		child = node->data;
+		--index;
+		if( !child->computed_style.visible ||
+		    child->state != WSTATE_NORMAL ) {
+			continue;
+		}
+		child_rect.x = roundi( child->box.graph.x + content_left );
+		child_rect.y = roundi( child->box.graph.y + content_top );
+		child_rect.width = roundi( child->box.graph.width );
+		child_rect.height = roundi( child->box.graph.height );
+		if( !LCUIRect_GetOverlayRect( &content_rect, &child_rect,
+					      &child_rect ) ) {
+			continue;
+		}
+		for( n = 0, i = 0; i < n_rects; ++i ) {
+			if( !LCUIRect_GetOverlayRect( &child_rect, &rects[i],
+						      &rect ) ) {
+				continue;
+			}
+			if( CutOccludedArea( occluders, n_occluders,
+					     index, &rect ) ) {
+				continue;
+			}
+			/* 转换为相对于子部件的坐标 */
+			rect.x -= roundi( child->box.graph.x + content_left );
+			rect.y -= roundi( child->box.graph.y + content_top );
+			child_rects[n++] = rect;
+		}
+		if( n == 0 ) {
+			continue;
+		}
+		sub_paint.rect = child_rects[0];
+		for( i = 1; i < n; ++i ) {
+			rect = sub_paint.rect;
+			LCUIRect_MergeRect( &sub_paint.rect,
+					    &rect, &child_rects[i] );
+		}
+		rect = sub_paint.rect;
+		rect.x += roundi( child->box.graph.x + content_left );
+		rect.y += roundi( child->box.graph.y + content_top );
+		rect.x -= paint->rect.x;
+		rect.y -= paint->rect.y;
+		Graph_Quote( &sub_paint.canvas, &paint->canvas, &rect );
+		Widget_RenderRects( child, &sub_paint, child_rects, n );
+	}
+}
+
+void Widget_RenderRegion( LCUI_Widget w, LCUI_PaintContext paint,
+			  LCUI_Region region )
+{
+	int i, n;
+	LCUI_Rect rect;
+	LCUI_PaintContextRec sub_paint;
+
+	sub_paint.arena = paint->arena;
+	sub_paint.with_alpha = paint->with_alpha;
+	for( i = 0; i < region->length; i += n ) {
+		n = region->length - i;
+		if( n > MAX_RENDER_RECTS ) {
+			n = MAX_RENDER_RECTS;
+		}
+		if( n == region->length ) {
+			sub_paint.rect = region->extents;
+		} else {
+			int j;
+			sub_paint.rect = region->rects[i];
+			for( j = i + 1; j < i + n; ++j ) {
+				rect = sub_paint.rect;
+				LCUIRect_MergeRect( &sub_paint.rect, &rect,
+						    &region->rects[j] );
+			}
+		}
+		rect = sub_paint.rect;
+		rect.x -= paint->rect.x;
+		rect.y -= paint->rect.y;
+		Graph_Quote( &sub_paint.canvas, &paint->canvas, &rect );
+		Widget_RenderRects( w, &sub_paint, region->rects + i, n );
+	}
+}
@@ -45,12 +45,61 @@
 #include <LCUI/LCUI.h>
 #include <LCUI/gui/widget.h>
 #include <LCUI/gui/css_library.h>
+#include <LCUI/trace.h>
+
+/** 在查找可共享样式表的兄弟部件时，最多向前检查的兄弟部件数量 */
+#define STYLE_SHARING_MAX_SIBLINGS	8
+
+/** 状态变化时缓存的匹配结果数量，须为 2 的幂 */
+#define STATUS_MATCH_CACHE_SIZE		64
 
 typedef struct {
 	int start, end, task;
 	LCUI_BOOL is_valid;
 } TaskMap;
 
+/**
+ * 继承样式表
+ * 选择器链相同的兄弟部件可以共同引用同一张继承样式表，在需要重新计算时才复制
+ */
+typedef struct SharedStyleSheetRec_ {
+	LCUI_StyleSheetRec sheet;	/**< 样式表，必须作为第一个成员 */
+	int ref_count;			/**< 引用计数 */
+	LCUI_Atom atom;			/**< 计算样式表时部件选择器结点的原子 */
+	unsigned int version;		/**< 计算样式表时样式库的版本号 */
+} SharedStyleSheetRec, *SharedStyleSheet;
+
+/**
+ * 状态变化时查找受影响的后代部件所用的上下文
+ * 选择器结点相同的部件的匹配结果也相同，按原子缓存匹配结果，大量同类的后代
+ * 部件只需匹配一次
+ */
+typedef struct StatusMatchContextRec_ {
+	LinkedList *nodes;		/**< 状态变化可能影响到的选择器结点 */
+	size_t count;			/**< 添加了样式刷新任务的部件数量 */
+	struct {
+		LCUI_Atom atom;
+		LCUI_BOOL matched;
+	} cache[STATUS_MATCH_CACHE_SIZE];
+} StatusMatchContextRec, *StatusMatchContext;
+
+/** 已记录到祖先过滤器中的部件 */
+typedef struct AncestorRec_ {
+	LCUI_Widget widget;	/**< 部件 */
+	LCUI_Atom atom;		/**< 记录时部件选择器结点的原子 */
+	unsigned int *keys;	/**< 记录到过滤器中的键 */
+	int nkeys;		/**< 键的数量 */
+} AncestorRec, *Ancestor;
+
+/**
+ * 祖先过滤器
+ * 在 Widget_Update() 向下遍历部件树时维护，记录当前正在更新的部件的所有祖先
+ */
+static struct AncestorFilterModule {
+	LCUI_SelectorFilterRec filter;	/**< 选择器过滤器 */
+	LinkedList ancestors;		/**< 祖先列表，由根部件到父部件 */
+} ancestor_filter;
+
 /** 部件的缺省样式 */
 const char *global_css = CodeToString(
 
@@ -189,14 +238,330 @@ int Widget_HandleChildrenStyleChange( LCUI_Widget w, int type, const char *name
 	return count;
 }
 
+/** 获取部件选择器结点全名的原子，结果会被缓存，直到部件的 id、类型、类或状态发生变化 */
+static LCUI_Atom Widget_GetSelectorAtom( LCUI_Widget w )
+{
+	LCUI_SelectorNode sn;
+	if( w->selector_atom != LCUI_ATOM_NONE ) {
+		return w->selector_atom;
+	}
+	sn = Widget_GetSelectorNode( w );
+	w->selector_atom = sn->atom;
+	SelectorNode_Delete( sn );
+	return w->selector_atom;
+}
+
+/**
+ * 计算部件选择器的哈希值
+ * 结果与 Widget_GetSelector() 生成的选择器的哈希值一致，但不需要生成选择器
+ */
+static int Widget_GetSelectorHash( LCUI_Widget w, unsigned int *hash )
+{
+	int i = MAX_SELECTOR_DEPTH;
+	LCUI_Widget parent;
+	LCUI_Atom atoms[MAX_SELECTOR_DEPTH];
+	for( parent = w; parent; parent = parent->parent ) {
+		if( parent->id || parent->type ||
+		    parent->classes || parent->status ) {
+			if( i <= 1 ) {
+				return -1;
+			}
+			atoms[--i] = Widget_GetSelectorAtom( parent );
+		}
+	}
+	*hash = Selector_GetHash( atoms + i, MAX_SELECTOR_DEPTH - i );
+	return 0;
+}
+
+LCUI_BOOL Widget_PushAncestorFilter( LCUI_Widget w )
+{
+	int i;
+	Ancestor a;
+	LCUI_SelectorNode sn;
+	LinkedList *list = &ancestor_filter.ancestors;
+
+	/* 只有在从根部件开始逐级向下记录时，过滤器才包含完整的祖先信息 */
+	if( w->parent ) {
+		if( list->length < 1 ||
+		    ((Ancestor)list->tail.prev->data)->widget != w->parent ) {
+			return FALSE;
+		}
+	} else if( list->length > 0 ) {
+		return FALSE;
+	}
+	a = NEW( AncestorRec, 1 );
+	if( !a ) {
+		return FALSE;
+	}
+	sn = Widget_GetSelectorNode( w );
+	a->widget = w;
+	a->atom = sn->atom;
+	a->nkeys = SelectorNode_GetFilterKeys( sn, &a->keys );
+	SelectorNode_Delete( sn );
+	if( a->nkeys < 0 ) {
+		free( a );
+		return FALSE;
+	}
+	w->selector_atom = a->atom;
+	for( i = 0; i < a->nkeys; ++i ) {
+		SelectorFilter_Add( &ancestor_filter.filter, a->keys[i] );
+	}
+	LinkedList_Append( list, a );
+	return TRUE;
+}
+
+void Widget_PopAncestorFilter( LCUI_Widget w )
+{
+	int i;
+	Ancestor a;
+	LinkedListNode *node;
+	LinkedList *list = &ancestor_filter.ancestors;
+
+	node = list->tail.prev;
+	if( list->length < 1 || ((Ancestor)node->data)->widget != w ) {
+		return;
+	}
+	a = node->data;
+	for( i = 0; i < a->nkeys; ++i ) {
+		SelectorFilter_Remove( &ancestor_filter.filter, a->keys[i] );
+	}
+	LinkedList_DeleteNode( list, node );
+	if( a->keys ) {
+		free( a->keys );
+	}
+	free( a );
+}
+
+/**
+ * 获取适用于部件的祖先过滤器
+ * 过滤器中记录的祖先必须与部件当前的祖先完全一致，且它们的 id、类型、类和状态
+ * 在记录后没有变化，否则过滤器可能会排除掉实际能匹配的规则。
+ */
+static LCUI_SelectorFilter Widget_GetAncestorFilter( LCUI_Widget w )
+{
+	Ancestor a;
+	LCUI_Widget parent;
+	LinkedListNode *node;
+
+	parent = w->parent;
+	for( LinkedList_EachReverse( node, &ancestor_filter.ancestors ) ) {
+		a = node->data;
+		if( a->widget != parent ) {
+			return NULL;
+		}
+		if( a->atom == LCUI_ATOM_NONE ) {
+			if( parent->id || parent->type ||
+			    parent->classes || parent->status ) {
+				return NULL;
+			}
+		} else if( Widget_GetSelectorAtom( parent ) != a->atom ) {
+			return NULL;
+		}
+		parent = parent->parent;
+	}
+	if( parent ) {
+		return NULL;
+	}
+	return &ancestor_filter.filter;
+}
+
+/**
+ * 判断部件是否与选择器结点匹配
+ * 结果与 SelectorNode_Match() 相同，但直接比较部件的属性，不需要生成选择器结点
+ */
+static LCUI_BOOL Widget_MatchSelectorNode( LCUI_Widget w,
+					   LCUI_SelectorNode sn )
+{
+	int i;
+	if( sn->id && (!w->id || strcmp( w->id, sn->id ) != 0) ) {
+		return FALSE;
+	}
+	if( sn->type && strcmp( sn->type, "*" ) != 0 &&
+	    (!w->type || strcmp( w->type, sn->type ) != 0) ) {
+		return FALSE;
+	}
+	for( i = 0; sn->classes && sn->classes[i]; ++i ) {
+		if( !strshas( w->classes, sn->classes[i] ) ) {
+			return FALSE;
+		}
+	}
+	for( i = 0; sn->status && sn->status[i]; ++i ) {
+		if( !strshas( w->status, sn->status[i] ) ) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/** 判断部件是否与上下文中的某个选择器结点匹配 */
+static LCUI_BOOL StatusMatchContext_Match( StatusMatchContext ctx,
+					   LCUI_Widget w )
+{
+	unsigned int i;
+	LinkedListNode *node;
+	LCUI_BOOL matched = FALSE;
+
+	/* 只使用部件已缓存的原子，避免为计算原子而生成选择器结点 */
+	i = w->selector_atom & (STATUS_MATCH_CACHE_SIZE - 1);
+	if( w->selector_atom != LCUI_ATOM_NONE &&
+	    ctx->cache[i].atom == w->selector_atom ) {
+		return ctx->cache[i].matched;
+	}
+	for( LinkedList_Each( node, ctx->nodes ) ) {
+		if( Widget_MatchSelectorNode( w, node->data ) ) {
+			matched = TRUE;
+			break;
+		}
+	}
+	if( w->selector_atom != LCUI_ATOM_NONE ) {
+		ctx->cache[i].atom = w->selector_atom;
+		ctx->cache[i].matched = matched;
+	}
+	return matched;
+}
+
+/** 为能与选择器结点列表中某个结点匹配的后代部件添加样式刷新任务 */
+static void Widget_RefreshStatusDependents( LCUI_Widget w,
+					    StatusMatchContext ctx )
+{
+	LCUI_Widget child;
+	LinkedListNode *node;
+
+	for( LinkedList_Each( node, &w->children ) ) {
+		child = node->data;
+		if( !child->task.buffer[WTT_REFRESH_STYLE] &&
+		    StatusMatchContext_Match( ctx, child ) ) {
+			Widget_AddTask( child, WTT_REFRESH_STYLE );
+			++ctx->count;
+		}
+		Widget_RefreshStatusDependents( child, ctx );
+	}
+}
+
+int Widget_HandleStatusChange( LCUI_Widget w, const char *name )
+{
+	int count;
+	LinkedList nodes;
+	LCUI_SelectorNode sn;
+	StatusMatchContextRec ctx;
+
+	LinkedList_Init( &nodes );
+	sn = Widget_GetSelectorNode( w );
+	if( LCUI_CheckStatusDependency( name, sn ) ) {
+		Widget_UpdateStyle( w, TRUE );
+	}
+	count = LCUI_GetStatusDependents( name, sn, &nodes );
+	if( count > 0 ) {
+		memset( ctx.cache, 0, sizeof( ctx.cache ) );
+		ctx.nodes = &nodes;
+		ctx.count = 0;
+		Widget_RefreshStatusDependents( w, &ctx );
+	}
+	LinkedList_Clear( &nodes, (FuncPtr)SelectorNode_Delete );
+	SelectorNode_Delete( sn );
+	return count;
+}
+
 void Widget_GetInheritStyle( LCUI_Widget w, LCUI_StyleSheet out_ss )
 {
+	unsigned int hash;
 	LCUI_Selector s;
+	if( Widget_GetSelectorHash( w, &hash ) == 0 &&
+	    LCUI_GetCachedStyleSheet( hash, out_ss ) == 0 ) {
+		return;
+	}
 	s = Widget_GetSelector( w );
-	LCUI_GetStyleSheet( s, out_ss );
+	LCUI_GetStyleSheetWithFilter( s, Widget_GetAncestorFilter( w ),
+				      out_ss );
 	Selector_Delete( s );
 }
 
+static SharedStyleSheet SharedStyleSheet_New( void )
+{
+	SharedStyleSheet sss;
+	sss = NEW( SharedStyleSheetRec, 1 );
+	sss->ref_count = 1;
+	sss->atom = LCUI_ATOM_NONE;
+	sss->sheet.length = LCUI_GetStyleTotal();
+	sss->sheet.sheet = NEW( LCUI_StyleRec, sss->sheet.length + 1 );
+	return sss;
+}
+
+static void SharedStyleSheet_Release( SharedStyleSheet sss )
+{
+	if( --sss->ref_count > 0 ) {
+		return;
+	}
+	StyleSheet_Clear( &sss->sheet );
+	free( sss->sheet.sheet );
+	free( sss );
+}
+
+void Widget_InitInheritedStyle( LCUI_Widget w )
+{
+	SharedStyleSheet sss = SharedStyleSheet_New();
+	w->inherited_style = &sss->sheet;
+}
+
+void Widget_DestroyInheritedStyle( LCUI_Widget w )
+{
+	SharedStyleSheet_Release( (SharedStyleSheet)w->inherited_style );
+	w->inherited_style = NULL;
+}
+
+/**
+ * 尝试与前面的兄弟部件共享继承样式表
+ * 兄弟部件的父级选择器链相同，只要选择器结点也相同，且它的继承样式表是基于当前
+ * 版本的样式库计算的，那么它的继承样式表也适用于当前部件，不必再匹配样式规则。
+ */
+static LCUI_BOOL Widget_ShareInheritedStyle( LCUI_Widget w )
+{
+	int i;
+	LCUI_Atom atom;
+	unsigned int version;
+	LCUI_Widget sibling;
+	SharedStyleSheet sss;
+
+	if( !w->parent ) {
+		return FALSE;
+	}
+	atom = Widget_GetSelectorAtom( w );
+	version = LCUI_GetStyleSheetVersion();
+	sibling = Widget_GetPrev( w );
+	for( i = 0; sibling && i < STYLE_SHARING_MAX_SIBLINGS; ++i ) {
+		sss = (SharedStyleSheet)sibling->inherited_style;
+		if( sibling->selector_atom == atom && sss->atom == atom &&
+		    sss->version == version &&
+		    !sibling->task.buffer[WTT_REFRESH_STYLE] ) {
+			if( &sss->sheet != w->inherited_style ) {
+				Widget_DestroyInheritedStyle( w );
+				w->inherited_style = &sss->sheet;
+				sss->ref_count += 1;
+			}
+			return TRUE;
+		}
+		sibling = Widget_GetPrev( sibling );
+	}
+	return FALSE;
+}
+
+/** 重新计算部件的继承样式表，若它正被其它部件共享，则先复制一份 */
+static void Widget_ResolveInheritedStyle( LCUI_Widget w )
+{
+	SharedStyleSheet sss;
+	sss = (SharedStyleSheet)w->inherited_style;
+	if( sss->ref_count > 1 ) {
+		sss->ref_count -= 1;
+		sss = SharedStyleSheet_New();
+		w->inherited_style = &sss->sheet;
+	}
+	sss->version = LCUI_GetStyleSheetVersion();
+	LCUITrace_Begin( "style", "css lookup" );
+	Widget_GetInheritStyle( w, w->inherited_style );
+	LCUITrace_End( "style", "css lookup" );
+	sss->atom = Widget_GetSelectorAtom( w );
+}
+
 void Widget_UpdateStyle( LCUI_Widget w, LCUI_BOOL is_update_all )
 {
 	if( is_update_all ) {
@@ -214,7 +579,7 @@ void Widget_ExecUpdateStyle( LCUI_Widget w, LCUI_BOOL is_update_all )
 	LCUI_BOOL need_update_expend_style = FALSE;
 	TaskMap task_map[] = {
 		{ key_display_start, key_display_end, WTT_VISIBLE, TRUE },
-		{ key_opacity, key_opacity, WTT_OPACITY, TRUE },
+		{ key_opacity, key_will_change, WTT_OPACITY, TRUE },
 		{ key_z_index, key_z_index, WTT_ZINDEX, TRUE },
 		{ key_width, key_height, WTT_RESIZE, TRUE },
 		{ key_padding_start, key_padding_end, WTT_RESIZE, TRUE },
@@ -228,8 +593,8 @@ void Widget_ExecUpdateStyle( LCUI_Widget w, LCUI_BOOL is_update_all )
 		{ key_box_sizing, key_box_sizing, WTT_RESIZE, TRUE }
 	};
 
-	if( is_update_all ) {
-		Widget_GetInheritStyle( w, w->inherited_style );
+	if( is_update_all && !Widget_ShareInheritedStyle( w ) ) {
+		Widget_ResolveInheritedStyle( w );
 	}
 	ss = w->style;
 	w->style = StyleSheet();
@@ -267,6 +632,8 @@ void Widget_ExecUpdateStyle( LCUI_Widget w, LCUI_BOOL is_update_all )
 
 void LCUIWidget_InitStyle( void )
 {
+	LinkedList_Init( &ancestor_filter.ancestors );
+	SelectorFilter_Init( &ancestor_filter.filter );
 	LCUI_InitCSSLibrary();
 	LCUI_InitCSSParser();
 	LCUI_LoadCSSString( global_css, NULL );
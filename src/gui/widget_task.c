@@ -42,11 +42,13 @@
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/gui/widget.h>
+#include <LCUI/trace.h>
 
 /** 部件任务模块数据 */
 static struct WidgetTaskModule {
 	LinkedList trash;				/**< 待删除的部件列表 */
 	LCUI_WidgetFunction handlers[WTT_TOTAL_NUM];	/**< 任务处理器 */
+	const char *names[WTT_TOTAL_NUM];		/**< 任务名称，用于事件跟踪 */
 } self;
 
 static void HandleRefreshStyle( LCUI_Widget w )
@@ -115,6 +117,7 @@ void Widget_AddTask( LCUI_Widget widget, int task )
 		widget->task.for_children = TRUE;
 		widget = widget->parent;
 	}
+	LCUI_Wakeup();
 }
 
 /** 映射任务处理器 */
@@ -136,6 +139,22 @@ static void MapTaskHandler(void)
 	self.handlers[WTT_LAYOUT] = Widget_ExecUpdateLayout;
 	self.handlers[WTT_ZINDEX] = Widget_ExecUpdateZIndex;
 	self.handlers[WTT_PROPS] = Widget_UpdateProps;
+	self.names[WTT_VISIBLE] = "visible";
+	self.names[WTT_POSITION] = "position";
+	self.names[WTT_RESIZE] = "resize";
+	self.names[WTT_SHADOW] = "shadow";
+	self.names[WTT_BORDER] = "border";
+	self.names[WTT_OPACITY] = "opacity";
+	self.names[WTT_MARGIN] = "margin";
+	self.names[WTT_BODY] = "body";
+	self.names[WTT_TITLE] = "title";
+	self.names[WTT_REFRESH] = "refresh";
+	self.names[WTT_UPDATE_STYLE] = "update style";
+	self.names[WTT_REFRESH_STYLE] = "refresh style";
+	self.names[WTT_BACKGROUND] = "background";
+	self.names[WTT_LAYOUT] = "layout";
+	self.names[WTT_ZINDEX] = "z-index";
+	self.names[WTT_PROPS] = "props";
 }
 
 static void LCUIWidget_ClearTrash( void )
@@ -183,7 +202,7 @@ void Widget_AddToTrash( LCUI_Widget w )
 int Widget_Update( LCUI_Widget w )
 {
 	int i;
-	LCUI_BOOL *buffer;
+	LCUI_BOOL *buffer, filtered;
 	LinkedListNode *node, *next;
 
 	/* 如果该部件没有任务需要处理 */
@@ -194,13 +213,17 @@ int Widget_Update( LCUI_Widget w )
 	buffer = w->task.buffer;
 	/* 如果有用户自定义任务 */
 	if( buffer[WTT_USER] && w->proto && w->proto->runtask ) {
+		LCUITrace_Begin( "widget task", "user" );
 		w->proto->runtask( w );
+		LCUITrace_End( "widget task", "user" );
 	}
 	for( i = 0; i < WTT_USER; ++i ) {
 		if( buffer[i] ) {
 			buffer[i] = FALSE;
 			if( self.handlers[i] ) {
+				LCUITrace_Begin( "widget task", self.names[i] );
 				self.handlers[i]( w );
+				LCUITrace_End( "widget task", self.names[i] );
 			}
 		} else {
 			buffer[i] = FALSE;
@@ -226,6 +249,8 @@ proc_children_task:
 	}
 	/* 如果子级部件中有待处理的部件，则递归进去 */
 	w->task.for_children = FALSE;
+	/* 记录祖先信息，以便子级部件在匹配样式时排除不可能匹配的规则 */
+	filtered = Widget_PushAncestorFilter( w );
 	node = w->children.head.next;
 	while( node ) {
 		LCUI_Widget child = node->data;
@@ -240,6 +265,9 @@ proc_children_task:
 		}
 		node = next;
 	}
+	if( filtered ) {
+		Widget_PopAncestorFilter( w );
+	}
 	return w->task.for_self || w->task.for_children;
 }
 
@@ -223,6 +223,10 @@ int LCUI_ReadPNG( LCUI_ImageReader reader, LCUI_Graph *graph )
 			}
 		}
 	}
+	/* 图像处理模块使用的是预乘 alpha 的像素格式 */
+	if( graph->color_type == COLOR_TYPE_ARGB ) {
+		Graph_SetColorType( graph, COLOR_TYPE_PARGB );
+	}
 	return ret;
 #else
 	_DEBUG_MSG( "warning: not PNG support!" );
@@ -287,8 +291,8 @@ int LCUI_WritePNGFile( const char *file_name, const LCUI_Graph *graph )
 
 	Graph_GetValidRect( graph, &rect );
 	graph = Graph_GetQuote( graph );
-	if( graph->color_type == COLOR_TYPE_ARGB ) {
-		LCUI_ARGB *px_ptr, *px_row_ptr;
+	if( ColorType_IsARGB( graph->color_type ) ) {
+		LCUI_ARGB px, *px_ptr, *px_row_ptr;
 
 		row_size = png_get_rowbytes( png_ptr, info_ptr );
 		px_row_ptr = graph->argb + rect.y * graph->width + rect.x;
@@ -297,10 +301,18 @@ int LCUI_WritePNGFile( const char *file_name, const LCUI_Graph *graph )
 			row_pointers[y] = png_malloc( png_ptr, row_size );
 			px_ptr = px_row_ptr;
 			for( x = 0; x < row_size; ++px_ptr ) {
-				row_pointers[y][x++] = px_ptr->red;
-				row_pointers[y][x++] = px_ptr->green;
-				row_pointers[y][x++] = px_ptr->blue;
-				row_pointers[y][x++] = px_ptr->alpha;
+				px = *px_ptr;
+				/* PNG 文件中存储的是未预乘 alpha 的像素 */
+				if( graph->color_type == COLOR_TYPE_PARGB ) {
+					PixelsFormat( (uchar_t*)px_ptr,
+						      COLOR_TYPE_PARGB,
+						      (uchar_t*)&px,
+						      COLOR_TYPE_ARGB, 1 );
+				}
+				row_pointers[y][x++] = px.red;
+				row_pointers[y][x++] = px.green;
+				row_pointers[y][x++] = px.blue;
+				row_pointers[y][x++] = px.alpha;
 			}
 			px_row_ptr += graph->width;
 		}
@@ -45,6 +45,7 @@
 #include <LCUI/LCUI.h>
 #include <LCUI/graph.h>
 #include <LCUI/image.h>
+#include <LCUI/trace.h>
 
 typedef struct LCUI_ImageInterfaceRec_ {
 	const char *suffix;
@@ -149,9 +150,12 @@ int LCUI_ReadImageHeader( LCUI_ImageReader reader )
 
 int LCUI_ReadImage( LCUI_ImageReader reader, LCUI_Graph *out )
 {
-	int i = reader->type - 1;
+	int ret, i = reader->type - 1;
 	if( i < n_interfaces && i >= 0 ) {
-		return interfaces[i].read( reader, out );
+		LCUITrace_Begin( "image", interfaces[i].suffix );
+		ret = interfaces[i].read( reader, out );
+		LCUITrace_End( "image", interfaces[i].suffix );
+		return ret;
 	}
 	return -ENODATA;
 }
@@ -50,7 +50,10 @@
 #include <LCUI/input.h>
 #include <LCUI/display.h>
 #include <LCUI/ime.h>
+#include <LCUI/framestats.h>
+#include <LCUI/trace.h>
 #include <LCUI/platform.h>
+#include <LCUI/util/atomic.h>
 #include LCUI_EVENTS_H
 #include LCUI_MOUSE_H
 #include LCUI_KEYBOARD_H
@@ -62,6 +65,9 @@
 /** 一秒内的最大更新帧数 */
 #define MAX_FRAMES_PER_SEC 100
 
+/** 预分配的任务节点数量，须为 2 的幂 */
+#define TASK_POOL_SIZE 1024
+
 /** 主循环的状态 */
 enum MainLoopState {
 	STATE_PAUSED,
@@ -75,6 +81,20 @@ typedef struct SysEventHandlerRec_ {
 	void (*destroy_data)(void*);
 } SysEventHandlerRec, *SysEventHandler;
 
+/** 任务队列中的节点 */
+typedef struct TaskNodeRec_ TaskNodeRec, *TaskNode;
+struct TaskNodeRec_ {
+	LCUI_AppTaskRec task;		/**< 任务数据 */
+	TaskNode volatile next;		/**< 下一个节点 */
+	LCUI_BOOL is_pooled;		/**< 是否属于预分配的节点池 */
+};
+
+/** 空闲节点池中的单元，序号用于判断它当前能否被存入或取出 */
+typedef struct TaskPoolCellRec_ {
+	volatile long seq;
+	TaskNode node;
+} TaskPoolCellRec, *TaskPoolCell;
+
 typedef struct SysEventPackRec_ {
 	LCUI_SysEvent event;
 	void *arg;
@@ -101,11 +121,23 @@ static struct LCUI_App {
 	StepTimer timer;		/**< 渲染循环计数器 */
 	LCUI_AppDriver driver;		/**< 程序事件驱动支持 */
 	LCUI_BOOL driver_ready;		/**< 事件驱动支持是否已经准备就绪 */
+	LCUI_BOOL idle_wait;		/**< 是否在空闲时阻塞等待，而不是按帧率循环 */
+	LCUI_BOOL is_waiting;		/**< 主循环是否正在（或即将）阻塞等待 */
 	struct LCUI_AppTaskAgent {
 		int state;		/**< 状态 */
-		LinkedList tasks;	/**< 任务队列 */
+		TaskNode volatile head;	/**< 队列头部，即最近提交的任务节点 */
+		TaskNode tail;		/**< 队列尾部，只由主线程访问 */
+		TaskNodeRec stub;	/**< 占位节点，让提交和取出操作互不干扰 */
+		volatile long waiting;	/**< 主线程是否正在等待任务 */
 		LCUI_Mutex mutex;	/**< 互斥锁 */
 		LCUI_Cond cond;		/**< 条件变量 */
+		/** 空闲节点池，用有界的无锁队列实现 */
+		struct {
+			TaskNodeRec nodes[TASK_POOL_SIZE];
+			TaskPoolCellRec cells[TASK_POOL_SIZE];
+			volatile long enqueue_pos;
+			volatile long dequeue_pos;
+		} pool;
 	} agent;
 } MainApp;
 
@@ -229,47 +261,245 @@ void LCUI_DestroyEvent( LCUI_SysEvent e )
 
 /*--------------------------- system event <END> ----------------------------*/
 
-LCUI_BOOL LCUI_ProcessTask( void )
+/*---------------------------- task queue <START> ----------------------------*/
+
+/**
+ * 任务队列是一个无锁的多生产者单消费者队列
+ * 各个线程通过原子交换操作把节点挂到队列头部，只有主线程从尾部取出节点，因
+ * 此提交任务不需要加锁，也不会和主线程争抢。节点优先从预分配的节点池中获取，
+ * 池中没有空闲节点时才动态分配。
+ */
+
+static void TaskPool_Init( void )
 {
-	LCUI_AppTask task;
-	LinkedListNode *node;
-	LCUIMutex_Lock( &MainApp.agent.mutex );
-	node = LinkedList_GetNode( &MainApp.agent.tasks, 0 );
-	if( node ) {
-		task = node->data;
-		LinkedList_Unlink( &MainApp.agent.tasks, node );
-		LCUIMutex_Unlock( &MainApp.agent.mutex );
-		LCUI_RunTask( task );
-		LCUI_DeleteTask( task );
-		free( task );
+	int i;
+	for( i = 0; i < TASK_POOL_SIZE; ++i ) {
+		MainApp.agent.pool.nodes[i].is_pooled = TRUE;
+		MainApp.agent.pool.cells[i].node = &MainApp.agent.pool.nodes[i];
+		MainApp.agent.pool.cells[i].seq = i + 1;
+	}
+	MainApp.agent.pool.enqueue_pos = TASK_POOL_SIZE;
+	MainApp.agent.pool.dequeue_pos = 0;
+}
+
+/** 从节点池中取出一个空闲节点，没有空闲节点时返回 NULL */
+static TaskNode TaskPool_Get( void )
+{
+	long pos, seq, diff;
+	TaskPoolCell cell;
+	pos = LCUI_AtomicLoad( &MainApp.agent.pool.dequeue_pos );
+	while( 1 ) {
+		cell = &MainApp.agent.pool.cells[pos & (TASK_POOL_SIZE - 1)];
+		seq = LCUI_AtomicLoad( &cell->seq );
+		diff = (long)((unsigned long)seq - (unsigned long)pos - 1);
+		if( diff < 0 ) {
+			return NULL;
+		}
+		if( diff == 0 && LCUI_AtomicCompareExchange(
+			&MainApp.agent.pool.dequeue_pos, pos, pos + 1 ) ) {
+			break;
+		}
+		pos = LCUI_AtomicLoad( &MainApp.agent.pool.dequeue_pos );
+	}
+	LCUI_AtomicStore( &cell->seq, pos + TASK_POOL_SIZE );
+	return cell->node;
+}
+
+/** 将节点放回节点池 */
+static void TaskPool_Put( TaskNode node )
+{
+	long pos, seq, diff;
+	TaskPoolCell cell;
+	pos = LCUI_AtomicLoad( &MainApp.agent.pool.enqueue_pos );
+	while( 1 ) {
+		cell = &MainApp.agent.pool.cells[pos & (TASK_POOL_SIZE - 1)];
+		seq = LCUI_AtomicLoad( &cell->seq );
+		diff = (long)((unsigned long)seq - (unsigned long)pos);
+		/* 池中的节点不会超过它的容量，不会出现没有位置的情况 */
+		if( diff == 0 && LCUI_AtomicCompareExchange(
+			&MainApp.agent.pool.enqueue_pos, pos, pos + 1 ) ) {
+			break;
+		}
+		pos = LCUI_AtomicLoad( &MainApp.agent.pool.enqueue_pos );
+	}
+	cell->node = node;
+	LCUI_AtomicStore( &cell->seq, pos + 1 );
+}
+
+static TaskNode TaskNode_New( void )
+{
+	TaskNode node;
+	node = TaskPool_Get();
+	if( !node ) {
+		node = malloc( sizeof( TaskNodeRec ) );
+		if( !node ) {
+			return NULL;
+		}
+		node->is_pooled = FALSE;
+	}
+	return node;
+}
+
+static void TaskNode_Delete( TaskNode node )
+{
+	if( node->is_pooled ) {
+		TaskPool_Put( node );
+	} else {
 		free( node );
-		return TRUE;
 	}
-	LCUIMutex_Unlock( &MainApp.agent.mutex );
-	return FALSE;
+}
+
+static void TaskQueue_Init( void )
+{
+	MainApp.agent.stub.next = NULL;
+	MainApp.agent.head = &MainApp.agent.stub;
+	MainApp.agent.tail = &MainApp.agent.stub;
+	MainApp.agent.waiting = 0;
+	TaskPool_Init();
+}
+
+/** 提交节点，可在任意线程中调用 */
+static void TaskQueue_Push( TaskNode node )
+{
+	TaskNode prev;
+	node->next = NULL;
+	prev = LCUI_AtomicExchangePtr( &MainApp.agent.head, node );
+	LCUI_AtomicStorePtr( &prev->next, node );
+}
+
+/** 取出节点，只能在主线程中调用 */
+static TaskNode TaskQueue_Pop( void )
+{
+	TaskNode head, tail, next;
+	tail = MainApp.agent.tail;
+	next = LCUI_AtomicLoad( &tail->next );
+	if( tail == &MainApp.agent.stub ) {
+		if( !next ) {
+			return NULL;
+		}
+		MainApp.agent.tail = next;
+		tail = next;
+		next = LCUI_AtomicLoad( &tail->next );
+	}
+	if( next ) {
+		MainApp.agent.tail = next;
+		return tail;
+	}
+	head = LCUI_AtomicLoad( &MainApp.agent.head );
+	/* 有线程提交到一半，它的节点还没连上，等下次再取 */
+	if( tail != head ) {
+		return NULL;
+	}
+	/* 重新挂上占位节点，让最后一个节点可以被取出 */
+	TaskQueue_Push( &MainApp.agent.stub );
+	next = LCUI_AtomicLoad( &tail->next );
+	if( next ) {
+		MainApp.agent.tail = next;
+		return tail;
+	}
+	return NULL;
+}
+
+/** 判断队列是否为空，只能在主线程中调用 */
+static LCUI_BOOL TaskQueue_IsEmpty( void )
+{
+	return MainApp.agent.tail == &MainApp.agent.stub &&
+		LCUI_AtomicLoad( &MainApp.agent.head ) == &MainApp.agent.stub;
+}
+
+static void TaskQueue_Clear( void )
+{
+	TaskNode node;
+	while( (node = TaskQueue_Pop()) != NULL ) {
+		LCUI_DeleteTask( &node->task );
+		TaskNode_Delete( node );
+	}
+}
+
+/*----------------------------- task queue <END> -----------------------------*/
+
+LCUI_BOOL LCUI_ProcessTask( void )
+{
+	TaskNode node;
+	node = TaskQueue_Pop();
+	if( !node ) {
+		return FALSE;
+	}
+	LCUI_RunTask( &node->task );
+	LCUI_DeleteTask( &node->task );
+	TaskNode_Delete( node );
+	return TRUE;
+}
+
+/**
+ * 处理任务队列中的任务
+ * 只处理在调用之前提交的任务，任务中新提交的任务留到下一次处理，避免主循环
+ * 被不断提交的任务卡住
+ */
+static size_t LCUIApp_ProcessTasks( void )
+{
+	size_t count = 0;
+	TaskNode node, last;
+	last = LCUI_AtomicLoad( &MainApp.agent.head );
+	while( (node = TaskQueue_Pop()) != NULL ) {
+		LCUI_RunTask( &node->task );
+		LCUI_DeleteTask( &node->task );
+		TaskNode_Delete( node );
+		++count;
+		if( node == last ) {
+			break;
+		}
+	}
+	return count;
 }
 
 void LCUI_ProcessEvents( void )
 {
-	int i;
-	for( i = 0; LCUI_ProcessTask() && i < 100; ++i );
+	LCUITimer_Process();
+	LCUIApp_ProcessTasks();
+	LCUIFrameStats_EndPhase( LCUI_FPHASE_TASKS );
 	if( MainApp.driver_ready ) {
 		MainApp.driver->ProcessEvents();
 	}
+	LCUIFrameStats_EndPhase( LCUI_FPHASE_EVENTS );
+}
+
+/** 唤醒正在等待任务的主线程 */
+static void LCUIApp_WakeupAgent( void )
+{
+	if( MainApp.driver_ready && MainApp.driver->Wakeup ) {
+		MainApp.driver->Wakeup();
+		return;
+	}
+	LCUIMutex_Lock( &MainApp.agent.mutex );
+	LCUICond_Signal( &MainApp.agent.cond );
+	LCUIMutex_Unlock( &MainApp.agent.mutex );
 }
 
 LCUI_BOOL LCUI_PostTask( LCUI_AppTask task )
 {
+	TaskNode node;
 	LCUI_AppTask newtask;
-	newtask = NEW( LCUI_AppTaskRec, 1 );
-	*newtask = *task;
-	if( MainApp.driver_ready && MainApp.agent.state != STATE_RUNNING ) {
+	/* 没有提供 PostTask() 的驱动会在它的事件循环中处理任务队列 */
+	if( MainApp.driver_ready && MainApp.driver->PostTask &&
+	    MainApp.agent.state != STATE_RUNNING ) {
+		newtask = NEW( LCUI_AppTaskRec, 1 );
+		*newtask = *task;
 		return MainApp.driver->PostTask( newtask );
-	} else {
-		LCUIMutex_Lock( &MainApp.agent.mutex );
-		LinkedList_Append( &MainApp.agent.tasks, newtask );
-		LCUICond_Signal( &MainApp.agent.cond );
-		LCUIMutex_Unlock( &MainApp.agent.mutex );
+	}
+	node = TaskNode_New();
+	if( !node ) {
+		return FALSE;
+	}
+	node->task = *task;
+	TaskQueue_Push( node );
+	/**
+	 * 主线程没在等待的话，它会在下一帧处理任务，不必唤醒
+	 * 任务代理暂停时，主线程可能正阻塞在驱动的事件循环中，需要唤醒
+	 */
+	if( MainApp.agent.state != STATE_RUNNING ||
+	    LCUI_AtomicLoad( &MainApp.agent.waiting ) ) {
+		LCUIApp_WakeupAgent();
 	}
 	return TRUE;
 }
@@ -287,12 +517,52 @@ void LCUI_DeleteTask( LCUI_AppTask task )
 int LCUI_RunTask( LCUI_AppTask task )
 {
 	if( task && task->func ) {
+		LCUITrace_Begin( "task", "task" );
 		task->func( task->arg[0], task->arg[1] );
+		LCUITrace_End( "task", "task" );
 		return 0;
 	}
 	return -1;
 }
 
+void LCUI_Wakeup( void )
+{
+	LCUI_AppTaskRec task = { 0 };
+	if( !MainApp.is_waiting ) {
+		return;
+	}
+	/* 一个空任务足以唤醒各平台的等待操作，重复唤醒没有意义 */
+	MainApp.is_waiting = FALSE;
+	/* 驱动能直接唤醒主循环时，就不必再提交空任务 */
+	if( MainApp.driver_ready && MainApp.driver->Wakeup ) {
+		MainApp.driver->Wakeup();
+		return;
+	}
+	LCUI_PostTask( &task );
+}
+
+void LCUI_SetIdleWait( LCUI_BOOL enabled )
+{
+	MainApp.idle_wait = enabled;
+}
+
+/**
+ * 在没有需要处理的工作时阻塞等待
+ * 先标记等待状态再检查，其它线程在检查之后提交的更新都会唤醒主循环
+ */
+static void LCUIApp_WaitWork( void )
+{
+	/* 虚拟时钟只随帧推进，阻塞等待会让定时器永远不会到期 */
+	if( LCUITime_IsVirtualClock() ) {
+		return;
+	}
+	MainApp.is_waiting = TRUE;
+	if( !LCUIDisplay_NeedUpdate() ) {
+		LCUI_WaitEvent();
+	}
+	MainApp.is_waiting = FALSE;
+}
+
 /* 新建一个主循环 */
 LCUI_MainLoop LCUIMainLoop_New( void )
 {
@@ -327,12 +597,21 @@ int LCUIMainLoop_Run( LCUI_MainLoop loop )
 	DEBUG_MSG( "loop: %p, enter\n", loop );
 	MainApp.loop = loop;
 	while( loop->state != STATE_EXITED ) {
-		//LCUI_WaitEvent();
+		LCUIFrameStats_BeginFrame();
+		if( MainApp.idle_wait ) {
+			LCUIApp_WaitWork();
+			LCUIFrameStats_EndPhase( LCUI_FPHASE_SLEEP );
+		}
 		LCUI_ProcessEvents();
 		LCUIDisplay_Update();
+		LCUIFrameStats_EndPhase( LCUI_FPHASE_UPDATE );
 		LCUIDisplay_Render();
+		LCUIFrameStats_EndPhase( LCUI_FPHASE_RENDER );
 		LCUIDisplay_Present();
+		LCUIFrameStats_EndPhase( LCUI_FPHASE_PRESENT );
 		StepTimer_Remain( MainApp.timer );
+		LCUIFrameStats_EndPhase( LCUI_FPHASE_SLEEP );
+		LCUIFrameStats_EndFrame();
 		/* 如果当前运行的主循环不是自己 */
 		while( MainApp.loop != loop ) {
 			loop->state = STATE_PAUSED;
@@ -357,6 +636,7 @@ int LCUIMainLoop_Run( LCUI_MainLoop loop )
 void LCUIMainLoop_Quit( LCUI_MainLoop loop )
 {
 	loop->state = STATE_EXITED;
+	LCUI_Wakeup();
 }
 
 void LCUI_InitApp( LCUI_AppDriver app )
@@ -372,7 +652,7 @@ void LCUI_InitApp( LCUI_AppDriver app )
 	LinkedList_Init( &MainApp.loops );
 	LCUIMutex_Init( &MainApp.agent.mutex );
 	LCUICond_Init( &MainApp.agent.cond );
-	LinkedList_Init( &MainApp.agent.tasks );
+	TaskQueue_Init();
 	StepTimer_SetFrameLimit( MainApp.timer, MAX_FRAMES_PER_SEC );
 	if( !app ) {
 		app = LCUI_CreateAppDriver();
@@ -384,12 +664,6 @@ void LCUI_InitApp( LCUI_AppDriver app )
 	MainApp.driver_ready = TRUE;
 }
 
-static void OnDeleteTask( void *arg )
-{
-	LCUI_DeleteTask( arg );
-	free( arg );
-}
-
 static void LCUI_ExitApp( void )
 {
 	LCUI_MainLoop loop;
@@ -405,7 +679,7 @@ static void LCUI_ExitApp( void )
 	LCUIMutex_Destroy( &MainApp.agent.mutex );
 	LCUICond_Destroy( &MainApp.agent.cond );
 	LinkedList_Clear( &MainApp.loops, free );
-	LinkedList_Clear( &MainApp.agent.tasks, OnDeleteTask );
+	TaskQueue_Clear();
 	if( MainApp.driver_ready ) {
 		LCUI_DestroyAppDriver( MainApp.driver );
 	}
@@ -414,23 +688,39 @@ static void LCUI_ExitApp( void )
 
 LCUI_BOOL LCUI_WaitEvent( void )
 {
-	if( MainApp.agent.tasks.length > 0 ) {
+	LCUI_BOOL ret = TRUE;
+	if( !TaskQueue_IsEmpty() ) {
 		return TRUE;
 	}
 	if( MainApp.agent.state != STATE_RUNNING ) {
 		return MainApp.driver->WaitEvent();
 	}
+	/**
+	 * 先标记等待状态再检查队列，提交任务的线程在挂上节点之后才检查该标记，
+	 * 因此不会出现两边都没看到对方的情况
+	 */
+	LCUI_AtomicStore( &MainApp.agent.waiting, 1 );
+	if( !TaskQueue_IsEmpty() ) {
+		LCUI_AtomicStore( &MainApp.agent.waiting, 0 );
+		return TRUE;
+	}
+	/* 能被唤醒的驱动可以同时等待任务和系统事件 */
+	if( MainApp.driver_ready && MainApp.driver->Wakeup ) {
+		ret = MainApp.driver->WaitEvent();
+		LCUI_AtomicStore( &MainApp.agent.waiting, 0 );
+		return ret;
+	}
 	LCUIMutex_Lock( &MainApp.agent.mutex );
-	while( MainApp.agent.state == STATE_RUNNING ) {
-		if( MainApp.agent.tasks.length > 0 ||
-		    MainApp.agent.state != STATE_RUNNING ) {
-			LCUIMutex_Unlock( &MainApp.agent.mutex );
-			return TRUE;
+	while( TaskQueue_IsEmpty() ) {
+		if( MainApp.agent.state != STATE_RUNNING ) {
+			ret = FALSE;
+			break;
 		}
 		LCUICond_Wait( &MainApp.agent.cond, &MainApp.agent.mutex );
 	}
 	LCUIMutex_Unlock( &MainApp.agent.mutex );
-	return FALSE;
+	LCUI_AtomicStore( &MainApp.agent.waiting, 0 );
+	return ret;
 }
 
 int LCUI_BindSysEvent( int event_id, LCUI_EventFunc func,
@@ -540,6 +830,8 @@ void LCUI_InitBase( void )
 	System.main_tid = LCUIThread_SelfID();
 	LCUI_ShowCopyrightText();
 	/* 初始化各个模块 */
+	LCUIAtom_Init();
+	LCUI_InitGraph();
 	LCUI_InitEvent();
 	LCUI_InitFont();
 	LCUI_InitTimer();
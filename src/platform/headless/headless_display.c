@@ -0,0 +1,294 @@
+/* ***************************************************************************
+ * headless_display.c -- in-memory display driver without a window system.
+ *
+ * Copyright (C) 2017 by Liu Chao <lc-soft@live.cn>
+ *
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ *
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ *
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *
+ * The LCUI project is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ *
+ * You should have received a copy of the GPLv2 along with this file. It is
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+/* ****************************************************************************
+ * headless_display.c -- 无界面的图形显示功能支持，surface 的内容只保存在内存中。
+ *
+ * 版权所有 (C) 2017 归属于 刘超 <lc-soft@live.cn>
+ *
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ *
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ *
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#define LCUI_SURFACE_C
+#include <LCUI/LCUI.h>
+#include <LCUI/image.h>
+#include <LCUI/thread.h>
+#include <LCUI/display.h>
+
+#define SCREEN_WIDTH	1920
+#define SCREEN_HEIGHT	1080
+#define MAX_PATH_LEN	256
+
+typedef struct LCUI_SurfaceRec_ {
+	int id;				/**< 编号，用于区分转储的帧文件 */
+	int x, y;			/**< 位置 */
+	int mode;			/**< 渲染模式 */
+	float opacity;			/**< 不透明度 */
+	LCUI_BOOL visible;		/**< 是否可见 */
+	LCUI_Graph fb;			/**< 帧缓存 */
+	LCUI_Mutex mutex;		/**< 互斥锁 */
+	LinkedListNode node;		/**< 在表面列表中的结点 */
+} LCUI_SurfaceRec;
+
+static struct HeadlessDisplay {
+	LCUI_BOOL is_inited;		/**< 标记，标识当前模块是否已经初始化 */
+	int surface_count;		/**< 已创建的表面数量，用于分配编号 */
+	unsigned int frame_count;	/**< 已呈现的帧数 */
+	char dump_path[MAX_PATH_LEN];	/**< 帧转储目录，为空时不转储 */
+	LinkedList surfaces;		/**< 表面列表 */
+	LCUI_EventTrigger trigger;	/**< 事件触发器 */
+} headless = { 0 };
+
+static LCUI_Surface HeadlessSurface_New( void )
+{
+	LCUI_Surface surface;
+	surface = NEW( LCUI_SurfaceRec, 1 );
+	if( !surface ) {
+		return NULL;
+	}
+	surface->id = headless.surface_count++;
+	surface->opacity = 1.0;
+	surface->visible = FALSE;
+	surface->node.data = surface;
+	Graph_Init( &surface->fb );
+	surface->fb.color_type = COLOR_TYPE_RGB;
+	LCUIMutex_Init( &surface->mutex );
+	LinkedList_AppendNode( &headless.surfaces, &surface->node );
+	return surface;
+}
+
+static void HeadlessSurface_Delete( LCUI_Surface surface )
+{
+	LinkedList_Unlink( &headless.surfaces, &surface->node );
+	LCUIMutex_Destroy( &surface->mutex );
+	Graph_Free( &surface->fb );
+	free( surface );
+}
+
+static void HeadlessSurface_Close( LCUI_Surface surface )
+{
+	surface->visible = FALSE;
+}
+
+static LCUI_BOOL HeadlessSurface_IsReady( LCUI_Surface surface )
+{
+	return TRUE;
+}
+
+static void HeadlessSurface_Move( LCUI_Surface surface, int x, int y )
+{
+	surface->x = x;
+	surface->y = y;
+}
+
+static void HeadlessSurface_Resize( LCUI_Surface surface,
+				    int width, int height )
+{
+	if( width < 1 || height < 1 ) {
+		return;
+	}
+	if( surface->fb.width == width && surface->fb.height == height ) {
+		return;
+	}
+	LCUIMutex_Lock( &surface->mutex );
+	Graph_Create( &surface->fb, width, height );
+	Graph_FillRect( &surface->fb, RGB( 255, 255, 255 ), NULL, FALSE );
+	LCUIMutex_Unlock( &surface->mutex );
+}
+
+static void HeadlessSurface_Show( LCUI_Surface surface )
+{
+	surface->visible = TRUE;
+}
+
+static void HeadlessSurface_Hide( LCUI_Surface surface )
+{
+	surface->visible = FALSE;
+}
+
+static void HeadlessSurface_SetCaptionW( LCUI_Surface surface,
+					 const wchar_t *str )
+{
+	return;
+}
+
+static void HeadlessSurface_SetOpacity( LCUI_Surface surface, float opacity )
+{
+	surface->opacity = opacity;
+}
+
+static void HeadlessSurface_SetRenderMode( LCUI_Surface surface, int mode )
+{
+	surface->mode = mode;
+}
+
+static void HeadlessSurface_Update( LCUI_Surface surface )
+{
+	return;
+}
+
+/** 获取 surface 的句柄，即它的帧缓存 */
+static void *HeadlessSurface_GetHandle( LCUI_Surface surface )
+{
+	return &surface->fb;
+}
+
+static LCUI_PaintContext HeadlessSurface_BeginPaint( LCUI_Surface surface,
+						     LCUI_Rect *rect )
+{
+	LCUI_PaintContext paint;
+	paint = malloc( sizeof( LCUI_PaintContextRec ) );
+	if( !paint ) {
+		return NULL;
+	}
+	paint->rect = *rect;
+	paint->with_alpha = FALSE;
+	paint->arena = NULL;
+	paint->region = NULL;
+	Graph_Init( &paint->canvas );
+	LCUIMutex_Lock( &surface->mutex );
+	LCUIRect_ValidateArea( &paint->rect, surface->fb.width,
+			       surface->fb.height );
+	Graph_Quote( &paint->canvas, &surface->fb, &paint->rect );
+	return paint;
+}
+
+static void HeadlessSurface_EndPaint( LCUI_Surface surface,
+				      LCUI_PaintContext paint )
+{
+	free( paint );
+	LCUIMutex_Unlock( &surface->mutex );
+}
+
+/** 呈现帧缓存，如果设置了转储目录，则将当前帧保存为 PNG 文件 */
+static void HeadlessSurface_Present( LCUI_Surface surface )
+{
+	char path[MAX_PATH_LEN + 32];
+	++headless.frame_count;
+	if( !headless.dump_path[0] || !Graph_IsValid( &surface->fb ) ) {
+		return;
+	}
+	sprintf( path, "%s/frame-%06u-%d.png", headless.dump_path,
+		 headless.frame_count, surface->id );
+	LCUIMutex_Lock( &surface->mutex );
+	if( LCUI_WritePNGFile( path, &surface->fb ) != 0 ) {
+		LOG( "[headless] cannot write frame: %s\n", path );
+	}
+	LCUIMutex_Unlock( &surface->mutex );
+}
+
+static int HeadlessDisplay_BindEvent( int event_id, LCUI_EventFunc func,
+				      void *data, void( *destroy_data )(void*) )
+{
+	return EventTrigger_Bind( headless.trigger, event_id, func,
+				  data, destroy_data );
+}
+
+static int HeadlessDisplay_GetWidth( void )
+{
+	return SCREEN_WIDTH;
+}
+
+static int HeadlessDisplay_GetHeight( void )
+{
+	return SCREEN_HEIGHT;
+}
+
+int LCUIHeadless_SetDumpPath( const char *path )
+{
+	if( !path ) {
+		headless.dump_path[0] = 0;
+		return 0;
+	}
+	if( strlen( path ) >= MAX_PATH_LEN ) {
+		return -1;
+	}
+	strcpy( headless.dump_path, path );
+	return 0;
+}
+
+unsigned int LCUIHeadless_GetFrameCount( void )
+{
+	return headless.frame_count;
+}
+
+LCUI_DisplayDriver LCUI_CreateHeadlessDisplay( void )
+{
+	const char *path;
+	ASSIGN( driver, LCUI_DisplayDriver );
+	if( !driver ) {
+		return NULL;
+	}
+	strcpy( driver->name, "headless" );
+	driver->can_present_async = TRUE;
+	driver->getWidth = HeadlessDisplay_GetWidth;
+	driver->getHeight = HeadlessDisplay_GetHeight;
+	driver->create = HeadlessSurface_New;
+	driver->destroy = HeadlessSurface_Delete;
+	driver->close = HeadlessSurface_Close;
+	driver->isReady = HeadlessSurface_IsReady;
+	driver->show = HeadlessSurface_Show;
+	driver->hide = HeadlessSurface_Hide;
+	driver->move = HeadlessSurface_Move;
+	driver->resize = HeadlessSurface_Resize;
+	driver->update = HeadlessSurface_Update;
+	driver->present = HeadlessSurface_Present;
+	driver->setCaptionW = HeadlessSurface_SetCaptionW;
+	driver->setRenderMode = HeadlessSurface_SetRenderMode;
+	driver->setOpacity = HeadlessSurface_SetOpacity;
+	driver->getHandle = HeadlessSurface_GetHandle;
+	driver->beginPaint = HeadlessSurface_BeginPaint;
+	driver->endPaint = HeadlessSurface_EndPaint;
+	driver->bindEvent = HeadlessDisplay_BindEvent;
+	if( !headless.is_inited ) {
+		LinkedList_Init( &headless.surfaces );
+		headless.trigger = EventTrigger();
+		headless.is_inited = TRUE;
+	}
+	headless.frame_count = 0;
+	path = getenv( "LCUI_HEADLESS_DUMP" );
+	if( path ) {
+		LCUIHeadless_SetDumpPath( path );
+	}
+	/* 没有垂直同步和窗口系统的干扰，使用虚拟时钟以使每次运行的结果都相同 */
+	LCUITime_SetVirtualClock( TRUE );
+	return driver;
+}
+
+void LCUI_DestroyHeadlessDisplay( LCUI_DisplayDriver driver )
+{
+	LCUITime_SetVirtualClock( FALSE );
+	free( driver );
+}
@@ -1,4 +1,6 @@
 
+#include <stdlib.h>
+#include <string.h>
 #include <LCUI_Build.h>
 #ifdef LCUI_BUILD_IN_LINUX
 #include <LCUI/LCUI.h>
@@ -7,20 +9,37 @@
 #include LCUI_EVENTS_H
 #include LCUI_DISPLAY_H
 
+/**
+ * 创建显示驱动
+ * 默认使用 X11，如果环境变量 LCUI_DISPLAY 为 fbdev，或者 X11 不可用，则使用
+ * 帧缓存设备
+ */
 LCUI_DisplayDriver LCUI_CreateLinuxDisplayDriver( void )
 {
-	LCUI_BOOL is_x11_mode = TRUE;
-	if( is_x11_mode ) {
-		return LCUI_CreateLinuxX11DisplayDriver();
+	LCUI_DisplayDriver driver = NULL;
+#ifdef LCUI_VIDEO_DRIVER_FRAMEBUFFER
+	char *env = getenv( "LCUI_DISPLAY" );
+	if( env && strcmp( env, "fbdev" ) == 0 ) {
+		return LCUI_CreateLinuxFBDisplayDriver();
 	}
-	return NULL;
+#endif
+	driver = LCUI_CreateLinuxX11DisplayDriver();
+#ifdef LCUI_VIDEO_DRIVER_FRAMEBUFFER
+	if( !driver ) {
+		driver = LCUI_CreateLinuxFBDisplayDriver();
+	}
+#endif
+	return driver;
 }
 
 void LCUI_DestroyLinuxDisplayDriver( LCUI_DisplayDriver driver )
 {
-	LCUI_BOOL is_x11_mode = TRUE;
-	if( is_x11_mode ) {
-		LCUI_DestroyLinuxX11DisplayDriver( driver );
+#ifdef LCUI_VIDEO_DRIVER_FRAMEBUFFER
+	if( strcmp( driver->name, "fbdev" ) == 0 ) {
+		LCUI_DestroyLinuxFBDisplayDriver( driver );
+		return;
 	}
+#endif
+	LCUI_DestroyLinuxX11DisplayDriver( driver );
 }
 #endif
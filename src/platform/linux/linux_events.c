@@ -1,11 +1,239 @@
-
 #include <LCUI_Build.h>
 #ifdef LCUI_BUILD_IN_LINUX
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
 #include <LCUI/LCUI.h>
+#include <LCUI/timer.h>
 #include <LCUI/display.h>
 #include <LCUI/platform.h>
 #include LCUI_EVENTS_H
 
+/** 每次等待最多取出的事件数量 */
+#define MAX_EVENTS 16
+
+/** 文件描述符监听记录 */
+typedef struct LinuxFdWatcherRec_ {
+	int fd;
+	void( *func )(void*);
+	void *arg;
+	LinkedListNode node;
+} LinuxFdWatcherRec, *LinuxFdWatcher;
+
+/**
+ * Linux 事件循环
+ * 用一个 epoll 实例同时等待系统事件源、定时器和其它线程的唤醒，所有回调
+ * 都在主线程中执行
+ */
+static struct LinuxEventLoop {
+	int epfd;			/**< epoll 实例 */
+	int wakefd;			/**< 用于唤醒主循环的 eventfd */
+	int timerfd;			/**< 按最近的定时器到期时间设置的 timerfd */
+	LinuxFdWatcherRec wake;		/**< wakefd 的监听记录 */
+	LinuxFdWatcherRec timer;	/**< timerfd 的监听记录 */
+	LinkedList watchers;		/**< 外部添加的监听记录 */
+	LCUI_BOOL is_x11_mode;		/**< 是否使用 X11 的事件驱动 */
+	LCUI_EventTrigger trigger;	/**< 非 X11 模式下的系统事件触发器 */
+} self = { -1, -1, -1 };
+
+/** 读出计数，让 eventfd 和 timerfd 回到不可读的状态 */
+static void OnClearCounter( void *arg )
+{
+	uint64_t n;
+	int *fd = arg;
+	while( read( *fd, &n, sizeof( n ) ) == sizeof( n ) );
+}
+
+static int LinuxEvents_AddWatcher( LinuxFdWatcher watcher )
+{
+	struct epoll_event ev;
+	memset( &ev, 0, sizeof( ev ) );
+	ev.events = EPOLLIN;
+	ev.data.ptr = watcher;
+	if( epoll_ctl( self.epfd, EPOLL_CTL_ADD, watcher->fd, &ev ) != 0 ) {
+		return -errno;
+	}
+	return 0;
+}
+
+/** 等待事件并调用就绪的文件描述符的回调函数 */
+static int LinuxEvents_Poll( int timeout )
+{
+	int i, n;
+	LinuxFdWatcher watcher;
+	struct epoll_event events[MAX_EVENTS];
+	n = epoll_wait( self.epfd, events, MAX_EVENTS, timeout );
+	for( i = 0; i < n; ++i ) {
+		watcher = events[i].data.ptr;
+		if( watcher->func ) {
+			watcher->func( watcher->arg );
+		}
+	}
+	return n;
+}
+
+/** 让 timerfd 在 n_ms 毫秒后可读，n_ms 小于 0 时停用它 */
+static void LinuxEvents_SetTimer( long int n_ms )
+{
+	struct itimerspec spec;
+	memset( &spec, 0, sizeof( spec ) );
+	if( n_ms >= 0 ) {
+		spec.it_value.tv_sec = n_ms / 1000;
+		spec.it_value.tv_nsec = (n_ms % 1000) * 1000000;
+	}
+	timerfd_settime( self.timerfd, 0, &spec, NULL );
+}
+
+static int LinuxEvents_Init( void )
+{
+	LinkedList_Init( &self.watchers );
+	self.epfd = epoll_create1( EPOLL_CLOEXEC );
+	if( self.epfd < 0 ) {
+		return -errno;
+	}
+	self.wakefd = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+	self.timerfd = timerfd_create( CLOCK_MONOTONIC,
+				       TFD_NONBLOCK | TFD_CLOEXEC );
+	if( self.wakefd < 0 || self.timerfd < 0 ) {
+		return -errno;
+	}
+	self.wake.fd = self.wakefd;
+	self.wake.func = OnClearCounter;
+	self.wake.arg = &self.wakefd;
+	self.timer.fd = self.timerfd;
+	self.timer.func = OnClearCounter;
+	self.timer.arg = &self.timerfd;
+	if( LinuxEvents_AddWatcher( &self.wake ) != 0 ||
+	    LinuxEvents_AddWatcher( &self.timer ) != 0 ) {
+		return -errno;
+	}
+	return 0;
+}
+
+static void LinuxEvents_Exit( void )
+{
+	LinkedList_ClearData( &self.watchers, free );
+	if( self.timerfd >= 0 ) {
+		close( self.timerfd );
+	}
+	if( self.wakefd >= 0 ) {
+		close( self.wakefd );
+	}
+	if( self.epfd >= 0 ) {
+		close( self.epfd );
+	}
+	self.epfd = self.wakefd = self.timerfd = -1;
+}
+
+int LCUI_WatchLinuxFd( int fd, void( *func )(void*), void *arg )
+{
+	int ret;
+	LinuxFdWatcher watcher;
+	if( self.epfd < 0 ) {
+		return -1;
+	}
+	watcher = NEW( LinuxFdWatcherRec, 1 );
+	if( !watcher ) {
+		return -ENOMEM;
+	}
+	watcher->fd = fd;
+	watcher->arg = arg;
+	watcher->func = func;
+	watcher->node.data = watcher;
+	ret = LinuxEvents_AddWatcher( watcher );
+	if( ret != 0 ) {
+		free( watcher );
+		return ret;
+	}
+	LinkedList_AppendNode( &self.watchers, &watcher->node );
+	return 0;
+}
+
+int LCUI_UnwatchLinuxFd( int fd )
+{
+	LinuxFdWatcher watcher;
+	LinkedListNode *node;
+	for( LinkedList_Each( node, &self.watchers ) ) {
+		watcher = node->data;
+		if( watcher->fd != fd ) {
+			continue;
+		}
+		epoll_ctl( self.epfd, EPOLL_CTL_DEL, fd, NULL );
+		LinkedList_Unlink( &self.watchers, node );
+		free( watcher );
+		return 0;
+	}
+	return -1;
+}
+
+void LCUI_ProcessLinuxEvents( void )
+{
+	LinuxEvents_Poll( 0 );
+}
+
+LCUI_BOOL LCUI_WaitLinuxEvent( void )
+{
+	long int n_ms;
+	n_ms = LCUITimer_GetTimeout();
+	if( n_ms == 0 ) {
+		return TRUE;
+	}
+	LinuxEvents_SetTimer( n_ms );
+	return LinuxEvents_Poll( -1 ) > 0;
+}
+
+void LCUI_WakeupLinuxApp( void )
+{
+	uint64_t n = 1;
+	if( write( self.wakefd, &n, sizeof( n ) ) < 0 ) {
+		/* 计数已满时 eventfd 必然可读，主循环依然会被唤醒 */
+		return;
+	}
+}
+
+static int Linux_BindSysEvent( int event_id, LCUI_EventFunc func,
+			       void *data, void( *destroy_data )(void*) )
+{
+	return EventTrigger_Bind( self.trigger, event_id, func,
+				  data, destroy_data );
+}
+
+static int Linux_UnbindSysEvent( int event_id, LCUI_EventFunc func )
+{
+	return EventTrigger_Unbind( self.trigger, event_id, func );
+}
+
+static int Linux_UnbindSysEvent2( int handler_id )
+{
+	return EventTrigger_Unbind2( self.trigger, handler_id );
+}
+
+static void *Linux_GetData( void )
+{
+	return NULL;
+}
+
+/** 创建不依赖窗口系统的事件驱动，用于帧缓冲和无头显示模式 */
+static LCUI_AppDriver LCUI_CreateLinuxBasicAppDriver( void )
+{
+	ASSIGN( app, LCUI_AppDriver );
+	app->WaitEvent = LCUI_WaitLinuxEvent;
+	app->ProcessEvents = LCUI_ProcessLinuxEvents;
+	app->PostTask = NULL;
+	app->Wakeup = LCUI_WakeupLinuxApp;
+	app->BindSysEvent = Linux_BindSysEvent;
+	app->UnbindSysEvent = Linux_UnbindSysEvent;
+	app->UnbindSysEvent2 = Linux_UnbindSysEvent2;
+	app->GetData = Linux_GetData;
+	self.trigger = EventTrigger();
+	return app;
+}
+
 void LCUI_PreInitLinuxApp( void *data )
 {
 	return;
@@ -13,19 +241,35 @@ void LCUI_PreInitLinuxApp( void *data )
 
 LCUI_AppDriver LCUI_CreateLinuxAppDriver( void )
 {
-	LCUI_BOOL is_x11_mode = TRUE;
-	if( is_x11_mode ) {
-		return LCUI_CreateLinuxX11AppDriver();
+	LCUI_AppDriver app;
+	if( LinuxEvents_Init() != 0 ) {
+		LOG( "[linux] cannot create event loop: %s\n",
+		     strerror( errno ) );
+		LinuxEvents_Exit();
+		return NULL;
 	}
-	return NULL;
+	self.is_x11_mode = TRUE;
+	app = LCUI_CreateLinuxX11AppDriver();
+	if( !app ) {
+		self.is_x11_mode = FALSE;
+		app = LCUI_CreateLinuxBasicAppDriver();
+	}
+	/* 定时器改由事件循环中的 timerfd 驱动，不再需要定时器线程 */
+	LCUITimer_SetMainLoopMode( TRUE );
+	return app;
 }
 
 void LCUI_DestroyLinuxAppDriver( LCUI_AppDriver driver )
 {
-	LCUI_BOOL is_x11_mode = TRUE;
-	if( is_x11_mode ) {
+	if( self.is_x11_mode ) {
 		LCUI_DestroyLinuxX11AppDriver( driver );
+	} else {
+		EventTrigger_Destroy( self.trigger );
+		self.trigger = NULL;
+		free( driver );
 	}
+	LCUITimer_SetMainLoopMode( FALSE );
+	LinuxEvents_Exit();
 }
 
 #endif
@@ -1 +1,615 @@
+/* ***************************************************************************
+ * linux_fbdisplay.c -- surface support for linux framebuffer.
+ *
+ * Copyright (C) 2017 by Liu Chao <lc-soft@live.cn>
+ *
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ *
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ *
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *
+ * The LCUI project is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ *
+ * You should have received a copy of the GPLv2 along with this file. It is
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
 
+/* ****************************************************************************
+ * linux_fbdisplay.c -- linux 平台的图形显示功能支持，基于帧缓存(FrameBuffer)。
+ *
+ * 版权所有 (C) 2017 归属于 刘超 <lc-soft@live.cn>
+ *
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ *
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ *
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#define LCUI_SURFACE_C
+#if defined(LCUI_BUILD_IN_LINUX) && defined(LCUI_VIDEO_DRIVER_FRAMEBUFFER)
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <linux/fb.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
+#include <LCUI/display.h>
+#include <LCUI/platform.h>
+#include LCUI_DISPLAY_H
+
+#define DEFAULT_DEVICE	"/dev/fb0"
+#define DEFAULT_WIDTH	800
+#define DEFAULT_HEIGHT	600
+#define DEFAULT_BPP	32
+#define MAX_PAGES	2
+
+typedef struct LCUI_SurfaceRec_ {
+	int x, y;			/**< 在屏幕中的位置 */
+	int mode;			/**< 渲染模式 */
+	LCUI_BOOL visible;		/**< 是否可见 */
+	LCUI_Graph fb;			/**< 后台缓存，绘制操作都在这里进行 */
+	LCUI_Mutex mutex;		/**< 互斥锁 */
+	LinkedListNode node;		/**< 在表面列表中的结点 */
+} LCUI_SurfaceRec;
+
+static struct FrameBufferDisplay {
+	LCUI_BOOL is_inited;		/**< 标记，标识当前模块是否已经初始化 */
+	int fd;				/**< 设备文件描述符 */
+	int width, height;		/**< 屏幕尺寸 */
+	int bpp;			/**< 每个像素的位数 */
+	int color_type;			/**< 帧缓存的像素格式 */
+	size_t line_length;		/**< 每行像素占用的字节数 */
+	size_t page_size;		/**< 每一页占用的字节数 */
+	size_t mem_len;			/**< 映射的内存大小 */
+	uchar_t *mem;			/**< 映射的帧缓存 */
+	int num_pages;			/**< 页数，大于 1 时使用翻页来切换帧 */
+	int page;			/**< 当前显示的页 */
+	struct fb_var_screeninfo var;	/**< 设备的可变参数 */
+	LCUI_RegionRec dirty[MAX_PAGES];/**< 每一页中内容已过时的区域 */
+	LCUI_Mutex mutex;		/**< 互斥锁 */
+	LinkedList surfaces;		/**< 表面列表，靠后的表面显示在上层 */
+	LCUI_EventTrigger trigger;	/**< 事件触发器 */
+} fbdev = { 0 };
+
+/** 标记屏幕中的区域需要在所有页中更新 */
+static void FBDisplay_InvalidateArea( LCUI_Rect *rect )
+{
+	int i;
+	LCUI_Rect area = *rect;
+	LCUIRect_ValidateArea( &area, fbdev.width, fbdev.height );
+	if( area.width < 1 || area.height < 1 ) {
+		return;
+	}
+	LCUIMutex_Lock( &fbdev.mutex );
+	if( fbdev.num_pages > 1 ) {
+		for( i = 0; i < fbdev.num_pages; ++i ) {
+			Region_UnionRect( &fbdev.dirty[i], &area );
+		}
+	} else {
+		Region_UnionRect( &fbdev.dirty[fbdev.page], &area );
+	}
+	LCUIMutex_Unlock( &fbdev.mutex );
+}
+
+static void FBSurface_Invalidate( LCUI_Surface surface )
+{
+	LCUI_Rect rect;
+	rect.x = surface->x;
+	rect.y = surface->y;
+	rect.width = surface->fb.width;
+	rect.height = surface->fb.height;
+	FBDisplay_InvalidateArea( &rect );
+}
+
+/** 将后台缓存中的一块区域转换为帧缓存的像素格式，并写入到指定页中 */
+static void FBDisplay_WriteArea( LCUI_Surface surface, LCUI_Rect *rect,
+				 uchar_t *page )
+{
+	int y;
+	const uchar_t *src;
+	uchar_t *dst;
+	size_t bytes_per_px = fbdev.bpp / 8;
+	src = surface->fb.bytes + (rect->y - surface->y) *
+	      surface->fb.bytes_per_row + (rect->x - surface->x) *
+	      surface->fb.bytes_per_pixel;
+	dst = page + rect->y * fbdev.line_length + rect->x * bytes_per_px;
+	for( y = 0; y < rect->height; ++y ) {
+		if( fbdev.color_type == COLOR_TYPE_ARGB8888 ) {
+			memcpy( dst, src, rect->width * 4 );
+		} else {
+			PixelsFormat( src, surface->fb.color_type, dst,
+				      fbdev.color_type, rect->width );
+		}
+		src += surface->fb.bytes_per_row;
+		dst += fbdev.line_length;
+	}
+}
+
+/** 用各个表面的内容重绘页中的一块区域，没有表面覆盖的部分填充为黑色 */
+static void FBDisplay_PaintArea( LCUI_Rect *rect, uchar_t *page )
+{
+	int y;
+	LCUI_Rect area, surface_rect;
+	LinkedListNode *node;
+	LCUI_BOOL covered = FALSE;
+	size_t bytes_per_px = fbdev.bpp / 8;
+
+	for( LinkedList_Each( node, &fbdev.surfaces ) ) {
+		LCUI_Surface s = node->data;
+		if( !s->visible || !Graph_IsValid( &s->fb ) ) {
+			continue;
+		}
+		surface_rect.x = s->x;
+		surface_rect.y = s->y;
+		surface_rect.width = s->fb.width;
+		surface_rect.height = s->fb.height;
+		if( surface_rect.x <= rect->x && surface_rect.y <= rect->y &&
+		    surface_rect.x + surface_rect.width >=
+		    rect->x + rect->width &&
+		    surface_rect.y + surface_rect.height >=
+		    rect->y + rect->height ) {
+			covered = TRUE;
+			break;
+		}
+	}
+	if( !covered ) {
+		for( y = rect->y; y < rect->y + rect->height; ++y ) {
+			memset( page + y * fbdev.line_length +
+				rect->x * bytes_per_px, 0,
+				rect->width * bytes_per_px );
+		}
+	}
+	for( LinkedList_Each( node, &fbdev.surfaces ) ) {
+		LCUI_Surface s = node->data;
+		if( !s->visible || !Graph_IsValid( &s->fb ) ) {
+			continue;
+		}
+		surface_rect.x = s->x;
+		surface_rect.y = s->y;
+		surface_rect.width = s->fb.width;
+		surface_rect.height = s->fb.height;
+		if( !LCUIRect_GetOverlayRect( &surface_rect, rect, &area ) ) {
+			continue;
+		}
+		LCUIMutex_Lock( &s->mutex );
+		FBDisplay_WriteArea( s, &area, page );
+		LCUIMutex_Unlock( &s->mutex );
+	}
+}
+
+/**
+ * 将过时的区域写入后台页，然后翻页
+ * 只有一页时直接写入正在显示的页
+ */
+static void FBDisplay_Flush( void )
+{
+	int i, target;
+	uchar_t *page;
+	LCUI_Region dirty;
+
+	LCUIMutex_Lock( &fbdev.mutex );
+	target = fbdev.page;
+	if( fbdev.num_pages > 1 ) {
+		target = (fbdev.page + 1) % fbdev.num_pages;
+	}
+	dirty = &fbdev.dirty[target];
+	if( dirty->length < 1 ) {
+		LCUIMutex_Unlock( &fbdev.mutex );
+		return;
+	}
+	page = fbdev.mem + target * fbdev.page_size;
+	for( i = 0; i < dirty->length; ++i ) {
+		FBDisplay_PaintArea( &dirty->rects[i], page );
+	}
+	Region_Clear( dirty );
+	if( target == fbdev.page ) {
+		LCUIMutex_Unlock( &fbdev.mutex );
+		return;
+	}
+	fbdev.var.xoffset = 0;
+	fbdev.var.yoffset = target * fbdev.height;
+	if( ioctl( fbdev.fd, FBIOPAN_DISPLAY, &fbdev.var ) < 0 ) {
+		LOG( "[fbdisplay] page flipping failed, disabled\n" );
+		/* 翻页失败时退回到单页模式，后台页已是最新的内容，将它复制
+		 * 到正在显示的页即可 */
+		memcpy( fbdev.mem + fbdev.page * fbdev.page_size, page,
+			fbdev.page_size );
+		Region_Clear( &fbdev.dirty[fbdev.page] );
+		fbdev.num_pages = 1;
+		LCUIMutex_Unlock( &fbdev.mutex );
+		return;
+	}
+	fbdev.page = target;
+	LCUIMutex_Unlock( &fbdev.mutex );
+}
+
+static LCUI_Surface FBSurface_New( void )
+{
+	LCUI_Surface surface;
+	surface = NEW( LCUI_SurfaceRec, 1 );
+	if( !surface ) {
+		return NULL;
+	}
+	surface->visible = FALSE;
+	surface->node.data = surface;
+	Graph_Init( &surface->fb );
+	surface->fb.color_type = COLOR_TYPE_PARGB;
+	LCUIMutex_Init( &surface->mutex );
+	LCUIMutex_Lock( &fbdev.mutex );
+	LinkedList_AppendNode( &fbdev.surfaces, &surface->node );
+	LCUIMutex_Unlock( &fbdev.mutex );
+	return surface;
+}
+
+static void FBSurface_Delete( LCUI_Surface surface )
+{
+	if( surface->visible ) {
+		FBSurface_Invalidate( surface );
+	}
+	LCUIMutex_Lock( &fbdev.mutex );
+	LinkedList_Unlink( &fbdev.surfaces, &surface->node );
+	LCUIMutex_Unlock( &fbdev.mutex );
+	LCUIMutex_Destroy( &surface->mutex );
+	Graph_Free( &surface->fb );
+	free( surface );
+	FBDisplay_Flush();
+}
+
+static LCUI_BOOL FBSurface_IsReady( LCUI_Surface surface )
+{
+	return TRUE;
+}
+
+static void FBSurface_Move( LCUI_Surface surface, int x, int y )
+{
+	if( surface->x == x && surface->y == y ) {
+		return;
+	}
+	FBSurface_Invalidate( surface );
+	surface->x = x;
+	surface->y = y;
+	FBSurface_Invalidate( surface );
+}
+
+static void FBSurface_Resize( LCUI_Surface surface, int width, int height )
+{
+	if( width < 1 || height < 1 ) {
+		return;
+	}
+	if( surface->fb.width == width && surface->fb.height == height ) {
+		return;
+	}
+	FBSurface_Invalidate( surface );
+	LCUIMutex_Lock( &surface->mutex );
+	Graph_Create( &surface->fb, width, height );
+	Graph_FillRect( &surface->fb, RGB( 255, 255, 255 ), NULL, TRUE );
+	LCUIMutex_Unlock( &surface->mutex );
+	FBSurface_Invalidate( surface );
+}
+
+static void FBSurface_Show( LCUI_Surface surface )
+{
+	if( !surface->visible ) {
+		surface->visible = TRUE;
+		FBSurface_Invalidate( surface );
+	}
+}
+
+static void FBSurface_Hide( LCUI_Surface surface )
+{
+	if( surface->visible ) {
+		surface->visible = FALSE;
+		FBSurface_Invalidate( surface );
+	}
+}
+
+static void FBSurface_Close( LCUI_Surface surface )
+{
+	FBSurface_Hide( surface );
+}
+
+static void FBSurface_SetCaptionW( LCUI_Surface surface, const wchar_t *str )
+{
+	return;
+}
+
+static void FBSurface_SetOpacity( LCUI_Surface surface, float opacity )
+{
+	return;
+}
+
+static void FBSurface_SetRenderMode( LCUI_Surface surface, int mode )
+{
+	surface->mode = mode;
+}
+
+static void FBSurface_Update( LCUI_Surface surface )
+{
+	return;
+}
+
+static void *FBSurface_GetHandle( LCUI_Surface surface )
+{
+	return NULL;
+}
+
+static LCUI_PaintContext FBSurface_BeginPaint( LCUI_Surface surface,
+					       LCUI_Rect *rect )
+{
+	LCUI_PaintContext paint;
+	paint = malloc( sizeof( LCUI_PaintContextRec ) );
+	if( !paint ) {
+		return NULL;
+	}
+	paint->rect = *rect;
+	paint->with_alpha = FALSE;
+	paint->arena = NULL;
+	paint->region = NULL;
+	Graph_Init( &paint->canvas );
+	LCUIMutex_Lock( &surface->mutex );
+	LCUIRect_ValidateArea( &paint->rect, surface->fb.width,
+			       surface->fb.height );
+	Graph_Quote( &paint->canvas, &surface->fb, &paint->rect );
+	return paint;
+}
+
+static void FBSurface_EndPaint( LCUI_Surface surface, LCUI_PaintContext paint )
+{
+	int i;
+	LCUI_Rect rect;
+	LCUIMutex_Unlock( &surface->mutex );
+	if( !surface->visible ) {
+		free( paint );
+		return;
+	}
+	/* 只记录绘制过的区域，呈现时仅复制这些区域 */
+	if( paint->region ) {
+		for( i = 0; i < paint->region->length; ++i ) {
+			rect = paint->region->rects[i];
+			rect.x += surface->x;
+			rect.y += surface->y;
+			FBDisplay_InvalidateArea( &rect );
+		}
+	} else {
+		rect = paint->rect;
+		rect.x += surface->x;
+		rect.y += surface->y;
+		FBDisplay_InvalidateArea( &rect );
+	}
+	free( paint );
+}
+
+static void FBSurface_Present( LCUI_Surface surface )
+{
+	FBDisplay_Flush();
+}
+
+static int FBDisplay_BindEvent( int event_id, LCUI_EventFunc func,
+				void *data, void( *destroy_data )(void*) )
+{
+	return EventTrigger_Bind( fbdev.trigger, event_id, func,
+				  data, destroy_data );
+}
+
+static int FBDisplay_GetWidth( void )
+{
+	return fbdev.width;
+}
+
+static int FBDisplay_GetHeight( void )
+{
+	return fbdev.height;
+}
+
+/** 从设备或普通文件中获取帧缓存的参数 */
+static int FBDisplay_GetInfo( int width, int height, int bpp )
+{
+	struct stat st;
+	struct fb_fix_screeninfo fix;
+
+	if( fstat( fbdev.fd, &st ) < 0 ) {
+		return -errno;
+	}
+	fbdev.num_pages = 1;
+	memset( &fbdev.var, 0, sizeof( fbdev.var ) );
+	/* 普通文件没有设备参数，按给定的参数来使用 */
+	if( S_ISREG( st.st_mode ) ) {
+		fbdev.width = width;
+		fbdev.height = height;
+		fbdev.bpp = bpp;
+		fbdev.line_length = width * (bpp / 8);
+		fbdev.mem_len = fbdev.line_length * height;
+		if( (size_t)st.st_size < fbdev.mem_len &&
+		    ftruncate( fbdev.fd, fbdev.mem_len ) < 0 ) {
+			return -errno;
+		}
+		fbdev.var.green.length = 6;
+		return 0;
+	}
+	if( ioctl( fbdev.fd, FBIOGET_FSCREENINFO, &fix ) < 0 ||
+	    ioctl( fbdev.fd, FBIOGET_VSCREENINFO, &fbdev.var ) < 0 ) {
+		return -errno;
+	}
+	fbdev.width = fbdev.var.xres;
+	fbdev.height = fbdev.var.yres;
+	fbdev.bpp = fbdev.var.bits_per_pixel;
+	fbdev.line_length = fix.line_length;
+	fbdev.mem_len = fix.smem_len;
+	/* 虚拟分辨率能容纳两页，且支持纵向平移时，才使用翻页 */
+	if( fbdev.var.yres_virtual >= fbdev.var.yres * 2 && fix.ypanstep > 0 &&
+	    fbdev.mem_len >= fbdev.line_length * fbdev.height * 2 ) {
+		fbdev.num_pages = 2;
+	}
+	return 0;
+}
+
+static int FBDisplay_Open( const char *device, int width, int height, int bpp )
+{
+	int i, ret;
+	LCUI_Rect rect;
+
+	fbdev.fd = open( device, O_RDWR );
+	if( fbdev.fd < 0 ) {
+		LOG( "[fbdisplay] cannot open device: %s\n", device );
+		return -errno;
+	}
+	ret = FBDisplay_GetInfo( width, height, bpp );
+	if( ret < 0 ) {
+		LOG( "[fbdisplay] cannot get screen info: %s\n", device );
+		close( fbdev.fd );
+		return ret;
+	}
+	/* 16 位色只支持 RGB565，RGB555 等格式暂不支持 */
+	switch( fbdev.bpp ) {
+	case 16:
+		fbdev.color_type = COLOR_TYPE_RGB565;
+		if( fbdev.var.green.length != 6 ) {
+			fbdev.color_type = -1;
+		}
+		break;
+	case 24: fbdev.color_type = COLOR_TYPE_RGB888; break;
+	case 32: fbdev.color_type = COLOR_TYPE_ARGB8888; break;
+	default: fbdev.color_type = -1; break;
+	}
+	if( fbdev.color_type < 0 ) {
+		LOG( "[fbdisplay] unsupported pixel format, bpp: %d\n",
+		     fbdev.bpp );
+		close( fbdev.fd );
+		return -EINVAL;
+	}
+	fbdev.mem = mmap( NULL, fbdev.mem_len, PROT_READ | PROT_WRITE,
+			  MAP_SHARED, fbdev.fd, 0 );
+	if( fbdev.mem == MAP_FAILED ) {
+		LOG( "[fbdisplay] cannot map framebuffer memory\n" );
+		fbdev.mem = NULL;
+		close( fbdev.fd );
+		return -ENOMEM;
+	}
+	fbdev.page = 0;
+	fbdev.page_size = fbdev.line_length * fbdev.height;
+	if( fbdev.num_pages > 1 ) {
+		fbdev.var.xoffset = 0;
+		fbdev.var.yoffset = 0;
+		if( ioctl( fbdev.fd, FBIOPAN_DISPLAY, &fbdev.var ) < 0 ) {
+			fbdev.num_pages = 1;
+		}
+	}
+	for( i = 0; i < MAX_PAGES; ++i ) {
+		Region_Init( &fbdev.dirty[i] );
+	}
+	rect.x = rect.y = 0;
+	rect.width = fbdev.width;
+	rect.height = fbdev.height;
+	FBDisplay_InvalidateArea( &rect );
+	LOG( "[fbdisplay] %s: %dx%d, %d bpp, %d page(s)\n", device,
+	     fbdev.width, fbdev.height, fbdev.bpp, fbdev.num_pages );
+	return 0;
+}
+
+LCUI_DisplayDriver LCUI_OpenLinuxFBDisplayDriver( const char *device,
+						  int width, int height,
+						  int bpp )
+{
+	LCUI_DisplayDriver driver;
+	if( fbdev.is_inited ) {
+		return NULL;
+	}
+	LCUIMutex_Init( &fbdev.mutex );
+	if( FBDisplay_Open( device, width, height, bpp ) != 0 ) {
+		LCUIMutex_Destroy( &fbdev.mutex );
+		return NULL;
+	}
+	driver = NEW( LCUI_DisplayDriverRec, 1 );
+	if( !driver ) {
+		munmap( fbdev.mem, fbdev.mem_len );
+		close( fbdev.fd );
+		LCUIMutex_Destroy( &fbdev.mutex );
+		return NULL;
+	}
+	strcpy( driver->name, "fbdev" );
+	driver->can_present_async = TRUE;
+	driver->getWidth = FBDisplay_GetWidth;
+	driver->getHeight = FBDisplay_GetHeight;
+	driver->create = FBSurface_New;
+	driver->destroy = FBSurface_Delete;
+	driver->close = FBSurface_Close;
+	driver->isReady = FBSurface_IsReady;
+	driver->show = FBSurface_Show;
+	driver->hide = FBSurface_Hide;
+	driver->move = FBSurface_Move;
+	driver->resize = FBSurface_Resize;
+	driver->update = FBSurface_Update;
+	driver->present = FBSurface_Present;
+	driver->setCaptionW = FBSurface_SetCaptionW;
+	driver->setRenderMode = FBSurface_SetRenderMode;
+	driver->setOpacity = FBSurface_SetOpacity;
+	driver->getHandle = FBSurface_GetHandle;
+	driver->beginPaint = FBSurface_BeginPaint;
+	driver->endPaint = FBSurface_EndPaint;
+	driver->bindEvent = FBDisplay_BindEvent;
+	LinkedList_Init( &fbdev.surfaces );
+	fbdev.trigger = EventTrigger();
+	fbdev.is_inited = TRUE;
+	return driver;
+}
+
+LCUI_DisplayDriver LCUI_CreateLinuxFBDisplayDriver( void )
+{
+	const char *device, *mode;
+	int width = DEFAULT_WIDTH, height = DEFAULT_HEIGHT, bpp = DEFAULT_BPP;
+
+	device = getenv( "LCUI_FBDEV" );
+	if( !device ) {
+		device = DEFAULT_DEVICE;
+	}
+	mode = getenv( "LCUI_FBDEV_MODE" );
+	if( mode && sscanf( mode, "%dx%dx%d", &width, &height, &bpp ) != 3 ) {
+		LOG( "[fbdisplay] invalid mode: %s\n", mode );
+		return NULL;
+	}
+	return LCUI_OpenLinuxFBDisplayDriver( device, width, height, bpp );
+}
+
+void LCUI_DestroyLinuxFBDisplayDriver( LCUI_DisplayDriver driver )
+{
+	int i;
+	if( !fbdev.is_inited ) {
+		return;
+	}
+	/* 切回第一页，以免其它程序使用帧缓存时显示的是第二页 */
+	if( fbdev.num_pages > 1 && fbdev.page != 0 ) {
+		fbdev.var.yoffset = 0;
+		ioctl( fbdev.fd, FBIOPAN_DISPLAY, &fbdev.var );
+	}
+	munmap( fbdev.mem, fbdev.mem_len );
+	close( fbdev.fd );
+	for( i = 0; i < MAX_PAGES; ++i ) {
+		Region_Destroy( &fbdev.dirty[i] );
+	}
+	EventTrigger_Destroy( fbdev.trigger );
+	LCUIMutex_Destroy( &fbdev.mutex );
+	fbdev.mem = NULL;
+	fbdev.is_inited = FALSE;
+	free( driver );
+}
+
+#endif
@@ -49,6 +49,11 @@
 #include <LCUI/font/charset.h>
 #include LCUI_DISPLAY_H
 #include LCUI_EVENTS_H
+#ifdef LCUI_VIDEO_DRIVER_X11_SHM
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <X11/extensions/XShm.h>
+#endif
 
 #define MIN_WIDTH	320
 #define MIN_HEIGHT	240
@@ -97,8 +102,13 @@ typedef struct LCUI_SurfaceRec_ {
 	LCUI_Mutex mutex;		/**< 互斥锁 */
 	int64_t timestamp;		/**< 时间戳，记录上次清空 ignored_size 时的时间 */
 	LinkedList ignored_size;	/**< 列表，记录被忽略的尺寸，用于屏蔽重复的窗口尺寸更改操作 */
-	LinkedList rects;		/**< 列表，记录当前需要重绘的区域 */
+	LCUI_RegionRec rects;		/**< 记录当前需要重绘的区域 */
 	LinkedListNode node;		/**< 在表面列表中的结点 */
+#ifdef LCUI_VIDEO_DRIVER_X11_SHM
+	LCUI_BOOL use_shm;		/**< 帧缓存是否位于共享内存中 */
+	XShmSegmentInfo shminfo;	/**< 共享内存段的信息 */
+	int shm_pending;		/**< 尚未完成的 XShmPutImage() 操作数量 */
+#endif
 } LCUI_SurfaceRec;
 
 static struct X11_Display {
@@ -106,6 +116,11 @@ static struct X11_Display {
 	LinkedList surfaces;		/**< 表面列表 */
 	LCUI_X11AppDriver app;		/**< X11 应用驱动 */
 	LCUI_EventTrigger trigger;	/**< 事件触发器 */
+#ifdef LCUI_VIDEO_DRIVER_X11_SHM
+	LCUI_BOOL shm_available;	/**< 是否可以使用 MIT-SHM 扩展 */
+	int shm_completion;		/**< ShmCompletion 事件的类型 */
+	LCUI_BOOL shm_error;		/**< 标志，标识共享内存段是否关联失败 */
+#endif
 } x11 = {0};
 
 /** 添加需要忽略的尺寸 */
@@ -160,6 +175,128 @@ static LCUI_Surface GetSurfaceByWindow( Window win )
 	return NULL;
 }
 
+#ifdef LCUI_VIDEO_DRIVER_X11_SHM
+
+static Bool IsShmCompletionEvent( Display *dpy, XEvent *ev, XPointer arg )
+{
+	LCUI_Surface s = (LCUI_Surface)arg;
+	XShmCompletionEvent *sev = (XShmCompletionEvent*)ev;
+	return ev->type == x11.shm_completion &&
+		sev->shmseg == s->shminfo.shmseg;
+}
+
+/**
+ * 等待 X 服务器读完共享内存中的帧缓存
+ * 只能在主线程中调用，因为只有主线程会读取 X 连接中的事件。呈现任务提交后
+ * 不会等待，而是在下次修改帧缓存之前才等待，通常这时候事件循环已经处理完
+ * ShmCompletion 事件，无需再等待。
+ */
+static void X11Surface_WaitShmCompletion( LCUI_Surface s )
+{
+	XEvent ev;
+	while( s->shm_pending > 0 ) {
+		XIfEvent( x11.app->display, &ev, IsShmCompletionEvent,
+			  (XPointer)s );
+		--s->shm_pending;
+	}
+}
+
+/** 响应 ShmCompletion 事件，X 服务器已经读完一次 XShmPutImage() 提交的区域 */
+static void OnShmCompletion( LCUI_Event e, void *arg )
+{
+	LinkedListNode *node;
+	XShmCompletionEvent *ev = arg;
+	LinkedList_ForEach( node, &x11.surfaces ) {
+		LCUI_Surface s = node->data;
+		if( s->use_shm && s->shminfo.shmseg == ev->shmseg ) {
+			if( s->shm_pending > 0 ) {
+				--s->shm_pending;
+			}
+			break;
+		}
+	}
+}
+
+static int OnShmAttachError( Display *dpy, XErrorEvent *ev )
+{
+	x11.shm_error = TRUE;
+	return 0;
+}
+
+static void X11Surface_DestroyShmImage( LCUI_Surface s )
+{
+	X11Surface_WaitShmCompletion( s );
+	XShmDetach( x11.app->display, &s->shminfo );
+	XSync( x11.app->display, False );
+	shmdt( s->shminfo.shmaddr );
+	/* 像素数据由共享内存段持有，不能让 XDestroyImage() 释放它 */
+	s->ximage->data = NULL;
+	XDestroyImage( s->ximage );
+	s->ximage = NULL;
+	s->use_shm = FALSE;
+	Graph_Init( &s->fb );
+}
+
+/** 在共享内存中创建帧缓存，X 服务器可以直接读取其中的像素数据 */
+static int X11Surface_CreateShmImage( LCUI_Surface s, Visual *visual,
+				      int depth, int width, int height )
+{
+	XErrorHandler handler;
+	Display *dpy = x11.app->display;
+
+	s->ximage = XShmCreateImage( dpy, visual, depth, ZPixmap, NULL,
+				     &s->shminfo, width, height );
+	if( !s->ximage ) {
+		return -1;
+	}
+	s->shminfo.shmid = shmget( IPC_PRIVATE, s->ximage->bytes_per_line *
+				   height, IPC_CREAT | 0600 );
+	if( s->shminfo.shmid < 0 ) {
+		XDestroyImage( s->ximage );
+		s->ximage = NULL;
+		return -2;
+	}
+	s->shminfo.shmaddr = shmat( s->shminfo.shmid, NULL, 0 );
+	s->shminfo.readOnly = False;
+	if( s->shminfo.shmaddr == (char*)-1 ) {
+		shmctl( s->shminfo.shmid, IPC_RMID, NULL );
+		XDestroyImage( s->ximage );
+		s->ximage = NULL;
+		return -3;
+	}
+	s->ximage->data = s->shminfo.shmaddr;
+	/* 连接的是远程的 X 服务器时关联会失败，需要捕获这个错误 */
+	x11.shm_error = FALSE;
+	XSync( dpy, False );
+	handler = XSetErrorHandler( OnShmAttachError );
+	XShmAttach( dpy, &s->shminfo );
+	XSync( dpy, False );
+	XSetErrorHandler( handler );
+	/* 双方都关联后即可标记删除，共享内存段会在最后一次解除关联时释放 */
+	shmctl( s->shminfo.shmid, IPC_RMID, NULL );
+	if( x11.shm_error ) {
+		shmdt( s->shminfo.shmaddr );
+		s->ximage->data = NULL;
+		XDestroyImage( s->ximage );
+		s->ximage = NULL;
+		x11.shm_available = FALSE;
+		LOG( "[x11display] cannot attach shared memory, "
+		     "MIT-SHM disabled\n" );
+		return -4;
+	}
+	s->use_shm = TRUE;
+	s->shm_pending = 0;
+	s->fb.width = width;
+	s->fb.height = height;
+	s->fb.bytes = (uchar_t*)s->shminfo.shmaddr;
+	s->fb.bytes_per_pixel = 4;
+	s->fb.bytes_per_row = s->ximage->bytes_per_line;
+	s->fb.mem_size = s->fb.bytes_per_row * height;
+	return 0;
+}
+
+#endif
+
 static void X11Surface_OnResize( LCUI_Surface s, int width, int height )
 {
 	int depth;
@@ -168,6 +305,11 @@ static void X11Surface_OnResize( LCUI_Surface s, int width, int height )
 	if( width == s->width && height == s->height ) {
 		return;
 	}
+#ifdef LCUI_VIDEO_DRIVER_X11_SHM
+	if( s->use_shm ) {
+		X11Surface_DestroyShmImage( s );
+	}
+#endif
 	if( s->ximage ) {
 		XDestroyImage( s->ximage );
 		s->ximage = NULL;
@@ -183,14 +325,20 @@ static void X11Surface_OnResize( LCUI_Surface s, int width, int height )
 	switch( depth ) {
 	case 32:
 	case 24:
-		s->fb.color_type = COLOR_TYPE_ARGB;
+		s->fb.color_type = COLOR_TYPE_PARGB;
 		break;
 	default: 
 		printf("[x11display] unsupport depth: %d.\n", depth);
 		break;
 	}
-	Graph_Create( &s->fb, width, height );
 	visual = DefaultVisual( x11.app->display, x11.app->screen );
+#ifdef LCUI_VIDEO_DRIVER_X11_SHM
+	if( x11.shm_available && X11Surface_CreateShmImage( s, visual, depth,
+							    width, height ) == 0 ) {
+		goto create_gc;
+	}
+#endif
+	Graph_Create( &s->fb, width, height );
     	s->ximage = XCreateImage( x11.app->display, visual, depth, ZPixmap, 
     				  0, (char *)(s->fb.bytes),
                       		  width, height, 32, 0 );
@@ -199,6 +347,9 @@ static void X11Surface_OnResize( LCUI_Surface s, int width, int height )
 		printf("[x11display] create XImage faild.\n");
 		return;
 	}
+#ifdef LCUI_VIDEO_DRIVER_X11_SHM
+create_gc:
+#endif
     	gcv.graphics_exposures = False;
 	s->gc = XCreateGC( x11.app->display, s->window, 
 			   GCGraphicsExposures, &gcv );
@@ -216,7 +367,7 @@ static void X11Surface_OnCreate( LCUI_Surface s )
 					 0, 100, MIN_WIDTH, MIN_HEIGHT, 1, 
 					 bdcolor, bgcolor );
 	LCUIMutex_Init( &s->mutex );
-	LinkedList_Init( &s->rects );
+	Region_Init( &s->rects );
 	LinkedList_Init( &s->ignored_size );
 	LCUI_SetLinuxX11MainWindow( s->window );
 }
@@ -263,16 +414,35 @@ static void X11Surface_OnTask( LCUI_Surface surface, LCUI_SurfaceTask task )
         	break;
         }
         case TASK_PRESENT: {
-		LinkedListNode *node;
+		int i;
 		LCUIMutex_Lock( &surface->mutex );
-		LinkedList_ForEach( node, &surface->rects ) {
-			LCUI_Rect *rect = node->data;
+#ifdef LCUI_VIDEO_DRIVER_X11_SHM
+		/* 只需告诉服务器要读取的区域，像素数据无需经过套接字传输，
+		 * 服务器读完后会发送 ShmCompletion 事件，在这之前不能修改帧
+		 * 缓存，由 X11Surface_BeginPaint() 负责等待 */
+		if( surface->use_shm ) {
+			for( i = 0; i < surface->rects.length; ++i ) {
+				LCUI_Rect *rect = &surface->rects.rects[i];
+				XShmPutImage( dpy, win, surface->gc,
+					      surface->ximage, rect->x, rect->y,
+					      rect->x, rect->y, rect->width,
+					      rect->height, True );
+				++surface->shm_pending;
+			}
+			XFlush( dpy );
+			Region_Clear( &surface->rects );
+			LCUIMutex_Unlock( &surface->mutex );
+			break;
+		}
+#endif
+		for( i = 0; i < surface->rects.length; ++i ) {
+			LCUI_Rect *rect = &surface->rects.rects[i];
 			XPutImage( x11.app->display, surface->window, 
 				   surface->gc, surface->ximage, 
 				   rect->x, rect->y, rect->x, rect->y, 
 				   rect->width, rect->height );
 		}
-		LinkedList_Clear( &surface->rects, free );
+		Region_Clear( &surface->rects );
 		LCUIMutex_Unlock( &surface->mutex );
 		break;
         }
@@ -319,7 +489,7 @@ static LCUI_Surface X11Surface_New( void )
 	surface->config.x = 0;
 	surface->config.y = 0;
 	Graph_Init( &surface->fb );
-	surface->fb.color_type = COLOR_TYPE_ARGB;
+	surface->fb.color_type = COLOR_TYPE_PARGB;
 	LinkedList_AppendNode( &x11.surfaces, &surface->node );
 	X11Surface_SendTask( surface, &task );
 	return surface;
@@ -405,21 +575,29 @@ static LCUI_PaintContext X11Surface_BeginPaint( LCUI_Surface surface,
 	paint = malloc(sizeof(LCUI_PaintContextRec));
 	paint->rect = *rect;
 	paint->with_alpha = FALSE;
+	paint->arena = NULL;
+	paint->region = NULL;
 	Graph_Init( &paint->canvas );
 	LCUIMutex_Lock( &surface->mutex );
+#ifdef LCUI_VIDEO_DRIVER_X11_SHM
+	/* 该驱动不支持流水线模式，绘制总是在主线程中进行，可以在这里等待 */
+	if( surface->use_shm ) {
+		X11Surface_WaitShmCompletion( surface );
+	}
+#endif
 	LCUIRect_ValidateArea( &paint->rect, surface->width, surface->height );
 	Graph_Quote( &paint->canvas, &surface->fb, &paint->rect );
-	Graph_FillRect( &paint->canvas, RGB( 255, 255, 255 ), NULL, TRUE );
 	return paint;
 }
 
 static void X11Surface_EndPaint( LCUI_Surface surface, 
 				LCUI_PaintContext paint )
 {
-	LCUI_Rect *r;
-	r = NEW( LCUI_Rect, 1 );
-	*r = paint->rect;
-	LinkedList_Append( &surface->rects, r );
+	if( paint->region ) {
+		Region_Union( &surface->rects, &surface->rects, paint->region );
+	} else {
+		Region_UnionRect( &surface->rects, &paint->rect );
+	}
 	free( paint );
 	LCUIMutex_Unlock( &surface->mutex );
 }
@@ -446,9 +624,10 @@ static int WinDisplay_BindEvent( int event_id, LCUI_EventFunc func,
 				  data, destroy_data );
 }
 
+/** 获取 surface 对应的 X11 窗口 */
 static void* X11Surface_GetHandle( LCUI_Surface s )
 {
-	return NULL;
+	return (void*)s->window;
 }
 
 static int X11Display_GetWidth( void )
@@ -510,9 +689,15 @@ static void OnConfigureNotify( LCUI_Event e, void *arg )
 }
 
 LCUI_DisplayDriver LCUI_CreateLinuxX11DisplayDriver( void )
+{
+	return LCUI_OpenLinuxX11DisplayDriver( TRUE );
+}
+
+LCUI_DisplayDriver LCUI_OpenLinuxX11DisplayDriver( LCUI_BOOL use_shm )
 {
 	ASSIGN( driver, LCUI_DisplayDriver );
 	strcpy( driver->name, "x11" );
+	driver->can_present_async = FALSE;
 	x11.app = LCUI_GetAppData();
 	if( !x11.app ) {
 		return NULL;
@@ -535,9 +720,23 @@ LCUI_DisplayDriver LCUI_CreateLinuxX11DisplayDriver( void )
 	driver->beginPaint = X11Surface_BeginPaint;
 	driver->endPaint = X11Surface_EndPaint;
 	driver->bindEvent = WinDisplay_BindEvent;
+#ifdef LCUI_VIDEO_DRIVER_X11_SHM
+	x11.shm_available = use_shm && XShmQueryExtension( x11.app->display );
+#endif
+	if( x11.is_inited ) {
+		return driver;
+	}
 	LinkedList_Init( &x11.surfaces );
 	LCUI_BindSysEvent( Expose, OnExpose, NULL, NULL );
 	LCUI_BindSysEvent( ConfigureNotify, OnConfigureNotify, NULL, NULL );
+#ifdef LCUI_VIDEO_DRIVER_X11_SHM
+	if( XShmQueryExtension( x11.app->display ) ) {
+		x11.shm_completion = XShmGetEventBase( x11.app->display ) +
+				     ShmCompletion;
+		LCUI_BindSysEvent( x11.shm_completion, OnShmCompletion,
+				   NULL, NULL );
+	}
+#endif
 	x11.trigger = EventTrigger();
 	x11.is_inited = TRUE;
 	return driver;
@@ -545,7 +744,7 @@ LCUI_DisplayDriver LCUI_CreateLinuxX11DisplayDriver( void )
 
 void LCUI_DestroyLinuxX11DisplayDriver( LCUI_DisplayDriver driver )
 {
-	
+	free( driver );
 }
 
 #endif
@@ -56,45 +56,27 @@ void LCUI_SetLinuxX11MainWindow( Window win )
                       KeyReleaseMask | EnterWindowMask | LeaveWindowMask |
                       PointerMotionMask | Button1MotionMask | 
                       VisibilityChangeMask );
-	LCUI_SetTaskAgent( FALSE );
-}
-
-static LCUI_BOOL X11_PostTask( LCUI_AppTask task )
-{
-	XEvent ev;
-	memset( &ev, 0, sizeof (ev) );
-	ev.xclient.type = ClientMessage;
-	ev.xclient.window = x11.win_main;
-	ev.xclient.format = 32;
-	ev.xclient.message_type = x11.wm_lcui;
-	XSendEvent( x11.display, x11.win_main, FALSE, NoEventMask, &ev );
-	return TRUE;
 }
 
+/**
+ * 阻塞等待，直到有 X 事件、任务或定时器到来为止
+ * X 连接已加入 Linux 事件循环的监听列表，任务和定时器也由它负责唤醒。显示驱动
+ * 的各项操作都以任务的形式交给主线程执行，因此其它线程不会调用 Xlib 的函数。
+ * 主线程在等待 ShmCompletion 事件时可能已经把其它事件读入了 Xlib 的队列，所以
+ * 要先检查队列，再等待连接上的新数据。
+ */
 static LCUI_BOOL X11_WaitEvent( void )
 {
-	int fd;
-	fd_set fdset;
-	struct timeval tv;
-	XFlush( x11.display );
-	fd = ConnectionNumber( x11.display );
-	if( XEventsQueued(x11.display, QueuedAlready) ) {
+	if( XEventsQueued( x11.display, QueuedAfterFlush ) ) {
 		return TRUE;
 	}
-	FD_ZERO( &fdset );
-	FD_SET( fd, &fdset );
-	tv.tv_sec = 0;
-	tv.tv_usec = 10000;
-	if( select(fd + 1, &fdset, NULL, NULL, &tv) == 1 ) {
-	    return XPending( x11.display );
-	}
-	return FALSE;
+	return LCUI_WaitLinuxEvent();
 }
 
 static LCUI_BOOL X11_DispatchEvent( void )
 {
 	XEvent xevent;
-	if( !XEventsQueued(x11.display, QueuedAlready) ) {
+	if( !XEventsQueued( x11.display, QueuedAfterFlush ) ) {
 		return FALSE;
 	}
 	XNextEvent( x11.display, &xevent );
@@ -110,6 +92,7 @@ static LCUI_BOOL X11_DispatchEvent( void )
 static void X11_ProcessEvents( void )
 {
 	int i;
+	LCUI_ProcessLinuxEvents();
 	for( i = 0; X11_DispatchEvent() && i < 10000; ++i );
 }
 
@@ -146,6 +129,11 @@ LCUI_AppDriver LCUI_CreateLinuxX11AppDriver( void )
 	if( !x11.display ) {
 		return NULL;
 	}
+	if( LCUI_WatchLinuxFd( ConnectionNumber( x11.display ),
+			       NULL, NULL ) != 0 ) {
+		XCloseDisplay( x11.display );
+		return NULL;
+	}
 	x11.screen = DefaultScreen( x11.display );
 	x11.win_root = RootWindow( x11.display, x11.screen );
 	x11.cmap = DefaultColormap( x11.display, x11.screen );
@@ -153,7 +141,8 @@ LCUI_AppDriver LCUI_CreateLinuxX11AppDriver( void )
 	XSetWMProtocols( x11.display, x11.win_root, &x11.wm_lcui, 1 );
 	app->WaitEvent = X11_WaitEvent;
 	app->ProcessEvents = X11_ProcessEvents;
-	app->PostTask = X11_PostTask;
+	app->PostTask = NULL;
+	app->Wakeup = LCUI_WakeupLinuxApp;
 	app->BindSysEvent = X11_BindSysEvent;
 	app->UnbindSysEvent = X11_UnbindSysEvent;
 	app->UnbindSysEvent2 = X11_UnbindSysEvent2;
@@ -164,6 +153,6 @@ LCUI_AppDriver LCUI_CreateLinuxX11AppDriver( void )
 
 void LCUI_DestroyLinuxX11AppDriver( LCUI_AppDriver app )
 {
-
+	LCUI_UnwatchLinuxFd( ConnectionNumber( x11.display ) );
 }
 #endif
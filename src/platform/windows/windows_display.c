@@ -186,7 +186,7 @@ static LCUI_Surface WinSurface_New( void )
 	surface->is_ready = FALSE;
 	surface->node.data = surface;
 	Graph_Init( &surface->fb );
-	surface->fb.color_type = COLOR_TYPE_ARGB;
+	surface->fb.color_type = COLOR_TYPE_PARGB;
 	for( i = 0; i < TASK_TOTAL_NUM; ++i ) {
 		surface->tasks[i].is_valid = FALSE;
 	}
@@ -326,10 +326,11 @@ static LCUI_PaintContext WinSurface_BeginPaint( LCUI_Surface surface, LCUI_Rect
 	paint = malloc(sizeof(LCUI_PaintContextRec));
 	paint->rect = *rect;
 	paint->with_alpha = FALSE;
+	paint->arena = NULL;
+	paint->region = NULL;
 	Graph_Init( &paint->canvas );
 	LCUIRect_ValidateArea( &paint->rect, surface->width, surface->height );
 	Graph_Quote( &paint->canvas, &surface->fb, &paint->rect );
-	Graph_FillRect( &paint->canvas, RGB( 255, 255, 255 ), NULL, TRUE );
 	return paint;
 }
 
@@ -510,6 +511,7 @@ LCUI_DisplayDriver LCUI_CreateWinDisplay( void )
 {
 	ASSIGN( driver, LCUI_DisplayDriver );
 	strcpy( driver->name, "windows" );
+	driver->can_present_async = FALSE;
 	driver->getWidth = WinDisplay_GetWidth;
 	driver->getHeight = WinDisplay_GetHeight;
 	driver->create = WinSurface_New;
@@ -175,6 +175,7 @@ LCUI_AppDriver LCUI_CreateWinAppDriver( void )
 	}
 	app->GetData = WIN_GetData;
 	app->PostTask = WIN_PostTask;
+	app->Wakeup = NULL;
 	app->WaitEvent = WIN_WaitEvent;
 	app->ProcessEvents = WIN_ProcessEvents;
 	app->BindSysEvent = WIN_BindSysEvent;
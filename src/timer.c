@@ -40,10 +40,12 @@
 //#define DEBUG
 #include <stdio.h>
 #include <stdlib.h>
+#include <errno.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
 #include <LCUI/thread.h>
 #include <LCUI/timer.h>
+#include <LCUI/trace.h>
 
 #define STATE_RUN	1
 #define STATE_PAUSE	0
@@ -54,19 +56,37 @@ typedef struct TimerRec_ {
 	int state;			/**< 状态 */
 	LCUI_BOOL reuse;		/**< 是否重复使用该定时器 */
 	long int id;			/**< 定时器ID */
-	int64_t start_time;		/**< 定时器启动时的时间 */
-	int64_t pause_time;		/**< 定时器暂停时的时间 */
+	int64_t due_time;		/**< 到期时间 */
 	long int total_ms;		/**< 定时时间（单位：毫秒） */
-	long int pause_ms;		/**< 定时器处于暂停状态的时长（单位：毫秒） */
+	long int remain_ms;		/**< 暂停时剩余的定时时间（单位：毫秒） */
+	int index;			/**< 在定时器堆中的位置，不在堆中时为 -1 */
 	void (*func)(void*);		/**< 回调函数 */
 	void *arg;			/**< 函数的参数 */
-	LinkedListNode node;		/**< 位于定时器列表中的节点 */
 } TimerRec, *Timer;
 
+/** 同一时刻到期的定时器的回调记录 */
+typedef struct TimerCallRec_ {
+	long int id;
+	void (*func)(void*);
+	void *arg;
+} TimerCallRec, *TimerCall;
+
+/** 定时器批量任务，同一时刻到期的定时器合并为一个任务处理 */
+typedef struct TimerBatchRec_ {
+	size_t length;
+	TimerCall calls;
+} TimerBatchRec, *TimerBatch;
+
 static struct TimerModule {
 	int id_count;			/**< 定时器ID计数 */
-	LinkedList timer_list;		/**< 定时器数据记录 */
-	LCUI_BOOL is_running;		/**< 定时器线程是否正在运行 */
+	RBTree timers;			/**< 以 ID 为索引的定时器记录 */
+	struct {
+		Timer *timers;		/**< 按到期时间排列的最小堆 */
+		size_t length;		/**< 堆中的定时器数量 */
+		size_t max;		/**< 已分配的空间能容纳的定时器数量 */
+	} heap;				/**< 正在计时的定时器 */
+	LCUI_BOOL is_running;		/**< 定时器模块是否正在运行 */
+	LCUI_BOOL main_loop_mode;	/**< 是否由主循环处理定时器 */
 	LCUI_Cond sleep_cond;		/**< 用于控制定时器睡眠的条件变量 */
 	LCUI_Mutex mutex;		/**< 定时器记录操作互斥锁 */
 	LCUI_Thread tid;		/**< 定时器处理线程ID */
@@ -74,112 +94,255 @@ static struct TimerModule {
 
 /*----------------------------- Private ------------------------------*/
 
-/** 更新定时器在定时器列表中的位置 */
-static void TimerList_AddNode( LinkedListNode *node )
+/** 判断定时器 a 是否应该比 b 先到期，同时到期的按创建顺序排列 */
+static LCUI_BOOL Timer_Before( Timer a, Timer b )
+{
+	if( a->due_time != b->due_time ) {
+		return a->due_time < b->due_time;
+	}
+	return a->id < b->id;
+}
+
+static void TimerHeap_Set( size_t i, Timer timer )
+{
+	self.heap.timers[i] = timer;
+	timer->index = (int)i;
+}
+
+static void TimerHeap_SiftUp( size_t i )
+{
+	size_t parent;
+	Timer timer = self.heap.timers[i];
+	while( i > 0 ) {
+		parent = (i - 1) / 2;
+		if( !Timer_Before( timer, self.heap.timers[parent] ) ) {
+			break;
+		}
+		TimerHeap_Set( i, self.heap.timers[parent] );
+		i = parent;
+	}
+	TimerHeap_Set( i, timer );
+}
+
+static void TimerHeap_SiftDown( size_t i )
+{
+	size_t child;
+	Timer timer = self.heap.timers[i];
+	while( (child = i * 2 + 1) < self.heap.length ) {
+		if( child + 1 < self.heap.length &&
+		    Timer_Before( self.heap.timers[child + 1],
+				  self.heap.timers[child] ) ) {
+			++child;
+		}
+		if( !Timer_Before( self.heap.timers[child], timer ) ) {
+			break;
+		}
+		TimerHeap_Set( i, self.heap.timers[child] );
+		i = child;
+	}
+	TimerHeap_Set( i, timer );
+}
+
+static int TimerHeap_Push( Timer timer )
 {
+	size_t max;
+	Timer *timers;
+	if( self.heap.length >= self.heap.max ) {
+		max = self.heap.max > 0 ? self.heap.max * 2 : 32;
+		timers = realloc( self.heap.timers, max * sizeof( Timer ) );
+		if( !timers ) {
+			return -ENOMEM;
+		}
+		self.heap.timers = timers;
+		self.heap.max = max;
+	}
+	TimerHeap_Set( self.heap.length, timer );
+	self.heap.length += 1;
+	TimerHeap_SiftUp( timer->index );
+	return 0;
+}
+
+static void TimerHeap_Remove( Timer timer )
+{
+	size_t i = timer->index;
+	Timer last;
+	if( timer->index < 0 ) {
+		return;
+	}
+	timer->index = -1;
+	self.heap.length -= 1;
+	if( i == self.heap.length ) {
+		return;
+	}
+	last = self.heap.timers[self.heap.length];
+	TimerHeap_Set( i, last );
+	if( i > 0 && Timer_Before( last, self.heap.timers[(i - 1) / 2] ) ) {
+		TimerHeap_SiftUp( i );
+	} else {
+		TimerHeap_SiftDown( i );
+	}
+}
+
+/** 在定时器的到期时间改变后更新它在堆中的位置 */
+static int TimerHeap_Update( Timer timer )
+{
+	if( timer->index < 0 ) {
+		return TimerHeap_Push( timer );
+	}
+	TimerHeap_SiftUp( timer->index );
+	TimerHeap_SiftDown( timer->index );
+	return 0;
+}
+
+static Timer TimerHeap_Top( void )
+{
+	if( self.heap.length > 0 ) {
+		return self.heap.timers[0];
+	}
+	return NULL;
+}
+
+/**
+ * 取出所有已到期的定时器
+ * 重复使用的定时器会重新开始计时，其它定时器在回调执行前仍保留 ID 记录，
+ * 以便在执行前检查它是否已被释放
+ */
+static TimerBatch TimerHeap_PopExpired( void )
+{
+	size_t max = 0;
+	int64_t now;
+	TimerCall calls;
 	Timer timer;
-	int64_t t, tt;
-	LinkedListNode *cur;
-	/* 计算该定时器的剩余定时时长 */
-	timer = node->data;
-	t = LCUI_GetTimeDelta( timer->start_time );
-	t = timer->total_ms - t + timer->pause_ms;
-	for( LinkedList_Each( cur, &self.timer_list ) ) {
-		timer = cur->data;
-		tt = LCUI_GetTimeDelta( timer->start_time );
-		tt = timer->total_ms - tt + timer->pause_ms;
-		if( t <= tt ) {
-			LinkedList_Link( &self.timer_list, cur->prev, node );
-			return;
+	TimerBatch batch;
+	now = LCUI_GetTime();
+	timer = TimerHeap_Top();
+	if( !timer || timer->due_time > now ) {
+		return NULL;
+	}
+	batch = malloc( sizeof( TimerBatchRec ) );
+	if( !batch ) {
+		return NULL;
+	}
+	batch->length = 0;
+	batch->calls = NULL;
+	while( (timer = TimerHeap_Top()) && timer->due_time <= now ) {
+		if( batch->length >= max ) {
+			max = max > 0 ? max * 2 : 4;
+			calls = realloc( batch->calls, max * sizeof( TimerCallRec ) );
+			if( !calls ) {
+				break;
+			}
+			batch->calls = calls;
+		}
+		calls = &batch->calls[batch->length++];
+		calls->id = timer->id;
+		calls->func = timer->func;
+		calls->arg = timer->arg;
+		if( timer->reuse ) {
+			/* 定时时间为 0 时也要推迟到下一毫秒，否则会一直到期 */
+			timer->due_time = now + (timer->total_ms > 0 ?
+						 timer->total_ms : 1);
+			TimerHeap_SiftDown( 0 );
+		} else {
+			TimerHeap_Remove( timer );
 		}
 	}
-	LinkedList_AppendNode( &self.timer_list, node );
+	return batch;
+}
+
+static void TimerBatch_Destroy( void *arg )
+{
+	TimerBatch batch = arg;
+	if( batch->calls ) {
+		free( batch->calls );
+	}
+	free( batch );
 }
 
-//#define DEBUG_TIMER
-#ifdef DEBUG_TIMER
-/** 打印列表中的定时器信息 */
-static void TimerList_Print( void )
+/** 执行批量任务中的回调函数，已被释放、暂停或重设的定时器会被跳过 */
+static size_t TimerBatch_Run( TimerBatch batch )
 {
-	int i = 0;
+	size_t i, count = 0;
 	Timer timer;
-	LinkedListNode *node;
-	_DEBUG_MSG("timer list(%d) start:\n", self.timer_list.length);
-	for( LinkedList_Each( node, &self.timer_list ) {
-		timer = node->data;
-		_DEBUG_MSG("[%02d] %ld, func: %p, cur_ms: %ldms, total_ms: %ldms\n",
-			i++, timer->id, timer->func, timer->total_ms - (long int)LCUI_GetTimeDelta(timer->start_time), timer->total_ms );
-	}
-	_DEBUG_MSG("timer list end\n\n");
+	TimerCall call;
+	for( i = 0; i < batch->length; ++i ) {
+		call = &batch->calls[i];
+		LCUIMutex_Lock( &self.mutex );
+		timer = RBTree_GetData( &self.timers, call->id );
+		if( !timer || timer->state != STATE_RUN ) {
+			LCUIMutex_Unlock( &self.mutex );
+			continue;
+		}
+		if( !timer->reuse ) {
+			if( timer->index >= 0 ) {
+				LCUIMutex_Unlock( &self.mutex );
+				continue;
+			}
+			RBTree_Erase( &self.timers, call->id );
+		}
+		/* 回调函数可能会操作定时器，需要先解锁 */
+		LCUIMutex_Unlock( &self.mutex );
+		LCUITrace_Begin( "timer", "timer" );
+		call->func( call->arg );
+		LCUITrace_End( "timer", "timer" );
+		++count;
+	}
+	return count;
 }
-#endif
 
+static void OnTimerBatchTask( void *arg1, void *arg2 )
+{
+	TimerBatch_Run( arg1 );
+}
 
 /** 定时器线程，用于处理列表中各个定时器 */
 static void TimerThread( void *arg )
 {
-	long int n_ms;
-	int64_t lost_ms;
-	LinkedListNode *node;
+	Timer timer;
+	int64_t n_ms;
 	LCUI_AppTaskRec task = {0};
 	LCUIMutex_Lock( &self.mutex );
 	LOG( "[timer] timer thread is working\n" );
-	while( self.is_running ) {
-		Timer timer = NULL;
-		for( LinkedList_Each( node, &self.timer_list ) ) {
-			timer = node->data;
-			if( timer && timer->state == STATE_RUN ) {
-				break;
-			}
-		}
-		/* 没有要处理的定时器，停留一段时间再进行下次循环 */
-		if( !node ) {
+	while( self.is_running && !self.main_loop_mode ) {
+		/* 虚拟时钟下的定时器由主循环调用 LCUITimer_Process() 处理 */
+		if( LCUITime_IsVirtualClock() ) {
 			LCUIMutex_Unlock( &self.mutex );
 			LCUI_MSleep( 10 );
 			LCUIMutex_Lock( &self.mutex );
 			continue;
 		}
-		lost_ms = LCUI_GetTimeDelta( timer->start_time );
-		/* 减去处于暂停状态的时长 */
-		lost_ms -= timer->pause_ms;
-		/* 若流失的时间未达到总定时时长，则睡眠一段时间 */
-		if( lost_ms < timer->total_ms ) {
-			n_ms = timer->total_ms - lost_ms;
+		timer = TimerHeap_Top();
+		/* 没有要处理的定时器，等到有新的定时器时再继续 */
+		if( !timer ) {
+			LCUICond_Wait( &self.sleep_cond, &self.mutex );
+			continue;
+		}
+		n_ms = timer->due_time - LCUI_GetTime();
+		if( n_ms > 0 ) {
 			LCUICond_TimedWait( &self.sleep_cond,
-					    &self.mutex, n_ms );
+					    &self.mutex, (unsigned int)n_ms );
 			continue;
 		}
-		/* 准备任务数据 */
-		task.func = (LCUI_AppTaskFunc)timer->func;
-		task.arg[0] = timer->arg;
-		/* 若需要重复使用，则重置剩余等待时间 */
-		LinkedList_Unlink( &self.timer_list, node );
-		if( timer->reuse ) {
-			timer->pause_ms = 0;
-			timer->start_time = LCUI_GetTime();
-			TimerList_AddNode( node );
-		} else {
-			free( timer );
+		/* 将同一时刻到期的定时器合并为一个任务 */
+		task.arg[0] = TimerHeap_PopExpired();
+		if( task.arg[0] ) {
+			task.func = OnTimerBatchTask;
+			task.destroy_arg[0] = TimerBatch_Destroy;
+			LCUI_PostTask( &task );
 		}
-		/* 添加该任务至指定程序的任务队列 */
-		LCUI_PostTask( &task );
 	}
 	LOG( "[timer] timer thread stopped working\n" );
 	LCUIMutex_Unlock( &self.mutex );
 }
 
-static Timer TimerList_Find( int timer_id )
+/** 在主循环模式下唤醒主循环，让它按新的到期时间等待 */
+static void LCUITimer_WakeupMainLoop( void )
 {
-	Timer timer;
-	LinkedListNode *node;
-	for( LinkedList_Each( node, &self.timer_list ) ) {
-		timer = node->data;
-		if( timer && timer->id == timer_id ) {
-			return timer;
-		}
+	if( self.main_loop_mode ) {
+		LCUI_Wakeup();
 	}
-	return NULL;
 }
+
 /*--------------------------- End Private ----------------------------*/
 
 /*----------------------------- Public -------------------------------*/
@@ -191,22 +354,29 @@ int LCUITimer_Set( long int n_ms, void (*func)(void*),
 	if( !self.is_running ) {
 		return -1;
 	}
-	LCUIMutex_Lock( &self.mutex );
-	timer = malloc( sizeof(TimerRec) );
+	timer = malloc( sizeof( TimerRec ) );
+	if( !timer ) {
+		return -ENOMEM;
+	}
 	timer->arg = arg;
 	timer->func = func;
 	timer->reuse = reuse;
-	timer->pause_ms = 0;
+	timer->index = -1;
+	timer->remain_ms = 0;
 	timer->total_ms = n_ms;
 	timer->state = STATE_RUN;
+	timer->due_time = LCUI_GetTime() + n_ms;
+	LCUIMutex_Lock( &self.mutex );
 	timer->id = ++self.id_count;
-	timer->start_time = LCUI_GetTime();
-	timer->node.next = NULL;
-	timer->node.prev = NULL;
-	timer->node.data = timer;
-	TimerList_AddNode( &timer->node );
+	if( TimerHeap_Push( timer ) != 0 ) {
+		LCUIMutex_Unlock( &self.mutex );
+		free( timer );
+		return -ENOMEM;
+	}
+	RBTree_Insert( &self.timers, timer->id, timer );
 	LCUICond_Signal( &self.sleep_cond );
 	LCUIMutex_Unlock( &self.mutex );
+	LCUITimer_WakeupMainLoop();
 	DEBUG_MSG("set timer, id: %ld, total_ms: %ld\n", timer->id, timer->total_ms);
 	return timer->id;
 }
@@ -218,13 +388,13 @@ int LCUITimer_Free( int timer_id )
 		return -1;
 	}
 	LCUIMutex_Lock( &self.mutex );
-	timer = TimerList_Find( timer_id );
+	timer = RBTree_GetData( &self.timers, timer_id );
 	if( !timer ) {
 		LCUIMutex_Unlock( &self.mutex );
 		return -1;
 	}
-	LinkedList_Unlink( &self.timer_list, &timer->node );
-	free( timer );
+	TimerHeap_Remove( timer );
+	RBTree_Erase( &self.timers, timer_id );
 	LCUICond_Signal( &self.sleep_cond );
 	LCUIMutex_Unlock( &self.mutex );
 	return 0;
@@ -233,15 +403,18 @@ int LCUITimer_Free( int timer_id )
 int LCUITimer_Pause( int timer_id )
 {
 	Timer timer;
+	int64_t n_ms;
 	if( !self.is_running ) {
 		return -1;
 	}
 	LCUIMutex_Lock( &self.mutex );
-	timer = TimerList_Find( timer_id );
-	if( timer ) {
-		/* 记录暂停时的时间 */
-		timer->pause_time = LCUI_GetTime();
+	timer = RBTree_GetData( &self.timers, timer_id );
+	if( timer && timer->state == STATE_RUN ) {
+		/* 记录剩余的定时时间 */
+		n_ms = timer->due_time - LCUI_GetTime();
+		timer->remain_ms = n_ms > 0 ? (long int)n_ms : 0;
 		timer->state = STATE_PAUSE;
+		TimerHeap_Remove( timer );
 	}
 	LCUICond_Signal( &self.sleep_cond );
 	LCUIMutex_Unlock( &self.mutex );
@@ -255,14 +428,15 @@ int LCUITimer_Continue( int timer_id )
 		return -1;
 	}
 	LCUIMutex_Lock( &self.mutex );
-	timer = TimerList_Find( timer_id );
-	if( timer ) {
-		/* 计算处于暂停状态的时长 */
-		timer->pause_ms += (long int)LCUI_GetTimeDelta( timer->pause_time );
+	timer = RBTree_GetData( &self.timers, timer_id );
+	if( timer && timer->state == STATE_PAUSE ) {
+		timer->due_time = LCUI_GetTime() + timer->remain_ms;
 		timer->state = STATE_RUN;
+		TimerHeap_Push( timer );
 	}
 	LCUICond_Signal( &self.sleep_cond );
 	LCUIMutex_Unlock( &self.mutex );
+	LCUITimer_WakeupMainLoop();
 	return timer ? 0:-1;
 }
 
@@ -273,26 +447,99 @@ int LCUITimer_Reset( int timer_id, long int n_ms )
 		return -1;
 	}
 	LCUIMutex_Lock( &self.mutex );
-	timer = TimerList_Find( timer_id );
+	timer = RBTree_GetData( &self.timers, timer_id );
 	if( timer ) {
-		timer->pause_ms = 0;
 		timer->total_ms = n_ms;
-		timer->start_time = LCUI_GetTime();
+		if( timer->state == STATE_RUN ) {
+			timer->due_time = LCUI_GetTime() + n_ms;
+			TimerHeap_Update( timer );
+		} else {
+			timer->remain_ms = n_ms;
+		}
 	}
 	LCUICond_Signal( &self.sleep_cond );
 	LCUIMutex_Unlock( &self.mutex );
+	LCUITimer_WakeupMainLoop();
 	return timer ? 0:-1;
 }
 
+size_t LCUITimer_Process( void )
+{
+	size_t count;
+	TimerBatch batch;
+	if( !self.is_running ) {
+		return 0;
+	}
+	/* 定时器线程在实际时钟下自行处理定时器 */
+	if( !self.main_loop_mode && !LCUITime_IsVirtualClock() ) {
+		return 0;
+	}
+	LCUIMutex_Lock( &self.mutex );
+	batch = TimerHeap_PopExpired();
+	LCUIMutex_Unlock( &self.mutex );
+	if( !batch ) {
+		return 0;
+	}
+	count = TimerBatch_Run( batch );
+	TimerBatch_Destroy( batch );
+	return count;
+}
+
+long int LCUITimer_GetTimeout( void )
+{
+	Timer timer;
+	int64_t n_ms;
+	long int timeout = -1;
+	if( !self.is_running ) {
+		return -1;
+	}
+	LCUIMutex_Lock( &self.mutex );
+	timer = TimerHeap_Top();
+	if( timer ) {
+		n_ms = timer->due_time - LCUI_GetTime();
+		timeout = n_ms > 0 ? (long int)n_ms : 0;
+	}
+	LCUIMutex_Unlock( &self.mutex );
+	return timeout;
+}
+
+void LCUITimer_SetMainLoopMode( LCUI_BOOL enabled )
+{
+	if( !self.is_running ) {
+		self.main_loop_mode = enabled;
+		return;
+	}
+	if( self.main_loop_mode == enabled ) {
+		return;
+	}
+	LCUIMutex_Lock( &self.mutex );
+	self.main_loop_mode = enabled;
+	LCUICond_Broadcast( &self.sleep_cond );
+	LCUIMutex_Unlock( &self.mutex );
+	if( enabled ) {
+		/* 定时器线程检测到模式变化后会自行退出 */
+		LCUIThread_Join( self.tid, NULL );
+		LOG( "[timer] timers are processed by the main loop\n" );
+	} else {
+		LCUIThread_Create( &self.tid, TimerThread, NULL );
+	}
+}
+
 void LCUI_InitTimer( void )
 {
 	LOG( "[timer] init ...\n" );
 	LCUITime_Init();
 	LCUIMutex_Init( &self.mutex );
 	LCUICond_Init( &self.sleep_cond );
-	LinkedList_Init( &self.timer_list );
-	LCUIThread_Create( &self.tid, TimerThread, NULL );
+	RBTree_Init( &self.timers );
+	RBTree_OnDestroy( &self.timers, free );
+	self.heap.timers = NULL;
+	self.heap.length = 0;
+	self.heap.max = 0;
+	/* 先标记为运行状态，否则线程可能在标记前就已经检查并退出 */
 	self.is_running = TRUE;
+	self.main_loop_mode = FALSE;
+	LCUIThread_Create( &self.tid, TimerThread, NULL );
 }
 
 void LCUI_ExitTimer( void )
@@ -301,8 +548,16 @@ void LCUI_ExitTimer( void )
 	LCUIMutex_Lock( &self.mutex );
 	LCUICond_Broadcast( &self.sleep_cond );
 	LCUIMutex_Unlock( &self.mutex );
-	LCUIThread_Join( self.tid, NULL );
-	LinkedList_ClearData( &self.timer_list, free );
+	if( !self.main_loop_mode ) {
+		LCUIThread_Join( self.tid, NULL );
+	}
+	RBTree_Destroy( &self.timers );
+	if( self.heap.timers ) {
+		free( self.heap.timers );
+	}
+	self.heap.timers = NULL;
+	self.heap.length = 0;
+	self.heap.max = 0;
 	LCUICond_Destroy( &self.sleep_cond );
 	LCUIMutex_Destroy( &self.mutex );
 }
@@ -0,0 +1,284 @@
+/* ***************************************************************************
+ * trace.c -- event tracing, exported in the Chrome trace event format.
+ *
+ * Copyright (C) 2017 by Liu Chao <lc-soft@live.cn>
+ *
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ *
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ *
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *
+ * The LCUI project is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ *
+ * You should have received a copy of the GPLv2 along with this file. It is
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+/* ****************************************************************************
+ * trace.c -- 事件跟踪，以 Chrome 跟踪事件格式导出
+ *
+ * 版权所有 (C) 2017 归属于 刘超 <lc-soft@live.cn>
+ *
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ *
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ *
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
+#include <LCUI/trace.h>
+#include <LCUI/util/atomic.h>
+
+#ifdef _MSC_VER
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+#define EVENT_NAME_LEN	32
+#define CHUNK_SIZE	4096
+/** 每个线程最多保留的缓冲块数量，超出后丢弃新的事件 */
+#define MAX_CHUNKS	256
+
+typedef struct TraceEventRec_ {
+	char phase;
+	const char *category;
+	char name[EVENT_NAME_LEN];
+	int64_t time;
+} TraceEventRec, *TraceEvent;
+
+/**
+ * 缓冲块
+ * 只有所属的线程会写入事件，写完事件后才更新 length，写满后才设置 next，所以
+ * 导出线程读到 next 不为空时，这个块已经不会再被改动，可以释放
+ */
+typedef struct TraceChunkRec_ {
+	TraceEventRec events[CHUNK_SIZE];
+	volatile long length;
+	struct TraceChunkRec_ *volatile next;
+} TraceChunkRec, *TraceChunk;
+
+typedef struct TraceBufferRec_ {
+	int tid;
+	TraceChunk head;		/**< 导出线程读取的块 */
+	long read_pos;			/**< head 中已读取的事件数量 */
+	TraceChunk tail;		/**< 所属线程写入的块 */
+	volatile long n_chunks;
+	unsigned long dropped;
+	struct TraceBufferRec_ *next;
+} TraceBufferRec, *TraceBuffer;
+
+static struct LCUI_TraceModule {
+	volatile long enabled;
+	int n_buffers;
+	TraceBuffer buffers;
+	LCUI_Mutex mutex;
+	LCUI_BOOL mutex_ready;
+} self;
+
+static THREAD_LOCAL TraceBuffer current_buffer;
+
+static TraceChunk TraceChunk_New( void )
+{
+	TraceChunk chunk = malloc( sizeof( TraceChunkRec ) );
+	if( !chunk ) {
+		return NULL;
+	}
+	chunk->length = 0;
+	chunk->next = NULL;
+	return chunk;
+}
+
+/** 获取当前线程的缓冲，第一次调用时创建并登记 */
+static TraceBuffer TraceBuffer_Get( void )
+{
+	TraceBuffer buf;
+	if( current_buffer ) {
+		return current_buffer;
+	}
+	buf = malloc( sizeof( TraceBufferRec ) );
+	if( !buf ) {
+		return NULL;
+	}
+	buf->head = TraceChunk_New();
+	if( !buf->head ) {
+		free( buf );
+		return NULL;
+	}
+	buf->tail = buf->head;
+	buf->read_pos = 0;
+	buf->n_chunks = 1;
+	buf->dropped = 0;
+	LCUIMutex_Lock( &self.mutex );
+	buf->tid = ++self.n_buffers;
+	buf->next = self.buffers;
+	self.buffers = buf;
+	LCUIMutex_Unlock( &self.mutex );
+	current_buffer = buf;
+	return buf;
+}
+
+static void TraceBuffer_Add( char phase, const char *category,
+			     const char *name )
+{
+	long length;
+	TraceEvent e;
+	TraceChunk chunk;
+	TraceBuffer buf = TraceBuffer_Get();
+	if( !buf ) {
+		return;
+	}
+	chunk = buf->tail;
+	length = chunk->length;
+	if( length >= CHUNK_SIZE ) {
+		if( LCUI_AtomicLoad( &buf->n_chunks ) >= MAX_CHUNKS ) {
+			buf->dropped += 1;
+			return;
+		}
+		chunk = TraceChunk_New();
+		if( !chunk ) {
+			buf->dropped += 1;
+			return;
+		}
+		LCUI_AtomicAdd( &buf->n_chunks, 1 );
+		LCUI_AtomicStorePtr( &buf->tail->next, chunk );
+		buf->tail = chunk;
+		length = 0;
+	}
+	e = &chunk->events[length];
+	e->phase = phase;
+	e->category = category;
+	strncpy( e->name, name, EVENT_NAME_LEN - 1 );
+	e->name[EVENT_NAME_LEN - 1] = 0;
+	e->time = LCUI_GetTimeUS();
+	LCUI_AtomicStore( &chunk->length, length + 1 );
+}
+
+static void LCUITrace_InitMutex( void )
+{
+	if( !self.mutex_ready ) {
+		LCUIMutex_Init( &self.mutex );
+		self.mutex_ready = TRUE;
+	}
+}
+
+void LCUITrace_Enable( LCUI_BOOL enabled )
+{
+	LCUITrace_InitMutex();
+	LCUI_AtomicStore( &self.enabled, enabled ? 1 : 0 );
+}
+
+LCUI_BOOL LCUITrace_IsEnabled( void )
+{
+	return self.enabled ? TRUE : FALSE;
+}
+
+void LCUITrace_Begin( const char *category, const char *name )
+{
+	if( self.enabled ) {
+		TraceBuffer_Add( 'B', category, name );
+	}
+}
+
+void LCUITrace_End( const char *category, const char *name )
+{
+	if( self.enabled ) {
+		TraceBuffer_Add( 'E', category, name );
+	}
+}
+
+/** 写入 JSON 字符串，转义其中的特殊字符 */
+static void WriteString( FILE *fp, const char *str )
+{
+	fputc( '"', fp );
+	for( ; *str; ++str ) {
+		if( *str == '"' || *str == '\\' ) {
+			fputc( '\\', fp );
+			fputc( *str, fp );
+		} else if( (unsigned char)*str < 0x20 ) {
+			fprintf( fp, "\\u%04x", *str );
+		} else {
+			fputc( *str, fp );
+		}
+	}
+	fputc( '"', fp );
+}
+
+/** 导出缓冲中还未导出的事件，并释放已读完的块 */
+static int TraceBuffer_Flush( TraceBuffer buf, FILE *fp, int count )
+{
+	long length;
+	TraceEvent e;
+	TraceChunk next;
+	while( 1 ) {
+		next = LCUI_AtomicLoad( &buf->head->next );
+		length = LCUI_AtomicLoad( &buf->head->length );
+		for( ; buf->read_pos < length; ++buf->read_pos ) {
+			e = &buf->head->events[buf->read_pos];
+			fputs( count > 0 ? ",\n" : "\n", fp );
+			fprintf( fp, "{\"ph\":\"%c\",\"cat\":", e->phase );
+			WriteString( fp, e->category );
+			fputs( ",\"name\":", fp );
+			WriteString( fp, e->name );
+			fprintf( fp, ",\"ts\":%lld,\"pid\":1,\"tid\":%d}",
+				 (long long)e->time, buf->tid );
+			++count;
+		}
+		if( !next ) {
+			break;
+		}
+		free( buf->head );
+		buf->head = next;
+		buf->read_pos = 0;
+		LCUI_AtomicAdd( &buf->n_chunks, -1 );
+	}
+	return count;
+}
+
+int LCUITrace_Flush( const char *filepath )
+{
+	FILE *fp;
+	int count = 0, n_threads = 0;
+	TraceBuffer buf;
+	LCUITrace_InitMutex();
+	fp = fopen( filepath, "w" );
+	if( !fp ) {
+		return -ENOENT;
+	}
+	fputs( "{\"traceEvents\":[", fp );
+	LCUIMutex_Lock( &self.mutex );
+	for( buf = self.buffers; buf; buf = buf->next ) {
+		fputs( count > 0 ? ",\n" : "\n", fp );
+		fprintf( fp, "{\"ph\":\"M\",\"name\":\"thread_name\","
+			 "\"pid\":1,\"tid\":%d,\"args\":{\"name\":"
+			 "\"thread %d\",\"dropped\":%lu}}",
+			 buf->tid, buf->tid, buf->dropped );
+		++count;
+		++n_threads;
+	}
+	for( buf = self.buffers; buf; buf = buf->next ) {
+		count = TraceBuffer_Flush( buf, fp, count );
+	}
+	LCUIMutex_Unlock( &self.mutex );
+	fputs( "\n],\"displayTimeUnit\":\"ms\"}\n", fp );
+	fclose( fp );
+	return count - n_threads;
+}
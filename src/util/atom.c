@@ -0,0 +1,130 @@
+/* ***************************************************************************
+ * atom.c -- interned strings, each name is stored once and identified by an integer.
+ *
+ * Copyright (C) 2017 by Liu Chao <lc-soft@live.cn>
+ *
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ *
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ *
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *
+ * The LCUI project is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ *
+ * You should have received a copy of the GPLv2 along with this file. It is
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+/* ****************************************************************************
+ * atom.c -- 字符串驻留，每个名称只保存一份，用整数标识
+ *
+ * 版权所有 (C) 2017 归属于 刘超 <lc-soft@live.cn>
+ *
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ *
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ *
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
+#include <LCUI/util/atom.h>
+
+static struct LCUI_AtomTable {
+	LCUI_BOOL is_inited;
+	Dict *atoms;		/**< 原子表，以名称索引 */
+	char **names;		/**< 名称列表，以原子为下标 */
+	size_t length;		/**< 名称数量，包括空名称 */
+	size_t max;		/**< 名称列表的容量 */
+	LCUI_Mutex mutex;
+} self;
+
+void LCUIAtom_Init( void )
+{
+	if( self.is_inited ) {
+		return;
+	}
+	/* 名称由名称列表持有，原子表只引用它们 */
+	self.atoms = Dict_Create( &DictType_StringKey, NULL );
+	self.names = NULL;
+	self.length = 1;
+	self.max = 0;
+	LCUIMutex_Init( &self.mutex );
+	self.is_inited = TRUE;
+}
+
+LCUI_Atom LCUIAtom_Find( const char *name )
+{
+	LCUI_Atom atom;
+	if( !name ) {
+		return LCUI_ATOM_NONE;
+	}
+	LCUIMutex_Lock( &self.mutex );
+	atom = (LCUI_Atom)(size_t)Dict_FetchValue( self.atoms, name );
+	LCUIMutex_Unlock( &self.mutex );
+	return atom;
+}
+
+LCUI_Atom LCUIAtom_Get( const char *name )
+{
+	char *str, **names;
+	LCUI_Atom atom;
+	if( !name ) {
+		return LCUI_ATOM_NONE;
+	}
+	LCUIMutex_Lock( &self.mutex );
+	atom = (LCUI_Atom)(size_t)Dict_FetchValue( self.atoms, name );
+	if( atom != LCUI_ATOM_NONE ) {
+		LCUIMutex_Unlock( &self.mutex );
+		return atom;
+	}
+	if( self.length >= self.max ) {
+		size_t max = self.max > 0 ? self.max * 2 : 256;
+		names = realloc( self.names, sizeof( char* ) * max );
+		if( !names ) {
+			LCUIMutex_Unlock( &self.mutex );
+			return LCUI_ATOM_NONE;
+		}
+		names[0] = NULL;
+		self.names = names;
+		self.max = max;
+	}
+	str = strdup( name );
+	if( !str ) {
+		LCUIMutex_Unlock( &self.mutex );
+		return LCUI_ATOM_NONE;
+	}
+	atom = (LCUI_Atom)self.length;
+	self.names[self.length++] = str;
+	Dict_Add( self.atoms, str, (void*)(size_t)atom );
+	LCUIMutex_Unlock( &self.mutex );
+	return atom;
+}
+
+const char *LCUIAtom_GetName( LCUI_Atom atom )
+{
+	const char *name = NULL;
+	if( atom == LCUI_ATOM_NONE || !self.is_inited ) {
+		return NULL;
+	}
+	LCUIMutex_Lock( &self.mutex );
+	if( atom < self.length ) {
+		name = self.names[atom];
+	}
+	LCUIMutex_Unlock( &self.mutex );
+	return name;
+}
@@ -273,6 +273,39 @@ void LCUIRect_MergeRect( LCUI_Rect *big, LCUI_Rect *a, LCUI_Rect *b )
 	}
 }
 
+LCUI_BOOL LCUIRect_CutCoveredArea( LCUI_Rect *rect, const LCUI_Rect *cover )
+{
+	int x1 = rect->x, y1 = rect->y;
+	int x2 = rect->x + rect->width, y2 = rect->y + rect->height;
+	int cx1 = cover->x, cy1 = cover->y;
+	int cx2 = cover->x + cover->width, cy2 = cover->y + cover->height;
+
+	/* 遮挡矩形横跨整个宽度，裁剪掉上方或下方被遮挡的部分 */
+	if( cx1 <= x1 && cx2 >= x2 ) {
+		if( cy1 <= y1 && cy2 >= y2 ) {
+			return TRUE;
+		}
+		if( cy1 <= y1 && cy2 > y1 ) {
+			y1 = cy2;
+		} else if( cy2 >= y2 && cy1 < y2 ) {
+			y2 = cy1;
+		}
+	}
+	/* 遮挡矩形横跨整个高度，裁剪掉左侧或右侧被遮挡的部分 */
+	else if( cy1 <= y1 && cy2 >= y2 ) {
+		if( cx1 <= x1 && cx2 > x1 ) {
+			x1 = cx2;
+		} else if( cx2 >= x2 && cx1 < x2 ) {
+			x2 = cx1;
+		}
+	}
+	rect->x = x1;
+	rect->y = y1;
+	rect->width = x2 - x1;
+	rect->height = y2 - y1;
+	return FALSE;
+}
+
 void LCUIRect_CutFourRect( LCUI_Rect *rect1, LCUI_Rect *rect2,
 			   LCUI_Rect rects[4] )
 {
@@ -365,7 +398,9 @@ int RectList_Delete( LinkedList *list, LCUI_Rect *rect )
 				    || tmp_rect[i].height <= 0 ) {
 					continue;
 				}
-				LinkedList_Insert( list, 0, &tmp_rect[0] );
+				p_rect = NEW( LCUI_Rect, 1 );
+				*p_rect = tmp_rect[i];
+				LinkedList_Insert( list, 0, p_rect );
 			}
 			/*
 			 * 既然现有矩形包含了这个矩形，那么不用继续遍历了，
@@ -386,7 +421,9 @@ int RectList_Delete( LinkedList *list, LCUI_Rect *rect )
 			if( tmp_rect[i].width <= 0 || tmp_rect[i].height <= 0 ) {
 				continue;
 			}
-			LinkedList_Insert( list, 0, &tmp_rect[i] );
+			p_rect = NEW( LCUI_Rect, 1 );
+			*p_rect = tmp_rect[i];
+			LinkedList_Insert( list, 0, p_rect );
 		}
 	}
 	return 1;
@@ -0,0 +1,516 @@
+/* ***************************************************************************
+ * region.c -- Banded region handling
+ *
+ * Copyright (C) 2017 by Liu Chao <lc-soft@live.cn>
+ *
+ * This file is part of the LCUI project, and may only be used, modified, and
+ * distributed under the terms of the GPLv2.
+ *
+ * (GPLv2 is abbreviation of GNU General Public License Version 2)
+ *
+ * By continuing to use, modify, or distribute this file you indicate that you
+ * have read the license and understand and accept it fully.
+ *
+ * The LCUI project is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GPL v2 for more details.
+ *
+ * You should have received a copy of the GPLv2 along with this file. It is
+ * usually in the LICENSE.TXT file, If not, see <http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+/* ****************************************************************************
+ * region.c -- 分带区域处理
+ *
+ * 版权所有 (C) 2017 归属于 刘超 <lc-soft@live.cn>
+ *
+ * 这个文件是LCUI项目的一部分，并且只可以根据GPLv2许可协议来使用、更改和发布。
+ *
+ * (GPLv2 是 GNU通用公共许可证第二版 的英文缩写)
+ *
+ * 继续使用、修改或发布本文件，表明您已经阅读并完全理解和接受这个许可协议。
+ *
+ * LCUI 项目是基于使用目的而加以散布的，但不负任何担保责任，甚至没有适销性或特
+ * 定用途的隐含担保，详情请参照GPLv2许可协议。
+ *
+ * 您应已收到附随于本文件的GPLv2许可协议的副本，它通常在LICENSE.TXT文件中，如果
+ * 没有，请查看：<http://www.gnu.org/licenses/>.
+ * ****************************************************************************/
+
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+
+enum RegionOpType {
+	REGION_OP_UNION,
+	REGION_OP_INTERSECT,
+	REGION_OP_SUBTRACT
+};
+
+/** 根据操作类型，判断某点在区域 A 和 B 中的状态是否属于结果区域 */
+static LCUI_BOOL RegionOp_Test( int op, LCUI_BOOL in_a, LCUI_BOOL in_b )
+{
+	switch( op ) {
+	case REGION_OP_UNION: return in_a || in_b;
+	case REGION_OP_INTERSECT: return in_a && in_b;
+	case REGION_OP_SUBTRACT: return in_a && !in_b;
+	default: break;
+	}
+	return FALSE;
+}
+
+static int Region_Reserve( LCUI_Region region, int n )
+{
+	int capacity;
+	LCUI_Rect *rects;
+	if( region->length + n <= region->capacity ) {
+		return 0;
+	}
+	capacity = region->capacity > 0 ? region->capacity * 2 : 8;
+	while( capacity < region->length + n ) {
+		capacity *= 2;
+	}
+	rects = realloc( region->rects, sizeof( LCUI_Rect ) * capacity );
+	if( !rects ) {
+		return -ENOMEM;
+	}
+	region->rects = rects;
+	region->capacity = capacity;
+	return 0;
+}
+
+/** 获取从 start 开始的矩形带的结束位置 */
+static int Region_GetBandEnd( LCUI_Region region, int start )
+{
+	int i = start + 1;
+	int y = region->rects[start].y;
+	while( i < region->length && region->rects[i].y == y ) {
+		++i;
+	}
+	return i;
+}
+
+/**
+ * 将新的矩形带追加到区域末尾
+ * 如果新矩形带与上一个矩形带相邻，且水平方向上的分布完全一致，则直接合并到
+ * 上一个矩形带中，以减少矩形数量
+ * @param[in] band_start 上一个矩形带的开始位置，若没有则为 -1
+ * @param[in] start 新矩形带的开始位置
+ * @returns 合并后的最后一个矩形带的开始位置
+ */
+static int Region_CoalesceBand( LCUI_Region region, int band_start, int start )
+{
+	int i, n;
+	LCUI_Rect *prev, *cur;
+	n = region->length - start;
+	if( n <= 0 ) {
+		return band_start;
+	}
+	if( band_start < 0 || start - band_start != n ) {
+		return start;
+	}
+	prev = region->rects + band_start;
+	cur = region->rects + start;
+	if( prev->y + prev->height != cur->y ) {
+		return start;
+	}
+	for( i = 0; i < n; ++i ) {
+		if( prev[i].x != cur[i].x || prev[i].width != cur[i].width ) {
+			return start;
+		}
+	}
+	for( i = 0; i < n; ++i ) {
+		prev[i].height += cur[i].height;
+	}
+	region->length = start;
+	return band_start;
+}
+
+/**
+ * 合并两个矩形带中的水平线段，结果追加到区域中
+ * @param[in] a, a_end 矩形带 A 的矩形，a 为 NULL 时表示该矩形带为空
+ * @param[in] y1, y2 结果矩形带的上下边界
+ */
+static int Region_AppendBand( LCUI_Region region, int op,
+			      const LCUI_Rect *a, const LCUI_Rect *a_end,
+			      const LCUI_Rect *b, const LCUI_Rect *b_end,
+			      int y1, int y2 )
+{
+	int x, x1 = 0, ax, bx;
+	LCUI_Rect *rect;
+	LCUI_BOOL in_a = FALSE, in_b = FALSE, in_out = FALSE, in;
+
+	while( a < a_end || b < b_end ) {
+		ax = a < a_end ? (in_a ? a->x + a->width : a->x) : INT_MAX;
+		bx = b < b_end ? (in_b ? b->x + b->width : b->x) : INT_MAX;
+		x = ax < bx ? ax : bx;
+		/* 同一位置上的端点需要一起处理，以免相接的线段被拆开 */
+		if( ax == x ) {
+			if( in_a ) {
+				++a;
+			}
+			in_a = !in_a;
+		}
+		if( bx == x ) {
+			if( in_b ) {
+				++b;
+			}
+			in_b = !in_b;
+		}
+		in = RegionOp_Test( op, in_a, in_b );
+		if( in == in_out ) {
+			continue;
+		}
+		in_out = in;
+		if( in ) {
+			x1 = x;
+			continue;
+		}
+		if( Region_Reserve( region, 1 ) != 0 ) {
+			return -ENOMEM;
+		}
+		rect = &region->rects[region->length++];
+		rect->x = x1;
+		rect->y = y1;
+		rect->width = x - x1;
+		rect->height = y2 - y1;
+	}
+	return 0;
+}
+
+static void Region_UpdateExtents( LCUI_Region region )
+{
+	int i, x2, y2;
+	LCUI_Rect *rect, *last;
+	LCUI_Rect *extents = &region->extents;
+	if( region->length <= 0 ) {
+		extents->x = extents->y = 0;
+		extents->width = extents->height = 0;
+		return;
+	}
+	rect = region->rects;
+	last = &region->rects[region->length - 1];
+	extents->x = rect->x;
+	extents->y = rect->y;
+	x2 = rect->x + rect->width;
+	y2 = last->y + last->height;
+	for( i = 1; i < region->length; ++i ) {
+		rect = &region->rects[i];
+		if( rect->x < extents->x ) {
+			extents->x = rect->x;
+		}
+		if( rect->x + rect->width > x2 ) {
+			x2 = rect->x + rect->width;
+		}
+	}
+	extents->width = x2 - extents->x;
+	extents->height = y2 - extents->y;
+}
+
+/**
+ * 对两个区域进行布尔运算
+ * 在竖直方向上按两个区域中所有矩形带的上下边界进行分段，对每一段中的水平线段
+ * 进行运算，然后合并相同的相邻矩形带
+ * 结果直接写入 out 已有的矩形数组中；如果 out 也是操作数，则写入它的备用矩形
+ * 数组，完成后再交换两者，这样反复运算时不需要重新分配内存
+ * 内存不足时，若 out 是操作数则保持不变，否则被清空
+ */
+static int Region_Op( LCUI_Region out, LCUI_Region ra,
+		      LCUI_Region rb, int op )
+{
+	int y, y2, band = -1, start;
+	int ia = 0, ib = 0, ia_end, ib_end;
+	LCUI_BOOL in_a, in_b, use_spare;
+	LCUI_Rect *a, *b;
+	LCUI_RegionRec result;
+
+	use_spare = out == ra || out == rb;
+	if( use_spare ) {
+		result.rects = out->spare;
+		result.capacity = out->spare_capacity;
+	} else {
+		result.rects = out->rects;
+		result.capacity = out->capacity;
+	}
+	result.length = 0;
+	ia_end = ra->length > 0 ? Region_GetBandEnd( ra, 0 ) : 0;
+	ib_end = rb->length > 0 ? Region_GetBandEnd( rb, 0 ) : 0;
+	if( ra->length > 0 && rb->length > 0 ) {
+		y = ra->rects[0].y < rb->rects[0].y ?
+			ra->rects[0].y : rb->rects[0].y;
+	} else if( ra->length > 0 ) {
+		y = ra->rects[0].y;
+	} else if( rb->length > 0 ) {
+		y = rb->rects[0].y;
+	} else {
+		y = 0;
+	}
+	while( ia < ra->length || ib < rb->length ) {
+		a = ia < ra->length ? &ra->rects[ia] : NULL;
+		b = ib < rb->length ? &rb->rects[ib] : NULL;
+		in_a = a && a->y <= y;
+		in_b = b && b->y <= y;
+		/* 计算当前分段的下边界 */
+		y2 = INT_MAX;
+		if( a ) {
+			y2 = in_a ? a->y + a->height : a->y;
+		}
+		if( b ) {
+			if( in_b ) {
+				if( b->y + b->height < y2 ) {
+					y2 = b->y + b->height;
+				}
+			} else if( b->y < y2 ) {
+				y2 = b->y;
+			}
+		}
+		if( in_a || in_b ) {
+			start = result.length;
+			if( Region_AppendBand( &result, op,
+					       a, in_a ? ra->rects + ia_end : a,
+					       b, in_b ? rb->rects + ib_end : b,
+					       y, y2 ) != 0 ) {
+				if( use_spare ) {
+					out->spare = result.rects;
+					out->spare_capacity = result.capacity;
+					return -ENOMEM;
+				}
+				out->rects = result.rects;
+				out->capacity = result.capacity;
+				Region_Clear( out );
+				return -ENOMEM;
+			}
+			band = Region_CoalesceBand( &result, band, start );
+		}
+		y = y2;
+		/* 跳过已经处理完的矩形带 */
+		if( a && a->y + a->height <= y ) {
+			ia = ia_end;
+			if( ia < ra->length ) {
+				ia_end = Region_GetBandEnd( ra, ia );
+			}
+		}
+		if( b && b->y + b->height <= y ) {
+			ib = ib_end;
+			if( ib < rb->length ) {
+				ib_end = Region_GetBandEnd( rb, ib );
+			}
+		}
+	}
+	if( use_spare ) {
+		out->spare = out->rects;
+		out->spare_capacity = out->capacity;
+	}
+	out->rects = result.rects;
+	out->capacity = result.capacity;
+	out->length = result.length;
+	Region_UpdateExtents( out );
+	return 0;
+}
+
+/** 将矩形包装为只读的区域，以便参与区域运算 */
+static void Region_FromRect( LCUI_Region region, const LCUI_Rect *rect )
+{
+	region->rects = (LCUI_Rect*)rect;
+	region->capacity = 0;
+	region->spare = NULL;
+	region->spare_capacity = 0;
+	region->length = rect->width > 0 && rect->height > 0 ? 1 : 0;
+	region->extents = *rect;
+}
+
+void Region_Init( LCUI_Region region )
+{
+	region->rects = NULL;
+	region->length = 0;
+	region->capacity = 0;
+	region->spare = NULL;
+	region->spare_capacity = 0;
+	region->extents.x = region->extents.y = 0;
+	region->extents.width = region->extents.height = 0;
+}
+
+void Region_Destroy( LCUI_Region region )
+{
+	free( region->rects );
+	free( region->spare );
+	Region_Init( region );
+}
+
+void Region_Clear( LCUI_Region region )
+{
+	region->length = 0;
+	region->extents.x = region->extents.y = 0;
+	region->extents.width = region->extents.height = 0;
+}
+
+int Region_Copy( LCUI_Region dst, LCUI_Region src )
+{
+	dst->length = 0;
+	if( Region_Reserve( dst, src->length ) != 0 ) {
+		return -ENOMEM;
+	}
+	if( src->length > 0 ) {
+		memcpy( dst->rects, src->rects, sizeof( LCUI_Rect ) * src->length );
+	}
+	dst->length = src->length;
+	dst->extents = src->extents;
+	return 0;
+}
+
+int Region_Union( LCUI_Region out, LCUI_Region a, LCUI_Region b )
+{
+	if( b->length <= 0 ) {
+		return out == a ? 0 : Region_Copy( out, a );
+	}
+	if( a->length <= 0 ) {
+		return out == b ? 0 : Region_Copy( out, b );
+	}
+	return Region_Op( out, a, b, REGION_OP_UNION );
+}
+
+int Region_Intersect( LCUI_Region out, LCUI_Region a, LCUI_Region b )
+{
+	if( a->length <= 0 || b->length <= 0 ) {
+		Region_Clear( out );
+		return 0;
+	}
+	return Region_Op( out, a, b, REGION_OP_INTERSECT );
+}
+
+int Region_Subtract( LCUI_Region out, LCUI_Region a, LCUI_Region b )
+{
+	if( a->length <= 0 || b->length <= 0 ) {
+		return out == a ? 0 : Region_Copy( out, a );
+	}
+	return Region_Op( out, a, b, REGION_OP_SUBTRACT );
+}
+
+int Region_UnionRect( LCUI_Region region, const LCUI_Rect *rect )
+{
+	LCUI_RegionRec tmp;
+	if( rect->width <= 0 || rect->height <= 0 ) {
+		return -1;
+	}
+	/* 已经包含了该矩形则无需运算 */
+	if( Region_ContainsRect( region, rect ) ) {
+		return 0;
+	}
+	if( region->length <= 0 ) {
+		if( Region_Reserve( region, 1 ) != 0 ) {
+			return -ENOMEM;
+		}
+		region->rects[0] = *rect;
+		region->length = 1;
+		region->extents = *rect;
+		return 0;
+	}
+	Region_FromRect( &tmp, rect );
+	return Region_Op( region, region, &tmp, REGION_OP_UNION );
+}
+
+int Region_IntersectRect( LCUI_Region region, const LCUI_Rect *rect )
+{
+	LCUI_RegionRec tmp;
+	Region_FromRect( &tmp, rect );
+	return Region_Intersect( region, region, &tmp );
+}
+
+int Region_IntersectWithRect( LCUI_Region out, LCUI_Region region,
+			      const LCUI_Rect *rect )
+{
+	LCUI_RegionRec tmp;
+	if( !LCUIRect_IsCoverRect( &region->extents, (LCUI_Rect*)rect ) ) {
+		Region_Clear( out );
+		return 0;
+	}
+	Region_FromRect( &tmp, rect );
+	return Region_Intersect( out, region, &tmp );
+}
+
+int Region_SubtractRect( LCUI_Region region, const LCUI_Rect *rect )
+{
+	LCUI_RegionRec tmp;
+	if( !LCUIRect_IsCoverRect( &region->extents, (LCUI_Rect*)rect ) ) {
+		return 0;
+	}
+	Region_FromRect( &tmp, rect );
+	return Region_Subtract( region, region, &tmp );
+}
+
+LCUI_BOOL Region_ContainsRect( LCUI_Region region, const LCUI_Rect *rect )
+{
+	int i, j, x, y, band_end;
+	LCUI_Rect *r;
+
+	if( region->length <= 0 || rect->width <= 0 || rect->height <= 0 ) {
+		return FALSE;
+	}
+	i = 0;
+	y = rect->y;
+	while( i < region->length && y < rect->y + rect->height ) {
+		r = &region->rects[i];
+		band_end = Region_GetBandEnd( region, i );
+		if( r->y + r->height <= y ) {
+			i = band_end;
+			continue;
+		}
+		/* 出现了未被覆盖的空隙 */
+		if( r->y > y ) {
+			return FALSE;
+		}
+		/* 检查当前矩形带是否覆盖了整个水平范围 */
+		for( x = rect->x, j = i; j < band_end; ++j ) {
+			r = &region->rects[j];
+			if( r->x <= x && r->x + r->width > x ) {
+				x = r->x + r->width;
+			}
+		}
+		if( x < rect->x + rect->width ) {
+			return FALSE;
+		}
+		y = r->y + r->height;
+		i = band_end;
+	}
+	return y >= rect->y + rect->height;
+}
+
+LCUI_BOOL Region_OverlapsRect( LCUI_Region region, const LCUI_Rect *rect )
+{
+	int i;
+	LCUI_Rect *r;
+
+	if( region->length <= 0 || rect->width <= 0 || rect->height <= 0 ||
+	    !LCUIRect_IsCoverRect( &region->extents, (LCUI_Rect*)rect ) ) {
+		return FALSE;
+	}
+	for( i = 0; i < region->length; ++i ) {
+		r = &region->rects[i];
+		/* 矩形带按 Y 坐标排列，后面的矩形都在下方 */
+		if( r->y >= rect->y + rect->height ) {
+			break;
+		}
+		if( r->y + r->height > rect->y &&
+		    r->x < rect->x + rect->width &&
+		    r->x + r->width > rect->x ) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+void Region_Translate( LCUI_Region region, int dx, int dy )
+{
+	int i;
+	for( i = 0; i < region->length; ++i ) {
+		region->rects[i].x += dx;
+		region->rects[i].y += dy;
+	}
+	if( region->length > 0 ) {
+		region->extents.x += dx;
+		region->extents.y += dy;
+	}
+}
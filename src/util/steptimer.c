@@ -114,6 +114,11 @@ void StepTimer_Remain( StepTimer timer )
 	if( n_ms < 1 ) {
 		goto normal_exit;
 	}
+	/* 使用虚拟时钟时不需要真的睡眠，直接推进时间即可 */
+	if( LCUITime_IsVirtualClock() ) {
+		LCUITime_Advance( n_ms );
+		goto normal_exit;
+	}
 	/* 睡眠一段时间 */
 	while( lost_ms < n_ms && timer->state == STATE_RUN ) {
 		LCUICond_TimedWait( &timer->cond, &timer->mutex, n_ms - lost_ms );
@@ -135,7 +140,9 @@ void StepTimer_Remain( StepTimer timer )
 
 normal_exit:;
 	current_time = LCUI_GetTime();
-	if( current_time - timer->prev_fps_update_time >= 1000 ) {
+	/* 时钟可能被切换过，时间倒退时也需要重新开始计数 */
+	if( current_time - timer->prev_fps_update_time >= 1000 ||
+	    current_time < timer->prev_fps_update_time ) {
 		timer->current_fps = timer->temp_fps;
 		timer->prev_fps_update_time = current_time;
 		timer->temp_fps = 0;
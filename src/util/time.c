@@ -40,10 +40,18 @@
 #include <time.h>
 #include <stdint.h>
 #include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
 #include <LCUI/util/time.h>
 
 #define TIME_WRAP_VALUE (~(int64_t)0)
 
+/** 虚拟时钟，启用后 LCUI_GetTime() 返回的时间只在主动推进时改变 */
+static struct VirtualClock {
+	LCUI_BOOL enabled;
+	int64_t time;
+	int64_t offset;		/**< 停用虚拟时钟后，系统时间需要加上的偏移量 */
+} virtual_clock;
+
 #ifdef LCUI_BUILD_IN_WIN32
 #include <Windows.h>
 #include <Mmsystem.h>
@@ -64,7 +72,7 @@ void LCUITime_Init( void )
 	}
 }
 
-int64_t LCUI_GetTime( void )
+static int64_t GetSystemTime( void )
 {
 	LARGE_INTEGER hires_now;
 	if( hires_timer_available ) {
@@ -76,6 +84,17 @@ int64_t LCUI_GetTime( void )
 	return (int64_t)timeGetTime();
 }
 
+int64_t LCUI_GetTimeUS( void )
+{
+	LARGE_INTEGER hires_now;
+	if( hires_timer_available ) {
+		QueryPerformanceCounter( &hires_now );
+		return (int64_t)(hires_now.QuadPart * 1000000.0 /
+				 hires_ticks_per_second);
+	}
+	return (int64_t)timeGetTime() * 1000;
+}
+
 #elif defined LCUI_BUILD_IN_LINUX
 #include <unistd.h>
 #include <sys/time.h>
@@ -86,18 +105,63 @@ void LCUITime_Init( void )
 	return;
 }
 
-int64_t LCUI_GetTime( void )
+/** 使用单调时钟，系统时间被修改时不会影响定时器和帧率控制 */
+static int64_t GetSystemTime( void )
 {
 	int64_t t;
-	struct timeval tv;
+	struct timespec ts;
 
-	gettimeofday( &tv, NULL );
-	t = tv.tv_sec*1000 + tv.tv_usec/1000;
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	t = (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
 	return t;
 }
 
+int64_t LCUI_GetTimeUS( void )
+{
+	struct timespec ts;
+
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
 #endif
 
+int64_t LCUI_GetTime( void )
+{
+	if( virtual_clock.enabled ) {
+		return virtual_clock.time;
+	}
+	return GetSystemTime() + virtual_clock.offset;
+}
+
+/**
+ * 切换时钟时让时间保持连续，已设置的定时器的剩余时间不会因切换而改变
+ * 显示驱动可能在定时器模块初始化之后才启用虚拟时钟，如果让时间从 0 开始，
+ * 之前设置的定时器的到期时间会远在未来，永远不会触发
+ */
+void LCUITime_SetVirtualClock( LCUI_BOOL enabled )
+{
+	if( virtual_clock.enabled == enabled ) {
+		return;
+	}
+	if( enabled ) {
+		virtual_clock.time = GetSystemTime() + virtual_clock.offset;
+	} else {
+		virtual_clock.offset = virtual_clock.time - GetSystemTime();
+	}
+	virtual_clock.enabled = enabled;
+}
+
+LCUI_BOOL LCUITime_IsVirtualClock( void )
+{
+	return virtual_clock.enabled;
+}
+
+void LCUITime_Advance( unsigned int ms )
+{
+	virtual_clock.time += ms;
+}
+
 int64_t LCUI_GetTimeDelta( int64_t start )
 {
 	int64_t now = LCUI_GetTime();
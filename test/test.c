@@ -2,6 +2,7 @@
 #include <wchar.h>
 #include <LCUI_Build.h>
 #include <LCUI/LCUI.h>
+#include <LCUI/display.h>
 #include "test.h"
 
 #ifdef LCUI_BUILD_IN_WIN32
@@ -25,9 +26,25 @@ int main(void)
 	Logger_SetHandlerW( LoggerHandlerW );
 #endif
 	ret |= test_string();
-	ret |= test_image_reader();/*
-	ret |= test_css_parser();
+	ret |= test_image_reader();
+	ret |= test_graph_mix();
+	ret |= test_region();
+	ret |= test_fbdisplay();
+	ret |= test_framestats();
+	ret |= test_trace();
+	/* 以下测试需要用到 LCUI 的各个模块，使用无界面的显示驱动 */
+	LCUI_InitBase();
+	LCUI_InitApp( NULL );
+	LCUI_InitDisplay( LCUI_CreateHeadlessDisplay() );
+	ret |= test_atom();
+	ret |= test_taskqueue();
+	ret |= test_headless();
+	ret |= test_timer();
 	ret |= test_widget_render();
+	ret |= test_widget_style();
+	ret |= test_x11display();
+	LCUI_Destroy();/*
+	ret |= test_css_parser();
 	ret |= test_char_render();
 	ret |= test_string_render();*/
 	printf("test result code: %d\n", ret);
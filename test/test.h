@@ -7,3 +7,14 @@ int test_char_render( void );
 int test_string_render( void );
 int test_widget_render( void );
 int test_image_reader( void );
+int test_graph_mix( void );
+int test_region( void );
+int test_fbdisplay( void );
+int test_taskqueue( void );
+int test_headless( void );
+int test_timer( void );
+int test_widget_style( void );
+int test_x11display( void );
+int test_framestats( void );
+int test_trace( void );
+int test_atom( void );
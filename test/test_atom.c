@@ -0,0 +1,53 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include "test.h"
+
+/** 登记的名称数量，足以让名称列表扩容数次 */
+#define TEST_ATOMS	2000
+
+int test_atom( void )
+{
+	int i;
+	char name[32];
+	const char *str;
+	LCUI_Atom atom, first, atoms[TEST_ATOMS];
+
+	assert( LCUIAtom_Get( NULL ) == LCUI_ATOM_NONE );
+	assert( LCUIAtom_Find( NULL ) == LCUI_ATOM_NONE );
+	assert( LCUIAtom_GetName( LCUI_ATOM_NONE ) == NULL );
+	/* 查找不会登记名称 */
+	assert( LCUIAtom_Find( "test-atom-first" ) == LCUI_ATOM_NONE );
+	assert( LCUIAtom_Find( "test-atom-first" ) == LCUI_ATOM_NONE );
+	first = LCUIAtom_Get( "test-atom-first" );
+	assert( first != LCUI_ATOM_NONE );
+	assert( LCUIAtom_Get( "test-atom-first" ) == first );
+	assert( LCUIAtom_Find( "test-atom-first" ) == first );
+	str = LCUIAtom_GetName( first );
+	assert( str && strcmp( str, "test-atom-first" ) == 0 );
+	/* 名称是按内容比较的，而不是按地址 */
+	strcpy( name, "test-atom-first" );
+	assert( LCUIAtom_Get( name ) == first );
+	for( i = 0; i < TEST_ATOMS; ++i ) {
+		sprintf( name, "test-atom-%d", i );
+		assert( LCUIAtom_Find( name ) == LCUI_ATOM_NONE );
+		atoms[i] = LCUIAtom_Get( name );
+		assert( atoms[i] != LCUI_ATOM_NONE && atoms[i] != first );
+		assert( i == 0 || atoms[i] != atoms[i - 1] );
+	}
+	/* 名称列表扩容后，已有的原子和名称保持不变 */
+	assert( LCUIAtom_GetName( first ) == str );
+	assert( LCUIAtom_Find( "test-atom-first" ) == first );
+	for( i = 0; i < TEST_ATOMS; ++i ) {
+		sprintf( name, "test-atom-%d", i );
+		assert( LCUIAtom_Find( name ) == atoms[i] );
+		assert( LCUIAtom_Get( name ) == atoms[i] );
+		assert( strcmp( LCUIAtom_GetName( atoms[i] ), name ) == 0 );
+	}
+	/* 没有分配出去的原子没有名称 */
+	atom = atoms[TEST_ATOMS - 1] + 1;
+	assert( LCUIAtom_GetName( atom ) == NULL );
+	return 0;
+}
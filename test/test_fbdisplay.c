@@ -0,0 +1,132 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include "test.h"
+
+#if defined(LCUI_BUILD_IN_LINUX) && defined(LCUI_VIDEO_DRIVER_FRAMEBUFFER)
+#include <LCUI/display.h>
+#include <LCUI/platform.h>
+#include LCUI_DISPLAY_H
+
+#define SCREEN_WIDTH	64
+#define SCREEN_HEIGHT	48
+#define FB_FILE		"test_fbdisplay.fb"
+
+/** 读取帧缓存文件中的像素，并转换为 24 位的 RGB 值 */
+static unsigned int ReadPixel( const unsigned char *mem, int bpp, int x, int y )
+{
+	unsigned int v;
+	const unsigned char *p;
+	p = mem + (y * SCREEN_WIDTH + x) * (bpp / 8);
+	if( bpp == 16 ) {
+		v = p[0] | (p[1] << 8);
+		return ((v >> 11) << 19) | (((v >> 5) & 0x3f) << 10) |
+			((v & 0x1f) << 3);
+	}
+	return (p[2] << 16) | (p[1] << 8) | p[0];
+}
+
+/** 获取颜色在帧缓存中存储后的值，RGB565 格式会丢失低位 */
+static unsigned int ToScreenColor( int bpp, unsigned int rgb )
+{
+	return bpp == 16 ? rgb & 0xf8fcf8 : rgb;
+}
+
+static int test_fbdisplay_bpp( int bpp )
+{
+	FILE *fp;
+	int ret = 0;
+	LCUI_Rect rect;
+	LCUI_Surface surface;
+	LCUI_PaintContext paint;
+	LCUI_DisplayDriver driver;
+	size_t size = SCREEN_WIDTH * SCREEN_HEIGHT * (bpp / 8);
+	unsigned char *mem = malloc( size );
+
+	/* 用普通文件模拟帧缓存设备，驱动会将它扩展到所需的大小 */
+	fp = fopen( FB_FILE, "wb" );
+	assert( fp != NULL );
+	fclose( fp );
+	driver = LCUI_OpenLinuxFBDisplayDriver( FB_FILE, SCREEN_WIDTH,
+						SCREEN_HEIGHT, bpp );
+	assert( driver != NULL );
+	assert( driver->getWidth() == SCREEN_WIDTH );
+	surface = driver->create();
+	driver->move( surface, 8, 4 );
+	driver->resize( surface, 32, 24 );
+	driver->show( surface );
+	driver->present( surface );
+	rect = Rect( 4, 4, 8, 8 );
+	paint = driver->beginPaint( surface, &rect );
+	Graph_FillRect( &paint->canvas, RGB( 255, 0, 0 ), NULL, FALSE );
+	driver->endPaint( surface, paint );
+	driver->present( surface );
+	fp = fopen( FB_FILE, "rb" );
+	if( !fp || fread( mem, 1, size, fp ) != size ) {
+		ret = -1;
+	}
+	if( fp ) {
+		fclose( fp );
+	}
+	/* 表面外的区域为黑色，表面内为白色，绘制过的区域为红色 */
+	if( ret == 0 && ( ReadPixel( mem, bpp, 0, 0 ) != 0 ||
+			  ReadPixel( mem, bpp, 8, 4 ) !=
+			  ToScreenColor( bpp, 0xffffff ) ||
+			  ReadPixel( mem, bpp, 12, 8 ) !=
+			  ToScreenColor( bpp, 0xff0000 ) ||
+			  ReadPixel( mem, bpp, 19, 15 ) !=
+			  ToScreenColor( bpp, 0xff0000 ) ||
+			  ReadPixel( mem, bpp, 20, 16 ) !=
+			  ToScreenColor( bpp, 0xffffff ) ) ) {
+		ret = -2;
+	}
+	/* 改写帧缓存中未被重绘的像素，再次呈现后它应该保持不变 */
+	fp = fopen( FB_FILE, "r+b" );
+	if( ret == 0 && fp ) {
+		memset( mem, 0, 4 );
+		fseek( fp, (20 * SCREEN_WIDTH + 30) * (bpp / 8), SEEK_SET );
+		fwrite( mem, 1, bpp / 8, fp );
+		fclose( fp );
+		rect = Rect( 0, 0, 2, 2 );
+		paint = driver->beginPaint( surface, &rect );
+		Graph_FillRect( &paint->canvas, RGB( 0, 0, 255 ), NULL, FALSE );
+		driver->endPaint( surface, paint );
+		driver->present( surface );
+		fp = fopen( FB_FILE, "rb" );
+		if( !fp || fread( mem, 1, size, fp ) != size ||
+		    ReadPixel( mem, bpp, 30, 20 ) != 0 ||
+		    ReadPixel( mem, bpp, 9, 5 ) !=
+		    ToScreenColor( bpp, 0x0000ff ) ) {
+			ret = -3;
+		}
+	}
+	if( fp ) {
+		fclose( fp );
+	}
+	driver->destroy( surface );
+	LCUI_DestroyLinuxFBDisplayDriver( driver );
+	remove( FB_FILE );
+	free( mem );
+	return ret;
+}
+
+int test_fbdisplay( void )
+{
+	int ret = 0;
+	ret |= test_fbdisplay_bpp( 16 );
+	ret |= test_fbdisplay_bpp( 24 );
+	ret |= test_fbdisplay_bpp( 32 );
+	_DEBUG_MSG( "test fbdisplay: %d\n", ret );
+	return ret;
+}
+
+#else
+
+int test_fbdisplay( void )
+{
+	return 0;
+}
+
+#endif
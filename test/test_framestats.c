@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/framestats.h>
+#include "test.h"
+
+#define TEST_FRAMES	300
+#define TEST_SURFACES	6
+
+/** 忙等待指定的微秒数，比休眠更准确 */
+static void BusyWait( int64_t us )
+{
+	int64_t start = LCUI_GetTimeUS();
+	while( LCUI_GetTimeUS() - start < us );
+}
+
+/**
+ * 获取第 i 帧的渲染耗时
+ * 每 50 帧有 1 帧耗时 10 毫秒，每 10 帧有 1 帧耗时 2 毫秒，其余的耗时 0.2 毫秒，
+ * 因此 p50 落在 0.2 毫秒，p95 落在 2 毫秒，p99 落在 10 毫秒
+ */
+static int64_t GetFrameDuration( unsigned long i )
+{
+	if( i % 50 == 0 ) {
+		return 10000;
+	}
+	if( i % 10 == 5 ) {
+		return 2000;
+	}
+	return 200;
+}
+
+/** 检查百分位数是否在预期的范围内，估算的相对误差不超过 1/8 */
+static LCUI_BOOL CheckPercentiles( LCUI_FramePercentiles p )
+{
+	return p->p50 >= 200 * 7 / 8 && p->p50 < 2000 * 7 / 8 &&
+		p->p95 >= 2000 * 7 / 8 && p->p95 < 10000 * 7 / 8 &&
+		p->p99 >= 10000 * 7 / 8 && p->p99 <= p->max &&
+		p->max >= 10000;
+}
+
+int test_framestats( void )
+{
+	int j;
+	unsigned long i;
+	LCUI_FrameRecord frame;
+	LCUI_FrameStats stats;
+	LCUI_RegionRec region;
+	LCUI_Rect rect1 = { 0, 0, 10, 10 }, rect2 = { 20, 20, 5, 4 };
+	char surfaces[TEST_SURFACES];
+
+	stats = malloc( sizeof( LCUI_FrameStatsRec ) );
+	assert( stats != NULL );
+	Region_Init( &region );
+	Region_UnionRect( &region, &rect1 );
+	Region_UnionRect( &region, &rect2 );
+	LCUIFrameStats_Enable( FALSE );
+	assert( LCUI_GetFrameStats( stats ) == -1 );
+	/* 未启用时的探针不会留下任何记录 */
+	LCUIFrameStats_BeginFrame();
+	LCUIFrameStats_EndFrame();
+	LCUIFrameStats_Enable( TRUE );
+	assert( LCUI_GetFrameStats( stats ) == 0 );
+	assert( stats->total_frames == 0 && stats->length == 0 );
+	for( i = 0; i < TEST_FRAMES; ++i ) {
+		LCUIFrameStats_BeginFrame();
+		BusyWait( GetFrameDuration( i ) );
+		LCUIFrameStats_EndPhase( LCUI_FPHASE_RENDER );
+		for( j = 0; j < TEST_SURFACES; ++j ) {
+			LCUIFrameStats_AddRender( (LCUI_Surface)&surfaces[j],
+						  &region );
+		}
+		LCUIFrameStats_EndPhase( LCUI_FPHASE_PRESENT );
+		LCUIFrameStats_EndFrame();
+	}
+	assert( LCUI_GetFrameStats( stats ) == 0 );
+	assert( stats->total_frames == TEST_FRAMES );
+	assert( stats->length == LCUI_FRAME_STATS_SIZE );
+	/* 环形缓冲中只保留最近的帧，并且按时间先后排列 */
+	for( i = 0; i < stats->length; ++i ) {
+		frame = &stats->frames[i];
+		assert( frame->id == TEST_FRAMES - LCUI_FRAME_STATS_SIZE + i );
+		assert( i == 0 ||
+			frame->start_time >= stats->frames[i - 1].start_time );
+		assert( frame->phases[LCUI_FPHASE_RENDER] >=
+			GetFrameDuration( frame->id ) );
+		assert( frame->duration >= frame->phases[LCUI_FPHASE_RENDER] );
+		assert( frame->surfaces == TEST_SURFACES );
+		assert( frame->rects == TEST_SURFACES * 2 );
+		assert( frame->pixels == TEST_SURFACES * 120 );
+		for( j = 0; j < LCUI_FRAME_STATS_SURFACES; ++j ) {
+			assert( frame->renders[j].surface ==
+				(LCUI_Surface)&surfaces[j] );
+			assert( frame->renders[j].rects == 2 );
+			assert( frame->renders[j].pixels == 120 );
+		}
+		/* 第一个 surface 的耗时从阶段开始时算起 */
+		assert( frame->renders[0].duration <=
+			frame->phases[LCUI_FPHASE_PRESENT] );
+	}
+	assert( CheckPercentiles( &stats->frame ) );
+	assert( CheckPercentiles( &stats->phases[LCUI_FPHASE_RENDER] ) );
+	assert( stats->phases[LCUI_FPHASE_TASKS].max == 0 );
+	assert( stats->phases[LCUI_FPHASE_TASKS].p99 == 0 );
+	/* 重新启用时会清空之前的统计 */
+	LCUIFrameStats_Enable( FALSE );
+	LCUIFrameStats_Enable( TRUE );
+	assert( LCUI_GetFrameStats( stats ) == 0 );
+	assert( stats->total_frames == 0 && stats->length == 0 );
+	assert( stats->frame.max == 0 );
+	LCUIFrameStats_Enable( FALSE );
+	Region_Destroy( &region );
+	free( stats );
+	return 0;
+}
@@ -0,0 +1,213 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/graph.h>
+#include "test.h"
+
+#define TEST_SIZE 37
+
+/** 原来的浮点数版本的 alpha 叠加，作为参考结果 */
+static void MixPixelOver( LCUI_ARGB *dst, const LCUI_ARGB *src, float opacity )
+{
+	double a, src_a, out_a, out_r, out_g, out_b;
+	src_a = src->a / 255.0 * opacity;
+	a = (1.0 - src_a) * dst->a / 255.0;
+	out_r = dst->r * a + src->r * src_a;
+	out_g = dst->g * a + src->g * src_a;
+	out_b = dst->b * a + src->b * src_a;
+	out_a = src_a + a;
+	if( out_a > 0 ) {
+		out_r /= out_a;
+		out_g /= out_a;
+		out_b /= out_a;
+	}
+	dst->r = (uchar_t)(out_r + 0.5);
+	dst->g = (uchar_t)(out_g + 0.5);
+	dst->b = (uchar_t)(out_b + 0.5);
+	dst->a = (uchar_t)(255.0 * out_a + 0.5);
+}
+
+static void MixPixelBlend( LCUI_ARGB *dst, const LCUI_ARGB *src, float opacity )
+{
+	int a = (int)(src->a * opacity);
+	PIXEL_BLEND( dst, src, a );
+}
+
+static int CompareValue( int a, int b )
+{
+	return abs( a - b ) <= 1;
+}
+
+static int ComparePixel( const LCUI_ARGB *a, const LCUI_ARGB *b )
+{
+	return CompareValue( a->r, b->r ) && CompareValue( a->g, b->g ) &&
+		CompareValue( a->b, b->b ) && CompareValue( a->a, b->a );
+}
+
+static void RandomFill( LCUI_Graph *graph, LCUI_BOOL opaque )
+{
+	size_t i, n = graph->width * graph->height;
+	for( i = 0; i < n; ++i ) {
+		graph->argb[i].value = rand() ^ (rand() << 16);
+		switch( rand() % 4 ) {
+		case 0: graph->argb[i].a = 0; break;
+		case 1: graph->argb[i].a = 255; break;
+		default: break;
+		}
+		if( opaque ) {
+			graph->argb[i].a = 255;
+		}
+	}
+}
+
+static int test_mix_argb( float opacity, LCUI_BOOL with_alpha,
+			  LCUI_BOOL opaque_back )
+{
+	size_t i;
+	int ret = 0;
+	LCUI_ARGB px;
+	LCUI_Graph back, fore, ref;
+
+	Graph_Init( &back );
+	Graph_Init( &fore );
+	Graph_Init( &ref );
+	back.color_type = COLOR_TYPE_ARGB;
+	fore.color_type = COLOR_TYPE_ARGB;
+	Graph_Create( &back, TEST_SIZE, TEST_SIZE );
+	Graph_Create( &fore, TEST_SIZE, TEST_SIZE );
+	RandomFill( &back, opaque_back );
+	RandomFill( &fore, FALSE );
+	fore.opacity = opacity;
+	Graph_Copy( &ref, &back );
+	Graph_Mix( &back, &fore, 0, 0, with_alpha );
+	for( i = 0; i < TEST_SIZE * TEST_SIZE; ++i ) {
+		px = ref.argb[i];
+		if( with_alpha ) {
+			MixPixelOver( &px, &fore.argb[i], opacity );
+		} else {
+			MixPixelBlend( &px, &fore.argb[i], opacity );
+		}
+		if( !ComparePixel( &px, &back.argb[i] ) ) {
+			ret = -1;
+			break;
+		}
+	}
+	Graph_Free( &back );
+	Graph_Free( &fore );
+	Graph_Free( &ref );
+	return ret;
+}
+
+static int test_mix_rgb( float opacity )
+{
+	size_t i;
+	int ret = 0;
+	LCUI_ARGB px;
+	uchar_t *bytep;
+	LCUI_Graph back, fore, ref;
+
+	Graph_Init( &back );
+	Graph_Init( &fore );
+	Graph_Init( &ref );
+	back.color_type = COLOR_TYPE_RGB;
+	fore.color_type = COLOR_TYPE_ARGB;
+	Graph_Create( &back, TEST_SIZE, TEST_SIZE );
+	Graph_Create( &fore, TEST_SIZE, TEST_SIZE );
+	for( i = 0; i < back.mem_size; ++i ) {
+		back.bytes[i] = rand() % 256;
+	}
+	RandomFill( &fore, FALSE );
+	fore.opacity = opacity;
+	Graph_Copy( &ref, &back );
+	Graph_Mix( &back, &fore, 0, 0, FALSE );
+	for( i = 0; i < TEST_SIZE * TEST_SIZE; ++i ) {
+		bytep = ref.bytes + (i / TEST_SIZE) * ref.bytes_per_row;
+		bytep += (i % TEST_SIZE) * 3;
+		px.b = bytep[0];
+		px.g = bytep[1];
+		px.r = bytep[2];
+		MixPixelBlend( &px, &fore.argb[i], opacity );
+		bytep = back.bytes + (bytep - ref.bytes);
+		if( !CompareValue( px.b, bytep[0] ) ||
+		    !CompareValue( px.g, bytep[1] ) ||
+		    !CompareValue( px.r, bytep[2] ) ) {
+			ret = -1;
+			break;
+		}
+	}
+	Graph_Free( &back );
+	Graph_Free( &fore );
+	Graph_Free( &ref );
+	return ret;
+}
+
+/** 预乘 alpha 的像素叠加，参考结果 */
+static void MixPixelOverPM( LCUI_ARGB *dst, const LCUI_ARGB *src, float opacity )
+{
+	double k = 1.0 - src->a * opacity / 255.0;
+	dst->r = (uchar_t)(src->r * opacity + dst->r * k + 0.5);
+	dst->g = (uchar_t)(src->g * opacity + dst->g * k + 0.5);
+	dst->b = (uchar_t)(src->b * opacity + dst->b * k + 0.5);
+	dst->a = (uchar_t)(src->a * opacity + dst->a * k + 0.5);
+}
+
+static int test_mix_pargb( float opacity )
+{
+	size_t i;
+	int ret = 0;
+	LCUI_ARGB px;
+	LCUI_Graph back, fore, ref;
+
+	Graph_Init( &back );
+	Graph_Init( &fore );
+	Graph_Init( &ref );
+	back.color_type = COLOR_TYPE_ARGB;
+	fore.color_type = COLOR_TYPE_ARGB;
+	Graph_Create( &back, TEST_SIZE, TEST_SIZE );
+	Graph_Create( &fore, TEST_SIZE, TEST_SIZE );
+	RandomFill( &back, FALSE );
+	RandomFill( &fore, FALSE );
+	Graph_SetColorType( &back, COLOR_TYPE_PARGB );
+	Graph_SetColorType( &fore, COLOR_TYPE_PARGB );
+	fore.opacity = opacity;
+	Graph_Copy( &ref, &back );
+	Graph_Mix( &back, &fore, 0, 0, TRUE );
+	for( i = 0; i < TEST_SIZE * TEST_SIZE; ++i ) {
+		px = ref.argb[i];
+		MixPixelOverPM( &px, &fore.argb[i], opacity );
+		if( !ComparePixel( &px, &back.argb[i] ) ) {
+			ret = -1;
+			break;
+		}
+	}
+	Graph_Free( &back );
+	Graph_Free( &fore );
+	Graph_Free( &ref );
+	return ret;
+}
+
+static int test_mix( void )
+{
+	int i;
+	float opacity[3] = { 1.0f, 0.5f, 0.13f };
+	for( i = 0; i < 3; ++i ) {
+		assert( test_mix_argb( opacity[i], TRUE, FALSE ) == 0 );
+		assert( test_mix_argb( opacity[i], TRUE, TRUE ) == 0 );
+		assert( test_mix_argb( opacity[i], FALSE, FALSE ) == 0 );
+		assert( test_mix_rgb( opacity[i] ) == 0 );
+		assert( test_mix_pargb( opacity[i] ) == 0 );
+	}
+	return 0;
+}
+
+int test_graph_mix( void )
+{
+	int ret;
+	_DEBUG_MSG( "test generic pixel mixer...\n" );
+	ret = test_mix();
+	LCUI_InitGraph();
+	_DEBUG_MSG( "test pixel mixer selected by LCUI_InitGraph()...\n" );
+	ret |= test_mix();
+	return ret;
+}
@@ -0,0 +1,320 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/timer.h>
+#include <LCUI/display.h>
+#include <LCUI/surface.h>
+#include <LCUI/gui/widget.h>
+#include "test.h"
+
+static int timer_count = 0;
+
+static void OnTimer( void *arg )
+{
+	++timer_count;
+}
+
+/** 运行一帧，与主循环中的流程相同，先处理到期的定时器 */
+static void RunFrame( void )
+{
+	LCUITimer_Process();
+	LCUI_ProcessEvents();
+	LCUIDisplay_Update();
+	LCUIDisplay_Render();
+	LCUIDisplay_Present();
+}
+
+/** 检查帧缓存中的像素颜色，无界面驱动的帧缓存是 RGB 格式 */
+static LCUI_BOOL CheckPixel( LCUI_Graph *fb, int x, int y, LCUI_Color color )
+{
+	uchar_t *px = fb->bytes + fb->bytes_per_row * y + x * 3;
+	return px[0] == color.b && px[1] == color.g && px[2] == color.r;
+}
+
+static void SetPixel( LCUI_Graph *fb, int x, int y, LCUI_Color color )
+{
+	uchar_t *px = fb->bytes + fb->bytes_per_row * y + x * 3;
+	px[0] = color.b;
+	px[1] = color.g;
+	px[2] = color.r;
+}
+
+static LCUI_BOOL IsSameGraph( LCUI_Graph *a, LCUI_Graph *b )
+{
+	return a->width == b->width && a->height == b->height &&
+		memcmp( a->bytes, b->bytes, a->bytes_per_row * a->height ) == 0;
+}
+
+/** 重绘整个屏幕，检查结果是否与当前帧缓存中的内容相同 */
+static LCUI_BOOL CheckRepaint( LCUI_Graph *fb )
+{
+	LCUI_BOOL ret;
+	LCUI_Graph frame;
+	Graph_Init( &frame );
+	Graph_Copy( &frame, fb );
+	Widget_InvalidateArea( LCUIWidget_GetRoot(), NULL, SV_GRAPH_BOX );
+	RunFrame();
+	ret = IsSameGraph( &frame, fb );
+	Graph_Free( &frame );
+	return ret;
+}
+
+/** 通过平移像素滚动内容层，结果应该与重绘整个屏幕的结果相同 */
+static int test_headless_scroll( void )
+{
+	int i;
+	LCUI_Graph *fb;
+	LCUI_Widget root, view, layer, w;
+	LCUI_Color marker = RGB( 255, 0, 255 );
+
+	root = LCUIWidget_GetRoot();
+	view = LCUIWidget_New( NULL );
+	layer = LCUIWidget_New( NULL );
+	Widget_SetStyle( view, key_position, SV_ABSOLUTE, style );
+	Widget_SetStyle( view, key_background_color,
+			 RGB( 255, 255, 255 ), color );
+	Widget_Move( view, 20, 60 );
+	Widget_Resize( view, 100, 80 );
+	Widget_SetStyle( layer, key_position, SV_ABSOLUTE, style );
+	Widget_SetStyle( layer, key_left, 0.1f, scale );
+	Widget_SetStyle( layer, key_background_color,
+			 RGB( 200, 200, 200 ), color );
+	Widget_Resize( layer, 80, 300 );
+	for( i = 0; i < 10; ++i ) {
+		w = LCUIWidget_New( NULL );
+		Widget_Resize( w, 60 - i * 4, 30 );
+		Widget_SetStyle( w, key_background_color,
+				 RGB( i * 25, 255 - i * 25, 100 ), color );
+		Widget_Append( layer, w );
+	}
+	Widget_Append( view, layer );
+	Widget_Append( root, view );
+	RunFrame();
+	fb = Surface_GetHandle( LCUIDisplay_GetSurfaceOwner( view ) );
+	assert( CheckRepaint( fb ) );
+	/* 已绘制的像素被直接平移，而不是重绘 */
+	SetPixel( fb, 100, 110, marker );
+	Widget_ScrollTop( layer, -20 );
+	RunFrame();
+	assert( CheckPixel( fb, 100, 90, marker ) );
+	assert( !CheckRepaint( fb ) );
+	assert( !CheckPixel( fb, 100, 90, marker ) );
+	/* 只修改了滚动方向上的定位，左边距仍然按百分比计算 */
+	assert( !layer->custom_style->sheet[key_left].is_valid ||
+		layer->custom_style->sheet[key_left].type == SVT_SCALE );
+	assert( layer->computed_style.left == 10 );
+	Widget_ScrollTop( layer, -47 );
+	RunFrame();
+	assert( CheckRepaint( fb ) );
+	Widget_ScrollTop( layer, -13 );
+	RunFrame();
+	assert( CheckRepaint( fb ) );
+	Widget_Resize( view, 120, 80 );
+	RunFrame();
+	assert( layer->computed_style.left == 12 );
+	assert( layer->computed_style.top == -13 );
+	assert( CheckRepaint( fb ) );
+	Widget_ScrollLeft( layer, 25 );
+	RunFrame();
+	assert( layer->computed_style.top == -13 );
+	assert( CheckRepaint( fb ) );
+	Widget_Destroy( view );
+	RunFrame();
+	return 0;
+}
+
+/**
+ * 每一步只修改部分部件的背景色，使每帧只有部分区域需要重绘，奇数步还会滚动
+ * 容器，滚动是直接平移已绘制的像素，能检查出后台缓冲中的内容是否完整
+ */
+static void RunStep( LCUI_Widget box, LCUI_Widget *widgets, int step )
+{
+	int i;
+	for( i = step % 3; i < 12; i += 3 ) {
+		Widget_SetStyle( widgets[i], key_background_color,
+				 RGB( step * 40, 255 - i * 20, i * 20 ), color );
+		Widget_UpdateStyle( widgets[i], FALSE );
+	}
+	if( step % 2 == 1 ) {
+		Widget_ScrollTop( box, 20.0f + step * 3 );
+	}
+	RunFrame();
+}
+
+/** 以流水线模式和直接模式渲染同一个部件树，两者的结果应该相同 */
+static int test_headless_pipeline( void )
+{
+	int i;
+	LCUI_Graph *fb, frame;
+	LCUI_Widget root, box, widgets[12];
+
+	root = LCUIWidget_GetRoot();
+	box = LCUIWidget_New( NULL );
+	Widget_SetStyle( box, key_position, SV_ABSOLUTE, style );
+	Widget_SetStyle( box, key_background_color,
+			 RGB( 255, 255, 255 ), color );
+	Widget_Move( box, 30, 20 );
+	Widget_Resize( box, 200, 120 );
+	for( i = 0; i < 12; ++i ) {
+		widgets[i] = LCUIWidget_New( NULL );
+		Widget_SetStyle( widgets[i], key_position, SV_ABSOLUTE, style );
+		Widget_Move( widgets[i], (i % 4) * 45, (i / 4) * 35 );
+		Widget_Resize( widgets[i], 60, 50 );
+		Widget_Append( box, widgets[i] );
+	}
+	Widget_Append( root, box );
+	RunStep( box, widgets, 0 );
+	fb = Surface_GetHandle( LCUIDisplay_GetSurfaceOwner( box ) );
+	for( i = 1; i < 6; ++i ) {
+		RunStep( box, widgets, i );
+	}
+	Graph_Init( &frame );
+	Graph_Copy( &frame, fb );
+	/* 改回其它颜色和位置后，以流水线模式再执行一遍相同的步骤 */
+	RunStep( box, widgets, 0 );
+	RunStep( box, widgets, 2 );
+	RunStep( box, widgets, 4 );
+	Widget_ScrollTop( box, 20 );
+	RunFrame();
+	assert( !IsSameGraph( &frame, fb ) );
+	LCUIDisplay_SetPipelined( TRUE );
+	assert( LCUIDisplay_IsPipelined() );
+	for( i = 1; i < 6; ++i ) {
+		RunStep( box, widgets, i );
+	}
+	/* 停用时会等待显示线程呈现完已提交的帧 */
+	LCUIDisplay_SetPipelined( FALSE );
+	assert( IsSameGraph( &frame, fb ) );
+	Graph_Free( &frame );
+	Widget_Destroy( box );
+	RunFrame();
+	return 0;
+}
+
+/** 以单线程和多线程分块渲染同一个部件树，两者的结果应该相同 */
+static int test_headless_tiles( void )
+{
+	int i;
+	LCUI_Rect rect;
+	LCUI_Graph *fb, frame;
+	LCUI_Widget root, box, w;
+	LCUI_Rect rects[] = {
+		{ 3, 5, 20, 10 }, { 60, 60, 9, 9 }, { 120, 2, 90, 30 },
+		{ 200, 150, 17, 80 }, { 330, 70, 40, 40 }
+	};
+
+	root = LCUIWidget_GetRoot();
+	box = LCUIWidget_New( NULL );
+	Widget_SetStyle( box, key_position, SV_ABSOLUTE, style );
+	Widget_SetStyle( box, key_background_color,
+			 RGB( 240, 240, 240 ), color );
+	Widget_Move( box, 13, 7 );
+	Widget_Resize( box, 400, 260 );
+	/* 部件跨越图块的边界，其中一部分是半透明的 */
+	for( i = 0; i < 24; ++i ) {
+		w = LCUIWidget_New( NULL );
+		Widget_SetStyle( w, key_position, SV_ABSOLUTE, style );
+		Widget_SetStyle( w, key_background_color,
+				 ARGB( i % 3 ? 255 : 128, i * 10,
+				       200 - i * 8, 50 + i * 5 ), color );
+		Widget_SetBorder( w, 2, SV_SOLID, RGB( 0, 0, 0 ) );
+		Widget_Move( w, (i % 6) * 61 + 5, (i / 6) * 57 + 9 );
+		Widget_Resize( w, 70 + i, 50 + i % 5 * 7 );
+		Widget_Append( box, w );
+	}
+	Widget_Append( root, box );
+	LCUIDisplay_SetRenderThreads( 1 );
+	RunFrame();
+	fb = Surface_GetHandle( LCUIDisplay_GetSurfaceOwner( box ) );
+	Graph_Init( &frame );
+	Graph_Copy( &frame, fb );
+	/* 先涂掉帧缓存中的内容，漏画的像素会保留这个颜色 */
+	LCUIDisplay_SetRenderThreads( 4 );
+	Graph_FillRect( fb, RGB( 255, 0, 255 ), NULL, FALSE );
+	Widget_InvalidateArea( root, NULL, SV_GRAPH_BOX );
+	RunFrame();
+	assert( IsSameGraph( &frame, fb ) );
+	/* 分散的小块脏区域 */
+	for( i = 0; i < 5; ++i ) {
+		rect = rects[i];
+		rect.x += 13;
+		rect.y += 7;
+		Graph_FillRect( fb, RGB( 255, 0, 255 ), &rect, FALSE );
+		Widget_InvalidateArea( box, &rects[i], SV_GRAPH_BOX );
+	}
+	RunFrame();
+	assert( IsSameGraph( &frame, fb ) );
+	LCUIDisplay_SetRenderThreads( 1 );
+	Graph_Free( &frame );
+	Widget_Destroy( box );
+	RunFrame();
+	return 0;
+}
+
+int test_headless( void )
+{
+	int timer_id;
+	LCUI_Graph *fb;
+	LCUI_Widget root, w;
+	LCUI_Surface surface;
+	unsigned int frame_count;
+
+	root = LCUIWidget_GetRoot();
+	w = LCUIWidget_New( NULL );
+	Widget_SetStyle( w, key_background_color, RGB( 255, 0, 0 ), color );
+	Widget_SetStyle( w, key_position, SV_ABSOLUTE, style );
+	Widget_Move( w, 10, 10 );
+	Widget_Resize( w, 40, 30 );
+	Widget_Append( root, w );
+	frame_count = LCUIHeadless_GetFrameCount();
+	RunFrame();
+	assert( LCUIHeadless_GetFrameCount() > frame_count );
+	surface = LCUIDisplay_GetSurfaceOwner( w );
+	assert( surface != NULL );
+	fb = Surface_GetHandle( surface );
+	assert( Graph_IsValid( fb ) );
+	assert( CheckPixel( fb, 10, 10, RGB( 255, 0, 0 ) ) );
+	assert( CheckPixel( fb, 49, 39, RGB( 255, 0, 0 ) ) );
+	assert( !CheckPixel( fb, 50, 40, RGB( 255, 0, 0 ) ) );
+	assert( !CheckPixel( fb, 9, 9, RGB( 255, 0, 0 ) ) );
+	/* 没有需要更新的内容时，不会呈现新的帧 */
+	frame_count = LCUIHeadless_GetFrameCount();
+	RunFrame();
+	assert( LCUIHeadless_GetFrameCount() == frame_count );
+	/* 只有重绘的区域会改变 */
+	Widget_SetStyle( w, key_background_color, RGB( 0, 0, 255 ), color );
+	Widget_UpdateStyle( w, FALSE );
+	RunFrame();
+	assert( LCUIHeadless_GetFrameCount() == frame_count + 1 );
+	assert( CheckPixel( fb, 10, 10, RGB( 0, 0, 255 ) ) );
+	assert( !CheckPixel( fb, 9, 9, RGB( 0, 0, 255 ) ) );
+	Widget_Destroy( w );
+	RunFrame();
+	assert( !CheckPixel( fb, 10, 10, RGB( 0, 0, 255 ) ) );
+
+	/* 启用虚拟时钟之前设置的定时器，剩余时间不会因切换时钟而改变 */
+	LCUITime_SetVirtualClock( FALSE );
+	timer_id = LCUITimer_Set( 100, OnTimer, NULL, FALSE );
+	LCUITime_SetVirtualClock( TRUE );
+	assert( timer_id > 0 );
+	LCUITime_Advance( 50 );
+	RunFrame();
+	assert( timer_count == 0 );
+	LCUITime_Advance( 50 );
+	RunFrame();
+	assert( timer_count == 1 );
+	/* 虚拟时钟下的定时器只随时间推进而触发 */
+	LCUITimer_Set( 30, OnTimer, NULL, FALSE );
+	RunFrame();
+	assert( timer_count == 1 );
+	LCUITime_Advance( 30 );
+	RunFrame();
+	assert( timer_count == 2 );
+	if( test_headless_pipeline() != 0 ||
+	    test_headless_tiles() != 0 ) {
+		return -1;
+	}
+	return test_headless_scroll();
+}
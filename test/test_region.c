@@ -0,0 +1,231 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include "test.h"
+
+#define MAP_SIZE 64
+
+static void FillMap( char *map, const LCUI_Rect *rect, char value )
+{
+	int x, y;
+	for( y = rect->y; y < rect->y + rect->height; ++y ) {
+		for( x = rect->x; x < rect->x + rect->width; ++x ) {
+			map[y * MAP_SIZE + x] = value;
+		}
+	}
+}
+
+/** 检查区域是否符合分带规则，且与参考位图覆盖的像素一致 */
+static int CheckRegion( LCUI_Region region, const char *map )
+{
+	int i;
+	char buf[MAP_SIZE * MAP_SIZE];
+	LCUI_Rect *prev = NULL, *rect;
+
+	memset( buf, 0, sizeof( buf ) );
+	for( i = 0; i < region->length; ++i ) {
+		rect = &region->rects[i];
+		if( rect->width <= 0 || rect->height <= 0 ) {
+			return -1;
+		}
+		if( prev && prev->y == rect->y ) {
+			if( prev->height != rect->height ||
+			    prev->x + prev->width >= rect->x ) {
+				return -2;
+			}
+		} else if( prev && prev->y + prev->height > rect->y ) {
+			return -3;
+		}
+		FillMap( buf, rect, 1 );
+		prev = rect;
+	}
+	if( memcmp( buf, map, sizeof( buf ) ) != 0 ) {
+		return -4;
+	}
+	return 0;
+}
+
+static LCUI_BOOL IsMapCovered( const char *map, const LCUI_Rect *rect )
+{
+	int x, y;
+	for( y = rect->y; y < rect->y + rect->height; ++y ) {
+		for( x = rect->x; x < rect->x + rect->width; ++x ) {
+			if( !map[y * MAP_SIZE + x] ) {
+				return FALSE;
+			}
+		}
+	}
+	return TRUE;
+}
+
+static LCUI_BOOL IsMapOverlapped( const char *map, const LCUI_Rect *rect )
+{
+	int x, y;
+	for( y = rect->y; y < rect->y + rect->height; ++y ) {
+		for( x = rect->x; x < rect->x + rect->width; ++x ) {
+			if( map[y * MAP_SIZE + x] ) {
+				return TRUE;
+			}
+		}
+	}
+	return FALSE;
+}
+
+static void RandomRect( LCUI_Rect *rect )
+{
+	rect->x = rand() % (MAP_SIZE - 1);
+	rect->y = rand() % (MAP_SIZE - 1);
+	rect->width = 1 + rand() % (MAP_SIZE - rect->x);
+	rect->height = 1 + rand() % (MAP_SIZE - rect->y);
+	if( rect->x + rect->width > MAP_SIZE ) {
+		rect->width = MAP_SIZE - rect->x;
+	}
+	if( rect->y + rect->height > MAP_SIZE ) {
+		rect->height = MAP_SIZE - rect->y;
+	}
+}
+
+/** 生成随机区域，同时在位图中标记它覆盖的像素 */
+static void RandomRegion( LCUI_Region region, char *map )
+{
+	int i;
+	LCUI_Rect rect;
+	Region_Clear( region );
+	memset( map, 0, MAP_SIZE * MAP_SIZE );
+	for( i = 0; i < 8; ++i ) {
+		RandomRect( &rect );
+		Region_UnionRect( region, &rect );
+		FillMap( map, &rect, 1 );
+	}
+}
+
+/**
+ * 测试两个区域间的运算，结果区域可以是其中一个操作数，也可以是另一个区域
+ * 反复运算后，区域中的矩形数组应该被复用而不是重新分配
+ */
+static int test_region_op( void )
+{
+	int i, j, ret = 0;
+	LCUI_Rect rect, *rects[2];
+	LCUI_RegionRec a, b, out;
+	char map_a[MAP_SIZE * MAP_SIZE];
+	char map_b[MAP_SIZE * MAP_SIZE];
+	char map[MAP_SIZE * MAP_SIZE];
+
+	Region_Init( &a );
+	Region_Init( &b );
+	Region_Init( &out );
+	for( i = 0; i < 200 && ret == 0; ++i ) {
+		RandomRegion( &a, map_a );
+		RandomRegion( &b, map_b );
+		for( j = 0; j < MAP_SIZE * MAP_SIZE; ++j ) {
+			map[j] = map_a[j] && !map_b[j];
+		}
+		Region_Subtract( &out, &a, &b );
+		ret = CheckRegion( &out, map );
+		for( j = 0; ret == 0 && j < MAP_SIZE * MAP_SIZE; ++j ) {
+			map[j] = map_a[j] || map_b[j];
+		}
+		if( ret == 0 ) {
+			Region_Union( &out, &a, &b );
+			ret = CheckRegion( &out, map );
+		}
+		if( ret == 0 ) {
+			Region_Union( &b, &a, &b );
+			ret = CheckRegion( &b, map );
+		}
+		for( j = 0; ret == 0 && j < MAP_SIZE * MAP_SIZE; ++j ) {
+			map[j] = map_a[j] && !map[j];
+		}
+		if( ret == 0 ) {
+			Region_Subtract( &a, &a, &b );
+			ret = CheckRegion( &a, map );
+		}
+	}
+	RandomRegion( &a, map_a );
+	rect.x = rect.y = MAP_SIZE / 4;
+	rect.width = rect.height = MAP_SIZE / 2;
+	Region_SubtractRect( &a, &rect );
+	Region_UnionRect( &a, &rect );
+	rects[0] = a.rects;
+	rects[1] = a.spare;
+	/* 以自身为操作数时，原来的矩形数组被保留为备用 */
+	if( !rects[0] || !rects[1] ) {
+		ret = -7;
+	}
+	for( i = 0; i < 100 && ret == 0; ++i ) {
+		Region_SubtractRect( &a, &rect );
+		Region_UnionRect( &a, &rect );
+		if( (a.rects != rects[0] || a.spare != rects[1]) &&
+		    (a.rects != rects[1] || a.spare != rects[0]) ) {
+			ret = -7;
+		}
+	}
+	Region_Destroy( &a );
+	Region_Destroy( &b );
+	Region_Destroy( &out );
+	return ret;
+}
+
+int test_region( void )
+{
+	int i, j, ret = 0;
+	LCUI_Rect rect;
+	LCUI_RegionRec region, part;
+	char map[MAP_SIZE * MAP_SIZE];
+
+	Region_Init( &region );
+	Region_Init( &part );
+	for( i = 0; i < 200 && ret == 0; ++i ) {
+		Region_Clear( &region );
+		memset( map, 0, sizeof( map ) );
+		for( j = 0; j < 20 && ret == 0; ++j ) {
+			RandomRect( &rect );
+			switch( rand() % 4 ) {
+			case 0:
+				Region_SubtractRect( &region, &rect );
+				FillMap( map, &rect, 0 );
+				break;
+			default:
+				Region_UnionRect( &region, &rect );
+				FillMap( map, &rect, 1 );
+				break;
+			}
+			ret = CheckRegion( &region, map );
+		}
+		RandomRect( &rect );
+		if( ret == 0 && Region_ContainsRect( &region, &rect ) !=
+		    IsMapCovered( map, &rect ) ) {
+			ret = -5;
+		}
+		if( ret == 0 && Region_OverlapsRect( &region, &rect ) !=
+		    IsMapOverlapped( map, &rect ) ) {
+			ret = -6;
+		}
+		RandomRect( &rect );
+		if( ret == 0 ) {
+			char tmp[MAP_SIZE * MAP_SIZE];
+			memset( tmp, 0, sizeof( tmp ) );
+			FillMap( tmp, &rect, 1 );
+			for( j = 0; j < MAP_SIZE * MAP_SIZE; ++j ) {
+				map[j] = map[j] && tmp[j];
+			}
+			/* 两种求交集的方式结果应该相同 */
+			Region_IntersectWithRect( &part, &region, &rect );
+			ret = CheckRegion( &part, map );
+			if( ret == 0 ) {
+				Region_IntersectRect( &region, &rect );
+				ret = CheckRegion( &region, map );
+			}
+		}
+	}
+	Region_Destroy( &region );
+	Region_Destroy( &part );
+	if( ret == 0 ) {
+		ret = test_region_op();
+	}
+	_DEBUG_MSG( "test region: %d\n", ret );
+	return ret;
+}
@@ -0,0 +1,96 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
+#include <LCUI/util/atomic.h>
+#include "test.h"
+
+#define N_PRODUCERS	4
+/** 每个线程提交的任务数，远多于节点池的容量，以便覆盖动态分配节点的情况 */
+#define N_TASKS		20000
+
+static struct TaskQueueTest {
+	long next[N_PRODUCERS];		/**< 各个线程下一个应该执行的任务序号 */
+	long errors;			/**< 执行顺序错误的次数 */
+	volatile long n_done;		/**< 已提交完任务的线程数量 */
+} self;
+
+static void OnTask( void *arg1, void *arg2 )
+{
+	long id = (long)arg1, seq = (long)arg2;
+	if( self.next[id] != seq ) {
+		++self.errors;
+	}
+	self.next[id] = seq + 1;
+}
+
+static void ProducerThread( void *arg )
+{
+	long i;
+	LCUI_AppTaskRec task = { 0 };
+	task.func = OnTask;
+	task.arg[0] = arg;
+	for( i = 0; i < N_TASKS; ++i ) {
+		task.arg[1] = (void*)i;
+		LCUI_PostTask( &task );
+	}
+	LCUI_AtomicAdd( &self.n_done, 1 );
+	LCUIThread_Exit( NULL );
+}
+
+/** 检查是否所有任务都已执行 */
+static LCUI_BOOL IsAllTasksDone( void )
+{
+	int i;
+	if( LCUI_AtomicLoad( &self.n_done ) < N_PRODUCERS ) {
+		return FALSE;
+	}
+	for( i = 0; i < N_PRODUCERS; ++i ) {
+		if( self.next[i] < N_TASKS ) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+int test_taskqueue( void )
+{
+	long i;
+	LCUI_AppTaskRec task = { 0 };
+	LCUI_Thread threads[N_PRODUCERS];
+
+	memset( &self, 0, sizeof( self ) );
+	/* 多个线程同时提交任务，主线程同时处理任务 */
+	for( i = 0; i < N_PRODUCERS; ++i ) {
+		LCUIThread_Create( &threads[i], ProducerThread, (void*)i );
+	}
+	while( !IsAllTasksDone() ) {
+		LCUI_ProcessEvents();
+	}
+	for( i = 0; i < N_PRODUCERS; ++i ) {
+		LCUIThread_Join( threads[i], NULL );
+	}
+	/* 同一线程提交的任务须按提交顺序执行，且每个任务只执行一次 */
+	assert( self.errors == 0 );
+	for( i = 0; i < N_PRODUCERS; ++i ) {
+		assert( self.next[i] == N_TASKS );
+	}
+	/* 队列为空后再提交的任务仍能被取出 */
+	task.func = OnTask;
+	task.arg[0] = (void*)0;
+	task.arg[1] = (void*)N_TASKS;
+	LCUI_PostTask( &task );
+	LCUI_ProcessEvents();
+	assert( self.next[0] == N_TASKS + 1 );
+	/* 暂停任务代理后，提交的任务交给驱动处理，驱动不支持时仍使用任务队列 */
+	LCUI_SetTaskAgent( FALSE );
+	task.arg[1] = (void*)(N_TASKS + 1);
+	LCUI_PostTask( &task );
+	LCUI_ProcessEvents();
+	LCUI_SetTaskAgent( TRUE );
+	assert( self.next[0] == N_TASKS + 2 );
+	assert( self.errors == 0 );
+	return 0;
+}
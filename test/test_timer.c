@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/timer.h>
+#include "test.h"
+
+#define MAX_RECORDS 32
+
+/** 定时器回调的执行记录 */
+static struct TimerTestRecord {
+	int count;
+	long values[MAX_RECORDS];
+	int victim_id;		/**< 要在回调中释放的定时器 */
+	int reset_id;		/**< 要在回调中重设的定时器 */
+} record;
+
+static void OnTimer( void *arg )
+{
+	if( record.count < MAX_RECORDS ) {
+		record.values[record.count++] = (long)arg;
+	}
+}
+
+/** 在回调中释放和重设同一批到期的其它定时器 */
+static void OnFreeOthers( void *arg )
+{
+	OnTimer( arg );
+	LCUITimer_Free( record.victim_id );
+	LCUITimer_Reset( record.reset_id, 20 );
+}
+
+static void ClearRecord( void )
+{
+	memset( &record, 0, sizeof( record ) );
+}
+
+/** 推进虚拟时钟并处理到期的定时器，返回执行的回调数量 */
+static size_t Advance( unsigned int ms )
+{
+	LCUITime_Advance( ms );
+	return LCUITimer_Process();
+}
+
+static int test_timer_order( void )
+{
+	ClearRecord();
+	LCUITimer_Set( 30, OnTimer, (void*)1, FALSE );
+	LCUITimer_Set( 10, OnTimer, (void*)2, FALSE );
+	LCUITimer_Set( 20, OnTimer, (void*)3, FALSE );
+	LCUITimer_Set( 10, OnTimer, (void*)4, FALSE );
+	assert( Advance( 9 ) == 0 );
+	/* 同一批到期的定时器按到期时间执行，同时到期的按创建顺序执行 */
+	assert( Advance( 21 ) == 4 );
+	assert( record.count == 4 );
+	assert( record.values[0] == 2 && record.values[1] == 4 );
+	assert( record.values[2] == 3 && record.values[3] == 1 );
+	assert( Advance( 100 ) == 0 );
+	return 0;
+}
+
+static int test_timer_repeat( void )
+{
+	int id;
+	ClearRecord();
+	id = LCUITimer_Set( 10, OnTimer, (void*)1, TRUE );
+	assert( Advance( 10 ) == 1 );
+	assert( Advance( 5 ) == 0 );
+	assert( Advance( 5 ) == 1 );
+	assert( Advance( 10 ) == 1 );
+	assert( LCUITimer_Free( id ) == 0 );
+	assert( Advance( 10 ) == 0 );
+	assert( record.count == 3 );
+	assert( LCUITimer_Free( id ) == -1 );
+	return 0;
+}
+
+static int test_timer_pause( void )
+{
+	int id;
+	ClearRecord();
+	id = LCUITimer_Set( 20, OnTimer, (void*)1, FALSE );
+	assert( Advance( 5 ) == 0 );
+	assert( LCUITimer_Pause( id ) == 0 );
+	/* 暂停期间不会到期，继续后按剩余时间计时 */
+	assert( Advance( 100 ) == 0 );
+	assert( LCUITimer_Continue( id ) == 0 );
+	assert( Advance( 14 ) == 0 );
+	assert( Advance( 1 ) == 1 );
+	assert( record.count == 1 );
+	/* 已经触发的一次性定时器会被释放 */
+	assert( LCUITimer_Pause( id ) == -1 );
+	return 0;
+}
+
+static int test_timer_reset( void )
+{
+	int id;
+	ClearRecord();
+	id = LCUITimer_Set( 10, OnTimer, (void*)1, FALSE );
+	assert( LCUITimer_Reset( id, 40 ) == 0 );
+	assert( Advance( 10 ) == 0 );
+	assert( Advance( 29 ) == 0 );
+	assert( Advance( 1 ) == 1 );
+	/* 暂停时重设的时间在继续后生效 */
+	id = LCUITimer_Set( 10, OnTimer, (void*)2, FALSE );
+	assert( LCUITimer_Pause( id ) == 0 );
+	assert( LCUITimer_Reset( id, 30 ) == 0 );
+	assert( LCUITimer_Continue( id ) == 0 );
+	assert( Advance( 29 ) == 0 );
+	assert( Advance( 1 ) == 1 );
+	assert( record.count == 2 && record.values[1] == 2 );
+	return 0;
+}
+
+static int test_timer_batch( void )
+{
+	ClearRecord();
+	LCUITimer_Set( 10, OnFreeOthers, (void*)1, FALSE );
+	record.victim_id = LCUITimer_Set( 10, OnTimer, (void*)2, FALSE );
+	record.reset_id = LCUITimer_Set( 10, OnTimer, (void*)3, FALSE );
+	/* 在同一批中被释放或重设的定时器，它的回调不会在这一批中执行 */
+	assert( Advance( 10 ) == 1 );
+	assert( record.count == 1 && record.values[0] == 1 );
+	assert( LCUITimer_Free( record.victim_id ) == -1 );
+	assert( Advance( 19 ) == 0 );
+	assert( Advance( 1 ) == 1 );
+	assert( record.count == 2 && record.values[1] == 3 );
+	return 0;
+}
+
+int test_timer( void )
+{
+	int ret = 0;
+	LCUI_BOOL is_virtual_clock = LCUITime_IsVirtualClock();
+	/* 使用虚拟时钟，让定时器只在推进时间时到期 */
+	LCUITime_SetVirtualClock( TRUE );
+	ret |= test_timer_order();
+	ret |= test_timer_repeat();
+	ret |= test_timer_pause();
+	ret |= test_timer_reset();
+	ret |= test_timer_batch();
+	LCUITime_SetVirtualClock( is_virtual_clock );
+	return ret;
+}
@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/thread.h>
+#include <LCUI/trace.h>
+#include <LCUI/util/atomic.h>
+#include "test.h"
+
+#define TRACE_FILE	"test_trace.json"
+#define N_THREADS	2
+#define MAX_TIDS	16
+#define SPAN_DEPTH	3
+/** 每个线程记录的嵌套时间段组数，事件数量超过一个缓冲块的容量 */
+#define N_SPANS		1500
+
+static struct TraceTest {
+	int depth[MAX_TIDS];		/**< 各个线程当前的嵌套深度 */
+	int events[MAX_TIDS];		/**< 各个线程的事件数量 */
+	int dropped;			/**< 被丢弃的事件数量 */
+	int errors;			/**< 格式错误或嵌套顺序错误的次数 */
+	volatile long n_done;		/**< 已记录完事件的线程数量 */
+} self;
+
+static void RecordSpans( int depth )
+{
+	char name[16];
+	sprintf( name, "span%d", depth );
+	LCUITrace_Begin( "test", name );
+	if( depth + 1 < SPAN_DEPTH ) {
+		RecordSpans( depth + 1 );
+	}
+	LCUITrace_End( "test", name );
+}
+
+static void TraceThread( void *arg )
+{
+	int i;
+	for( i = 0; i < N_SPANS; ++i ) {
+		RecordSpans( 0 );
+	}
+	LCUI_AtomicAdd( &self.n_done, 1 );
+	LCUIThread_Exit( NULL );
+}
+
+/**
+ * 检查导出的事件，每个线程的 B 和 E 事件需要按嵌套顺序成对出现
+ * 一个时间段的开始和结束可能被分别写入前后两个文件，所以深度是跨文件累计的
+ */
+static int CheckTraceFile( const char *filepath )
+{
+	FILE *fp;
+	int tid, depth, n = 0;
+	unsigned long dropped;
+	char line[256], phase, *p;
+
+	fp = fopen( filepath, "r" );
+	if( !fp ) {
+		return -1;
+	}
+	while( fgets( line, sizeof( line ), fp ) ) {
+		p = strstr( line, "\"ph\":\"" );
+		if( !p ) {
+			continue;
+		}
+		phase = p[6];
+		p = strstr( line, "\"tid\":" );
+		if( !p || sscanf( p + 6, "%d", &tid ) != 1 ||
+		    tid < 0 || tid >= MAX_TIDS ) {
+			++self.errors;
+			continue;
+		}
+		if( phase == 'M' ) {
+			p = strstr( line, "\"dropped\":" );
+			if( !p || sscanf( p + 10, "%lu", &dropped ) != 1 ) {
+				++self.errors;
+			} else {
+				self.dropped += (int)dropped;
+			}
+			continue;
+		}
+		p = strstr( line, "\"name\":\"span" );
+		if( !p || sscanf( p + 12, "%d", &depth ) != 1 ) {
+			++self.errors;
+			continue;
+		}
+		if( phase == 'B' ) {
+			if( depth != self.depth[tid] ) {
+				++self.errors;
+			}
+			self.depth[tid] += 1;
+		} else if( phase == 'E' ) {
+			self.depth[tid] -= 1;
+			if( depth != self.depth[tid] ) {
+				++self.errors;
+			}
+		} else {
+			++self.errors;
+		}
+		self.events[tid] += 1;
+		++n;
+	}
+	fclose( fp );
+	remove( filepath );
+	return n;
+}
+
+int test_trace( void )
+{
+	int i, n, count;
+	LCUI_Thread threads[N_THREADS];
+
+	memset( &self, 0, sizeof( self ) );
+	/* 未启用时不会记录事件 */
+	LCUITrace_Enable( FALSE );
+	LCUITrace_Begin( "test", "disabled" );
+	LCUITrace_End( "test", "disabled" );
+	assert( LCUITrace_Flush( TRACE_FILE ) == 0 );
+	assert( CheckTraceFile( TRACE_FILE ) == 0 );
+	LCUITrace_Enable( TRUE );
+	for( i = 0; i < N_THREADS; ++i ) {
+		LCUIThread_Create( &threads[i], TraceThread, NULL );
+	}
+	/* 在记录的同时导出，已导出的事件不会再次导出 */
+	count = LCUITrace_Flush( TRACE_FILE );
+	n = CheckTraceFile( TRACE_FILE );
+	assert( count >= 0 && n == count );
+	for( i = 0; i < N_THREADS; ++i ) {
+		LCUIThread_Join( threads[i], NULL );
+	}
+	assert( self.n_done == N_THREADS );
+	n = LCUITrace_Flush( TRACE_FILE );
+	assert( CheckTraceFile( TRACE_FILE ) == n );
+	count += n;
+	LCUITrace_Enable( FALSE );
+	assert( self.errors == 0 );
+	assert( self.dropped == 0 );
+	assert( count == N_THREADS * N_SPANS * SPAN_DEPTH * 2 );
+	/* 每个线程的事件都完整地导出了，并且嵌套层次是平衡的 */
+	for( n = 0, i = 0; i < MAX_TIDS; ++i ) {
+		assert( self.depth[i] == 0 );
+		if( self.events[i] > 0 ) {
+			assert( self.events[i] == N_SPANS * SPAN_DEPTH * 2 );
+			++n;
+		}
+	}
+	assert( n == N_THREADS );
+	assert( LCUITrace_Flush( TRACE_FILE ) == 0 );
+	assert( CheckTraceFile( TRACE_FILE ) == 0 );
+	return 0;
+}
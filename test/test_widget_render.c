@@ -4,6 +4,337 @@
 #include <LCUI/image.h>
 #include <LCUI/gui/widget.h>
 #include <LCUI/gui/widget/textview.h>
+#include "test.h"
+
+#define TREE_WIDTH	120
+#define TREE_HEIGHT	90
+
+/** 用于对比渲染结果的部件树 */
+typedef struct TestTreeRec_ {
+	LCUI_Widget root, box, child;
+	LCUI_Graph canvas;
+} TestTreeRec, *TestTree;
+
+static void TestTree_Init( TestTree tree, LCUI_BOOL with_layer )
+{
+	LCUI_Widget w;
+	tree->root = LCUIWidget_New( NULL );
+	tree->box = LCUIWidget_New( NULL );
+	tree->child = LCUIWidget_New( NULL );
+	w = LCUIWidget_New( NULL );
+	Widget_Resize( tree->root, TREE_WIDTH, TREE_HEIGHT );
+	Widget_SetStyle( tree->root, key_background_color,
+			 RGB( 240, 240, 240 ), color );
+	Widget_Resize( tree->box, 100, 70 );
+	Widget_SetPadding( tree->box, 5, 5, 5, 5 );
+	Widget_SetBorder( tree->box, 2, SV_SOLID, RGB( 0, 0, 0 ) );
+	Widget_SetStyle( tree->box, key_background_color,
+			 RGB( 0, 122, 204 ), color );
+	Widget_SetStyle( tree->box, key_opacity, 0.6f, scale );
+	if( with_layer ) {
+		Widget_SetStyle( tree->box, key_will_change,
+				 SV_OPACITY, style );
+	}
+	Widget_Resize( tree->child, 40, 30 );
+	Widget_SetStyle( tree->child, key_background_color,
+			 ARGB( 128, 255, 0, 0 ), color );
+	Widget_Resize( w, 30, 20 );
+	Widget_SetStyle( w, key_background_color, RGB( 0, 255, 0 ), color );
+	Widget_Append( tree->box, tree->child );
+	Widget_Append( tree->box, w );
+	Widget_Append( tree->root, tree->box );
+	Widget_UpdateStyle( tree->root, TRUE );
+	Widget_Update( tree->root );
+	Graph_Init( &tree->canvas );
+	tree->canvas.color_type = COLOR_TYPE_ARGB;
+	Graph_Create( &tree->canvas, TREE_WIDTH, TREE_HEIGHT );
+}
+
+static void TestTree_Destroy( TestTree tree )
+{
+	Widget_Destroy( tree->root );
+	Graph_Free( &tree->canvas );
+}
+
+/** 与显示模块的流程相同，先处理无效区域以刷新图层，再渲染整个部件树 */
+static void TestTree_Render( TestTree tree )
+{
+	LCUI_RegionRec region;
+	LCUI_PaintContextRec paint;
+	Widget_Update( tree->root );
+	Region_Init( &region );
+	Widget_ProcInvalidArea( tree->root, &region );
+	Region_Destroy( &region );
+	paint.with_alpha = FALSE;
+	paint.arena = NULL;
+	paint.region = NULL;
+	paint.rect.x = paint.rect.y = 0;
+	paint.rect.width = TREE_WIDTH;
+	paint.rect.height = TREE_HEIGHT;
+	Graph_FillRect( &tree->canvas, RGB( 255, 255, 255 ), NULL, FALSE );
+	Graph_Quote( &paint.canvas, &tree->canvas, &paint.rect );
+	Widget_Render( tree->root, &paint );
+}
+
+static LCUI_BOOL TestTree_Compare( TestTree a, TestTree b )
+{
+	int i;
+	for( i = 0; i < TREE_WIDTH * TREE_HEIGHT; ++i ) {
+		if( a->canvas.argb[i].value != b->canvas.argb[i].value ) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/** 使用图层渲染的结果应该与普通渲染的结果相同 */
+static int test_widget_layer_render( void )
+{
+	TestTreeRec normal, layered;
+
+	TestTree_Init( &normal, FALSE );
+	TestTree_Init( &layered, TRUE );
+	assert( !normal.box->enable_graph );
+	assert( layered.box->enable_graph );
+	TestTree_Render( &normal );
+	TestTree_Render( &layered );
+	assert( TestTree_Compare( &normal, &layered ) );
+	/* 子部件变化后，图层中对应的区域需要重绘 */
+	Widget_SetStyle( normal.child, key_background_color,
+			 ARGB( 200, 255, 255, 0 ), color );
+	Widget_SetStyle( layered.child, key_background_color,
+			 ARGB( 200, 255, 255, 0 ), color );
+	Widget_UpdateStyle( normal.child, FALSE );
+	Widget_UpdateStyle( layered.child, FALSE );
+	TestTree_Render( &normal );
+	TestTree_Render( &layered );
+	assert( Region_IsEmpty( &layered.box->graph_dirty_rects ) );
+	assert( TestTree_Compare( &normal, &layered ) );
+	/* 不透明度变化时只需重新合成图层 */
+	Widget_SetStyle( normal.box, key_opacity, 0.3f, scale );
+	Widget_SetStyle( layered.box, key_opacity, 0.3f, scale );
+	Widget_UpdateStyle( normal.box, FALSE );
+	Widget_UpdateStyle( layered.box, FALSE );
+	TestTree_Render( &normal );
+	TestTree_Render( &layered );
+	assert( TestTree_Compare( &normal, &layered ) );
+	TestTree_Destroy( &normal );
+	TestTree_Destroy( &layered );
+	return 0;
+}
+
+/**
+ * 创建互相重叠的子部件，最上层的部件使用指定的背景色
+ * 每个部件都盖住了下层部件的一整条边，被盖住的部分可以被剔除
+ */
+static LCUI_Widget CreateStackedTree( LCUI_Widget *top, LCUI_Color color )
+{
+	int i;
+	LCUI_Widget root, w = NULL;
+	LCUI_Color colors[3] = {
+		RGB( 255, 0, 0 ), RGB( 0, 160, 0 ), RGB( 0, 0, 255 )
+	};
+	LCUI_Rect rects[4] = {
+		{ 5, 5, 50, 40 }, { 25, 0, 40, 60 },
+		{ 45, 29, 50, 40 }, { 65, 20, 50, 60 }
+	};
+
+	root = LCUIWidget_New( NULL );
+	Widget_Resize( root, TREE_WIDTH, TREE_HEIGHT );
+	Widget_SetStyle( root, key_background_color,
+			 RGB( 240, 240, 240 ), color );
+	for( i = 0; i < 4; ++i ) {
+		w = LCUIWidget_New( NULL );
+		Widget_SetStyle( w, key_position, SV_ABSOLUTE, style );
+		Widget_SetStyle( w, key_background_color,
+				 i < 3 ? colors[i] : color, color );
+		Widget_Move( w, rects[i].x, rects[i].y );
+		Widget_Resize( w, rects[i].width, rects[i].height );
+		if( i == 0 ) {
+			Widget_SetBorder( w, 2, SV_SOLID, RGB( 0, 0, 0 ) );
+		}
+		Widget_Append( root, w );
+	}
+	Widget_UpdateStyle( root, TRUE );
+	Widget_Update( root );
+	*top = w;
+	return root;
+}
+
+static LCUI_Color GetPixel( LCUI_Graph *canvas, int x, int y )
+{
+	return canvas->argb[y * canvas->width + x];
+}
+
+static LCUI_BOOL IsSameCanvas( LCUI_Graph *a, LCUI_Graph *b )
+{
+	int i;
+	for( i = 0; i < TREE_WIDTH * TREE_HEIGHT; ++i ) {
+		if( a->argb[i].value != b->argb[i].value ) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/** 渲染整个部件树 */
+static void RenderAll( LCUI_Widget root, LCUI_Graph *canvas )
+{
+	LCUI_PaintContextRec paint;
+	paint.with_alpha = FALSE;
+	paint.arena = NULL;
+	paint.region = NULL;
+	paint.rect.x = paint.rect.y = 0;
+	paint.rect.width = TREE_WIDTH;
+	paint.rect.height = TREE_HEIGHT;
+	Graph_FillRect( canvas, RGB( 255, 255, 255 ), NULL, FALSE );
+	Graph_Quote( &paint.canvas, canvas, &paint.rect );
+	Widget_Render( root, &paint );
+}
+
+/**
+ * 与显示模块的流程相同，重绘前先用白色填充区域
+ * 部件树的根部件没有白色的像素，漏画的像素会保留白色
+ */
+static void ClearRegion( LCUI_Graph *canvas, LCUI_Region region )
+{
+	int i;
+	for( i = 0; i < region->length; ++i ) {
+		Graph_FillRect( canvas, RGB( 255, 255, 255 ),
+				&region->rects[i], FALSE );
+	}
+}
+
+/** 用 Widget_RenderRegion() 一次性渲染区域中的所有矩形 */
+static void RenderRegion( LCUI_Widget root, LCUI_Graph *canvas,
+			  LCUI_Region region )
+{
+	LCUI_PaintContextRec paint;
+	ClearRegion( canvas, region );
+	paint.with_alpha = FALSE;
+	paint.arena = NULL;
+	paint.region = region;
+	paint.rect.x = paint.rect.y = 0;
+	paint.rect.width = TREE_WIDTH;
+	paint.rect.height = TREE_HEIGHT;
+	Graph_Quote( &paint.canvas, canvas, &paint.rect );
+	Widget_RenderRegion( root, &paint, region );
+}
+
+/** 对区域中的每个矩形分别调用 Widget_Render() 进行渲染，作为对照 */
+static void RenderRects( LCUI_Widget root, LCUI_Graph *canvas,
+			 LCUI_Region region )
+{
+	int i;
+	LCUI_PaintContextRec paint;
+	ClearRegion( canvas, region );
+	paint.with_alpha = FALSE;
+	paint.arena = NULL;
+	paint.region = NULL;
+	for( i = 0; i < region->length; ++i ) {
+		paint.rect = region->rects[i];
+		Graph_Quote( &paint.canvas, canvas, &paint.rect );
+		Widget_Render( root, &paint );
+	}
+}
+
+/** 两种方式重绘区域后，结果都应该与渲染整个部件树的结果相同 */
+static LCUI_BOOL CheckRegionRender( LCUI_Widget root, LCUI_Graph *full,
+				    LCUI_Region region )
+{
+	LCUI_BOOL ret;
+	LCUI_Graph canvas;
+	Graph_Init( &canvas );
+	Graph_Copy( &canvas, full );
+	RenderRegion( root, &canvas, region );
+	ret = IsSameCanvas( &canvas, full );
+	Graph_Copy( &canvas, full );
+	RenderRects( root, &canvas, region );
+	ret = ret && IsSameCanvas( &canvas, full );
+	Graph_Free( &canvas );
+	return ret;
+}
+
+/** 被不透明的兄弟部件遮挡的区域不会被绘制，但不能影响渲染结果 */
+static int test_widget_occlusion_render( void )
+{
+	LCUI_Graph full;
+	LCUI_RegionRec region;
+	LCUI_Widget root, top;
+	LCUI_Rect rect = { 0, 0, TREE_WIDTH, TREE_HEIGHT };
+
+	Graph_Init( &full );
+	full.color_type = COLOR_TYPE_ARGB;
+	Graph_Create( &full, TREE_WIDTH, TREE_HEIGHT );
+	Region_Init( &region );
+	Region_UnionRect( &region, &rect );
+	/* 不透明的部件层层堆叠，每个像素都是最上层部件的颜色 */
+	root = CreateStackedTree( &top, RGB( 255, 200, 0 ) );
+	RenderAll( root, &full );
+	assert( GetPixel( &full, 10, 10 ).value == RGB( 255, 0, 0 ).value );
+	assert( GetPixel( &full, 30, 20 ).value == RGB( 0, 160, 0 ).value );
+	assert( GetPixel( &full, 50, 30 ).value == RGB( 0, 0, 255 ).value );
+	assert( GetPixel( &full, 70, 45 ).value == RGB( 255, 200, 0 ).value );
+	assert( GetPixel( &full, 5, 5 ).value == RGB( 0, 0, 0 ).value );
+	assert( CheckRegionRender( root, &full, &region ) );
+	/* 最上层的部件是半透明的，下层的部件仍然可见 */
+	Widget_SetStyle( top, key_background_color,
+			 ARGB( 128, 255, 200, 0 ), color );
+	Widget_UpdateStyle( top, FALSE );
+	Widget_Update( root );
+	RenderAll( root, &full );
+	assert( GetPixel( &full, 70, 45 ).value !=
+		GetPixel( &full, 100, 70 ).value );
+	assert( GetPixel( &full, 70, 45 ).value !=
+		RGB( 255, 200, 0 ).value );
+	assert( CheckRegionRender( root, &full, &region ) );
+	Widget_Destroy( root );
+	Region_Destroy( &region );
+	Graph_Free( &full );
+	return 0;
+}
+
+/** 分散的脏矩形一次性渲染时，部件树只遍历一次，结果应该与逐个渲染相同 */
+static int test_widget_region_render( void )
+{
+	int i;
+	LCUI_Graph full;
+	LCUI_RegionRec region;
+	LCUI_Widget root, top;
+	LCUI_Rect rects[] = {
+		{ 0, 0, 30, 7 }, { 20, 12, 14, 9 }, { 48, 28, 30, 5 },
+		{ 58, 38, 4, 30 }, { 90, 70, 25, 15 }, { 3, 60, 50, 3 },
+		{ 70, 5, 40, 8 }, { 24, 40, 3, 3 }, { 100, 40, 20, 2 }
+	};
+
+	Graph_Init( &full );
+	full.color_type = COLOR_TYPE_ARGB;
+	Graph_Create( &full, TREE_WIDTH, TREE_HEIGHT );
+	Region_Init( &region );
+	for( i = 0; i < sizeof( rects ) / sizeof( LCUI_Rect ); ++i ) {
+		Region_UnionRect( &region, &rects[i] );
+	}
+	assert( region.length > 1 );
+	root = CreateStackedTree( &top, RGB( 255, 200, 0 ) );
+	RenderAll( root, &full );
+	assert( CheckRegionRender( root, &full, &region ) );
+	Widget_SetStyle( top, key_background_color,
+			 ARGB( 128, 255, 200, 0 ), color );
+	Widget_UpdateStyle( top, FALSE );
+	Widget_Update( root );
+	RenderAll( root, &full );
+	assert( CheckRegionRender( root, &full, &region ) );
+	/* 半透明的父部件需要按图层合成，会退回到逐个区域渲染 */
+	Widget_SetStyle( root, key_opacity, 0.5f, scale );
+	Widget_UpdateStyle( root, FALSE );
+	Widget_Update( root );
+	RenderAll( root, &full );
+	assert( CheckRegionRender( root, &full, &region ) );
+	Widget_Destroy( root );
+	Region_Destroy( &region );
+	Graph_Free( &full );
+	return 0;
+}
 
 int test_widget_render( void )
 {
@@ -15,8 +346,12 @@ int test_widget_render( void )
 	LCUI_Color bgcolor = RGB( 242, 249, 252 );
 	LCUI_Color bdcolor = RGB( 201, 230, 242 );
 
-	LCUI_Init();
-
+	ret = test_widget_layer_render();
+	ret |= test_widget_occlusion_render();
+	ret |= test_widget_region_render();
+	if( ret != 0 ) {
+		return ret;
+	}
 	root = LCUIWidget_New( NULL );
 	box = LCUIWidget_New( NULL );
 	txt = LCUIWidget_New( "textview" );
@@ -28,6 +363,8 @@ int test_widget_render( void )
 
 	/* 初始化一个绘制实例，绘制区域为整个画板 */
 	paint.with_alpha = FALSE;
+	paint.arena = NULL;
+	paint.region = NULL;
 	paint.rect.width = 320;
 	paint.rect.height = 320;
 	paint.rect.x = paint.rect.y = 0;
@@ -53,7 +390,6 @@ int test_widget_render( void )
 	Widget_Render( box, &paint );
 	ret = LCUI_WritePNGFile( "test_widget_render.png", &canvas );
 	Graph_Free( &canvas );
-
-	LCUI_Destroy();
+	Widget_Destroy( root );
 	return ret;
 }
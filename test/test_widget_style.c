@@ -0,0 +1,212 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include <LCUI/gui/widget.h>
+#include <LCUI/gui/css_library.h>
+#include <LCUI/gui/css_parser.h>
+#include "test.h"
+
+#define N_ROWS 5
+#define N_SIBLINGS 8
+
+static const char *test_css = CodeToString(
+
+.status-test .item {
+	width: 10px;
+}
+
+.status-test:hover .item.mark {
+	width: 20px;
+}
+
+.status-test .item:focus {
+	width: 30px;
+}
+
+.status-test:hover .missing {
+	height: 5px;
+}
+
+.share-test .row {
+	height: 20px;
+}
+
+.share-test .row.selected {
+	height: 30px;
+}
+
+);
+
+/** 获取部件计算后的样式中的像素值，未设置时返回 -1 */
+static float GetStylePx( LCUI_Widget w, int key )
+{
+	LCUI_Style s = &w->style->sheet[key];
+	return s->is_valid && s->type == SVT_PX ? s->val_px : -1;
+}
+
+/** 统计部件树中有样式刷新任务的部件数量 */
+static int CountRefreshTasks( LCUI_Widget w )
+{
+	LinkedListNode *node;
+	int count = w->task.buffer[WTT_REFRESH_STYLE] ? 1 : 0;
+	for( LinkedList_Each( node, &w->children ) ) {
+		count += CountRefreshTasks( node->data );
+	}
+	return count;
+}
+
+/** 状态变化时，只有可能受影响的部件才需要重新计算样式 */
+static int test_widget_status_style( void )
+{
+	int i;
+	LCUI_Widget root, box, items[N_ROWS], marks[N_ROWS];
+
+	root = LCUIWidget_GetRoot();
+	box = LCUIWidget_New( NULL );
+	Widget_AddClass( box, "status-test" );
+	for( i = 0; i < N_ROWS; ++i ) {
+		LCUI_Widget row = LCUIWidget_New( NULL );
+		LCUI_Widget text = LCUIWidget_New( NULL );
+		items[i] = LCUIWidget_New( NULL );
+		marks[i] = LCUIWidget_New( NULL );
+		Widget_AddClass( items[i], "item" );
+		Widget_AddClass( marks[i], "item mark" );
+		Widget_AddClass( text, "text" );
+		Widget_Append( row, items[i] );
+		Widget_Append( row, marks[i] );
+		Widget_Append( row, text );
+		Widget_Append( box, row );
+	}
+	Widget_Append( root, box );
+	Widget_Update( root );
+	assert( CountRefreshTasks( root ) == 0 );
+	assert( GetStylePx( marks[0], key_width ) == 10 );
+
+	/* 状态出现在祖先结点中，只有匹配规则最后一个结点的后代需要刷新 */
+	Widget_AddStatus( box, "hover" );
+	assert( CountRefreshTasks( root ) == N_ROWS );
+	for( i = 0; i < N_ROWS; ++i ) {
+		assert( marks[i]->task.buffer[WTT_REFRESH_STYLE] );
+	}
+	Widget_Update( root );
+	for( i = 0; i < N_ROWS; ++i ) {
+		assert( GetStylePx( marks[i], key_width ) == 20 );
+		assert( GetStylePx( items[i], key_width ) == 10 );
+	}
+	/* 状态出现在规则的最后一个结点中，只有部件自身需要刷新 */
+	Widget_AddStatus( items[1], "focus" );
+	assert( CountRefreshTasks( root ) == 1 );
+	assert( items[1]->task.buffer[WTT_REFRESH_STYLE] );
+	Widget_Update( root );
+	assert( GetStylePx( items[1], key_width ) == 30 );
+	assert( GetStylePx( items[2], key_width ) == 10 );
+	/* 没有规则依赖的状态不会引起任何刷新 */
+	Widget_AddStatus( marks[3], "active" );
+	assert( CountRefreshTasks( root ) == 0 );
+	Widget_RemoveStatus( box, "hover" );
+	assert( CountRefreshTasks( root ) == N_ROWS );
+	Widget_Update( root );
+	for( i = 0; i < N_ROWS; ++i ) {
+		assert( GetStylePx( marks[i], key_width ) == 10 );
+	}
+	assert( GetStylePx( items[1], key_width ) == 30 );
+	Widget_Destroy( box );
+	Widget_Update( root );
+	return 0;
+}
+
+/** 检查兄弟部件之间是否共享继承样式表 */
+static LCUI_BOOL IsSharedStyle( LCUI_Widget a, LCUI_Widget b )
+{
+	return a->inherited_style == b->inherited_style;
+}
+
+/**
+ * 兄弟部件共享继承样式表，样式变化时须先复制一份再修改
+ * 首尾两个部件有 first-child 和 last-child 状态，所以只检查中间的部件
+ */
+static int test_widget_shared_style( void )
+{
+	int i;
+	LCUI_Widget root, list, rows[N_SIBLINGS];
+
+	root = LCUIWidget_GetRoot();
+	list = LCUIWidget_New( NULL );
+	Widget_AddClass( list, "share-test" );
+	for( i = 0; i < N_SIBLINGS; ++i ) {
+		rows[i] = LCUIWidget_New( NULL );
+		Widget_AddClass( rows[i], "row" );
+		Widget_Append( list, rows[i] );
+	}
+	Widget_Append( root, list );
+	Widget_Update( root );
+	for( i = 0; i < N_SIBLINGS; ++i ) {
+		assert( GetStylePx( rows[i], key_height ) == 20 );
+	}
+	for( i = 2; i < N_SIBLINGS - 1; ++i ) {
+		assert( IsSharedStyle( rows[1], rows[i] ) );
+	}
+	assert( !IsSharedStyle( rows[0], rows[1] ) );
+	/* 类名变化后，部件使用自己的样式表，不影响其它兄弟部件 */
+	Widget_AddClass( rows[3], "selected" );
+	Widget_Update( root );
+	assert( !IsSharedStyle( rows[1], rows[3] ) );
+	assert( IsSharedStyle( rows[1], rows[4] ) );
+	assert( GetStylePx( rows[3], key_height ) == 30 );
+	assert( GetStylePx( rows[2], key_height ) == 20 );
+	assert( GetStylePx( rows[4], key_height ) == 20 );
+	/* 类名相同的部件仍然可以共享样式表 */
+	Widget_AddClass( rows[4], "selected" );
+	Widget_Update( root );
+	assert( IsSharedStyle( rows[3], rows[4] ) );
+	assert( GetStylePx( rows[4], key_height ) == 30 );
+	assert( GetStylePx( rows[5], key_height ) == 20 );
+	Widget_RemoveClass( rows[4], "selected" );
+	Widget_Update( root );
+	assert( IsSharedStyle( rows[1], rows[4] ) );
+	assert( GetStylePx( rows[4], key_height ) == 20 );
+	assert( GetStylePx( rows[3], key_height ) == 30 );
+	/* 内联样式只作用于部件自身，共享的样式表不受影响 */
+	Widget_SetStyle( rows[5], key_height, 50, px );
+	Widget_UpdateStyle( rows[5], TRUE );
+	Widget_Update( root );
+	assert( GetStylePx( rows[5], key_height ) == 50 );
+	assert( GetStylePx( rows[6], key_height ) == 20 );
+	assert( rows[1]->inherited_style->sheet[key_height].val_px == 20 );
+	/* 样式库更新后，基于旧版本计算的样式表不能再被共享 */
+	LCUI_LoadCSSString( ".share-test .row { height: 25px; }", NULL );
+	Widget_UpdateStyle( rows[2], TRUE );
+	Widget_Update( root );
+	assert( !IsSharedStyle( rows[1], rows[2] ) );
+	assert( GetStylePx( rows[2], key_height ) == 25 );
+	assert( GetStylePx( rows[1], key_height ) == 20 );
+	assert( GetStylePx( rows[4], key_height ) == 20 );
+	/* 基于新版本计算的样式表可以继续共享 */
+	Widget_UpdateStyle( rows[4], TRUE );
+	Widget_Update( root );
+	assert( IsSharedStyle( rows[2], rows[4] ) );
+	assert( GetStylePx( rows[4], key_height ) == 25 );
+	for( i = 0; i < N_SIBLINGS; ++i ) {
+		Widget_UpdateStyle( rows[i], TRUE );
+	}
+	Widget_Update( root );
+	assert( GetStylePx( rows[0], key_height ) == 25 );
+	assert( GetStylePx( rows[3], key_height ) == 30 );
+	assert( GetStylePx( rows[5], key_height ) == 50 );
+	assert( GetStylePx( rows[7], key_height ) == 25 );
+	assert( IsSharedStyle( rows[1], rows[6] ) );
+	Widget_Destroy( rows[2] );
+	Widget_Destroy( list );
+	Widget_Update( root );
+	return 0;
+}
+
+int test_widget_style( void )
+{
+	int ret = 0;
+	LCUI_LoadCSSString( test_css, NULL );
+	ret |= test_widget_status_style();
+	ret |= test_widget_shared_style();
+	return ret;
+}
@@ -0,0 +1,108 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <LCUI_Build.h>
+#include <LCUI/LCUI.h>
+#include "test.h"
+
+#if defined(LCUI_BUILD_IN_LINUX) && defined(LCUI_VIDEO_DRIVER_X11)
+#include <LCUI/display.h>
+#include <LCUI/platform.h>
+#include LCUI_DISPLAY_H
+#include LCUI_EVENTS_H
+
+#define SURFACE_WIDTH	320
+#define SURFACE_HEIGHT	240
+
+/** 读取窗口中的像素，转换为 24 位的 RGB 值 */
+static unsigned int ReadPixel( Display *dpy, Window win, int x, int y )
+{
+	XImage *img;
+	unsigned int v;
+	XSync( dpy, False );
+	img = XGetImage( dpy, win, x, y, 1, 1, AllPlanes, ZPixmap );
+	if( !img ) {
+		return 0xffffffff;
+	}
+	v = XGetPixel( img, 0, 0 ) & 0xffffff;
+	XDestroyImage( img );
+	return v;
+}
+
+static void FillRect( LCUI_DisplayDriver driver, LCUI_Surface surface,
+		      LCUI_Rect rect, LCUI_Color color )
+{
+	LCUI_PaintContext paint;
+	paint = driver->beginPaint( surface, &rect );
+	Graph_FillRect( &paint->canvas, color, NULL, FALSE );
+	driver->endPaint( surface, paint );
+}
+
+static int test_x11display_mode( LCUI_BOOL use_shm )
+{
+	Window win;
+	LCUI_Surface surface;
+	LCUI_DisplayDriver driver;
+	LCUI_X11AppDriver x11 = LCUI_GetAppData();
+
+	driver = LCUI_OpenLinuxX11DisplayDriver( use_shm );
+	assert( driver != NULL );
+	surface = driver->create();
+	driver->resize( surface, SURFACE_WIDTH, SURFACE_HEIGHT );
+	driver->show( surface );
+	/* 窗口的创建、尺寸调整和映射都由主线程在处理任务时完成 */
+	LCUI_ProcessEvents();
+	win = (Window)driver->getHandle( surface );
+	assert( win != 0 );
+	XSync( x11->display, False );
+	LCUI_ProcessEvents();
+	FillRect( driver, surface, Rect( 0, 0, 320, 240 ),
+		  RGB( 255, 255, 255 ) );
+	FillRect( driver, surface, Rect( 4, 4, 8, 8 ), RGB( 255, 0, 0 ) );
+	driver->present( surface );
+	LCUI_ProcessEvents();
+	assert( ReadPixel( x11->display, win, 8, 8 ) == 0xff0000 );
+	assert( ReadPixel( x11->display, win, 12, 12 ) == 0xffffff );
+	/* 呈现后立即修改帧缓存，使用共享内存时，驱动须在修改前等待 X 服务器
+	 * 读完上次提交的内容，否则窗口中可能会出现新的像素 */
+	FillRect( driver, surface, Rect( 0, 0, 2, 2 ), RGB( 0, 0, 255 ) );
+	driver->present( surface );
+	LCUI_ProcessEvents();
+	FillRect( driver, surface, Rect( 4, 4, 8, 8 ), RGB( 0, 255, 0 ) );
+	assert( ReadPixel( x11->display, win, 0, 0 ) == 0x0000ff );
+	assert( ReadPixel( x11->display, win, 8, 8 ) == 0xff0000 );
+	driver->present( surface );
+	LCUI_ProcessEvents();
+	assert( ReadPixel( x11->display, win, 8, 8 ) == 0x00ff00 );
+	assert( ReadPixel( x11->display, win, 1, 1 ) == 0x0000ff );
+	driver->destroy( surface );
+	LCUI_ProcessEvents();
+	LCUI_DestroyLinuxX11DisplayDriver( driver );
+	return 0;
+}
+
+/**
+ * 分别以共享内存和 XPutImage() 两种方式呈现，需要有可用的 X 服务器，例如：
+ * xvfb-run ./test
+ */
+int test_x11display( void )
+{
+	int ret = 0;
+	Display *dpy = XOpenDisplay( NULL );
+	if( !dpy ) {
+		return 0;
+	}
+	XCloseDisplay( dpy );
+	ret |= test_x11display_mode( TRUE );
+	ret |= test_x11display_mode( FALSE );
+	_DEBUG_MSG( "test x11display: %d\n", ret );
+	return ret;
+}
+
+#else
+
+int test_x11display( void )
+{
+	return 0;
+}
+
+#endif